@@ -355,58 +355,58 @@ static scpi_result_t My_CoreTstQ(scpi_t * context) {
 
 const scpi_command_t scpi_commands[] = {
     /* IEEE Mandated Commands (SCPI std V1999.0 4.1.1) */
-    {"*CLS", SCPI_CoreCls, 0},
-    {"*ESE", SCPI_CoreEse, 0},
-    {"*ESE?", SCPI_CoreEseQ, 0},
-    {"*ESR?", SCPI_CoreEsrQ, 0},
-    {"*IDN?", SCPI_CoreIdnQ, 0},
-    {"*OPC", SCPI_CoreOpc, 0},
-    {"*OPC?", SCPI_CoreOpcQ, 0},
-    {"*RST", SCPI_CoreRst, 0},
-    {"*SRE", SCPI_CoreSre, 0},
-    {"*SRE?", SCPI_CoreSreQ, 0},
-    {"*STB?", SCPI_CoreStbQ, 0},
-    {"*TST?", My_CoreTstQ, 0},
-    {"*WAI", SCPI_CoreWai, 0},
+    SCPI_CMD("*CLS", SCPI_CoreCls, 0),
+    SCPI_CMD("*ESE", SCPI_CoreEse, 0),
+    SCPI_CMD("*ESE?", SCPI_CoreEseQ, 0),
+    SCPI_CMD("*ESR?", SCPI_CoreEsrQ, 0),
+    SCPI_CMD("*IDN?", SCPI_CoreIdnQ, 0),
+    SCPI_CMD("*OPC", SCPI_CoreOpc, 0),
+    SCPI_CMD("*OPC?", SCPI_CoreOpcQ, 0),
+    SCPI_CMD("*RST", SCPI_CoreRst, 0),
+    SCPI_CMD("*SRE", SCPI_CoreSre, 0),
+    SCPI_CMD("*SRE?", SCPI_CoreSreQ, 0),
+    SCPI_CMD("*STB?", SCPI_CoreStbQ, 0),
+    SCPI_CMD("*TST?", My_CoreTstQ, 0),
+    SCPI_CMD("*WAI", SCPI_CoreWai, 0),
 
     /* Required SCPI commands (SCPI std V1999.0 4.2.1) */
-    {"SYSTem:ERRor[:NEXT]?", SCPI_SystemErrorNextQ, 0},
-    {"SYSTem:ERRor:COUNt?", SCPI_SystemErrorCountQ, 0},
-    {"SYSTem:VERSion?", SCPI_SystemVersionQ, 0},
+    SCPI_CMD("SYSTem:ERRor[:NEXT]?", SCPI_SystemErrorNextQ, 0),
+    SCPI_CMD("SYSTem:ERRor:COUNt?", SCPI_SystemErrorCountQ, 0),
+    SCPI_CMD("SYSTem:VERSion?", SCPI_SystemVersionQ, 0),
 
-    //{"STATus:OPERation?", scpi_stub_callback, 0},
-    //{"STATus:OPERation:EVENt?", scpi_stub_callback, 0},
-    //{"STATus:OPERation:CONDition?", scpi_stub_callback, 0},
-    //{"STATus:OPERation:ENABle", scpi_stub_callback, 0},
-    //{"STATus:OPERation:ENABle?", scpi_stub_callback, 0},
+    //SCPI_CMD("STATus:OPERation?", scpi_stub_callback, 0),
+    //SCPI_CMD("STATus:OPERation:EVENt?", scpi_stub_callback, 0),
+    //SCPI_CMD("STATus:OPERation:CONDition?", scpi_stub_callback, 0),
+    //SCPI_CMD("STATus:OPERation:ENABle", scpi_stub_callback, 0),
+    //SCPI_CMD("STATus:OPERation:ENABle?", scpi_stub_callback, 0),
 
-    {"STATus:QUEStionable[:EVENt]?", SCPI_StatusQuestionableEventQ, 0},
-    //{"STATus:QUEStionable:CONDition?", scpi_stub_callback, 0},
-    {"STATus:QUEStionable:ENABle", SCPI_StatusQuestionableEnable, 0},
-    {"STATus:QUEStionable:ENABle?", SCPI_StatusQuestionableEnableQ, 0},
+    SCPI_CMD("STATus:QUEStionable[:EVENt]?", SCPI_StatusQuestionableEventQ, 0),
+    //SCPI_CMD("STATus:QUEStionable:CONDition?", scpi_stub_callback, 0),
+    SCPI_CMD("STATus:QUEStionable:ENABle", SCPI_StatusQuestionableEnable, 0),
+    SCPI_CMD("STATus:QUEStionable:ENABle?", SCPI_StatusQuestionableEnableQ, 0),
 
-    {"STATus:PRESet", SCPI_StatusPreset, 0},
+    SCPI_CMD("STATus:PRESet", SCPI_StatusPreset, 0),
 
     /* DMM */
-    {"MEASure:VOLTage:DC?", DMM_MeasureVoltageDcQ, 0},
-    {"CONFigure:VOLTage:DC", DMM_ConfigureVoltageDc, 0},
-    {"MEASure:VOLTage:DC:RATio?", SCPI_StubQ, 0},
-    {"MEASure:VOLTage:AC?", DMM_MeasureVoltageAcQ, 0},
-    {"MEASure:CURRent:DC?", SCPI_StubQ, 0},
-    {"MEASure:CURRent:AC?", SCPI_StubQ, 0},
-    {"MEASure:RESistance?", SCPI_StubQ, 0},
-    {"MEASure:FRESistance?", SCPI_StubQ, 0},
-    {"MEASure:FREQuency?", SCPI_StubQ, 0},
-    {"MEASure:PERiod?", SCPI_StubQ, 0},
-
-    {"SYSTem:COMMunication:TCPIP:CONTROL?", SCPI_SystemCommTcpipControlQ, 0},
-
-    {"TEST:BOOL", TEST_Bool, 0},
-    {"TEST:CHOice?", TEST_ChoiceQ, 0},
-    {"TEST#:NUMbers#", TEST_Numbers, 0},
-    {"TEST:TEXT", TEST_Text, 0},
-    {"TEST:ARBitrary?", TEST_ArbQ, 0},
-    {"TEST:CHANnellist", TEST_Chanlst, 0},
+    SCPI_CMD("MEASure:VOLTage:DC?", DMM_MeasureVoltageDcQ, 0),
+    SCPI_CMD("CONFigure:VOLTage:DC", DMM_ConfigureVoltageDc, 0),
+    SCPI_CMD("MEASure:VOLTage:DC:RATio?", SCPI_StubQ, 0),
+    SCPI_CMD("MEASure:VOLTage:AC?", DMM_MeasureVoltageAcQ, 0),
+    SCPI_CMD("MEASure:CURRent:DC?", SCPI_StubQ, 0),
+    SCPI_CMD("MEASure:CURRent:AC?", SCPI_StubQ, 0),
+    SCPI_CMD("MEASure:RESistance?", SCPI_StubQ, 0),
+    SCPI_CMD("MEASure:FRESistance?", SCPI_StubQ, 0),
+    SCPI_CMD("MEASure:FREQuency?", SCPI_StubQ, 0),
+    SCPI_CMD("MEASure:PERiod?", SCPI_StubQ, 0),
+
+    SCPI_CMD("SYSTem:COMMunication:TCPIP:CONTROL?", SCPI_SystemCommTcpipControlQ, 0),
+
+    SCPI_CMD("TEST:BOOL", TEST_Bool, 0),
+    SCPI_CMD("TEST:CHOice?", TEST_ChoiceQ, 0),
+    SCPI_CMD("TEST#:NUMbers#", TEST_Numbers, 0),
+    SCPI_CMD("TEST:TEXT", TEST_Text, 0),
+    SCPI_CMD("TEST:ARBitrary?", TEST_ArbQ, 0),
+    SCPI_CMD("TEST:CHANnellist", TEST_Chanlst, 0),
 
     SCPI_CMD_LIST_END
 };
@@ -417,6 +417,10 @@ scpi_interface_t scpi_interface = {
     /*.control = */ SCPI_Control,
     /*.flush = */ SCPI_Flush,
     /*.reset = */ SCPI_Reset,
+    /*.error_text = */ NULL,
+#if USE_EVENT_LOG
+    /*.timestamp = */ NULL,
+#endif
 };
 
 char scpi_input_buffer[SCPI_INPUT_BUFFER_LENGTH];
@@ -372,6 +372,9 @@ const scpi_command_t scpi_commands[] = {
     /* Required SCPI commands (SCPI std V1999.0 4.2.1) */
     {.pattern = "SYSTem:ERRor[:NEXT]?", .callback = SCPI_SystemErrorNextQ,},
     {.pattern = "SYSTem:ERRor:COUNt?", .callback = SCPI_SystemErrorCountQ,},
+#if USE_EVENT_LOG
+    {.pattern = "SYSTem:ERRor:LOG?", .callback = SCPI_SystemErrorLogQ,},
+#endif
     {.pattern = "SYSTem:VERSion?", .callback = SCPI_SystemVersionQ,},
 
     /* {.pattern = "STATus:OPERation?", .callback = scpi_stub_callback,}, */
@@ -387,6 +390,11 @@ const scpi_command_t scpi_commands[] = {
 
     {.pattern = "STATus:PRESet", .callback = SCPI_StatusPreset,},
 
+    {.pattern = "FORMat[:DATA]", .callback = SCPI_FormatData,},
+    {.pattern = "FORMat[:DATA]?", .callback = SCPI_FormatDataQ,},
+    {.pattern = "FORMat:BORDer", .callback = SCPI_FormatBorder,},
+    {.pattern = "FORMat:BORDer?", .callback = SCPI_FormatBorderQ,},
+
     /* DMM */
     {.pattern = "MEASure:VOLTage:DC?", .callback = DMM_MeasureVoltageDcQ,},
     {.pattern = "CONFigure:VOLTage:DC", .callback = DMM_ConfigureVoltageDc,},
@@ -61,6 +61,19 @@ extern "C" {
 #define USE_CUSTOM_REGISTERS 0
 #endif
 
+/**
+ * Status register updates
+ * 0 = Plain read-modify-write, SCPI_RegSet must be serialized by the caller
+ * 1 = Atomic compare and swap of each register, SCPI_RegSet, SCPI_RegSetBits
+ *     and SCPI_RegClearBits may be called from more threads or interrupts.
+ *     Summary bits are recomputed until consistent and SCPI_CTRL_SRQ is sent
+ *     once for each rising edge of the service request bit.
+ *     Needs GCC compatible __atomic builtins.
+ */
+#ifndef USE_REGISTER_ATOMIC
+#define USE_REGISTER_ATOMIC 0
+#endif
+
 /**
  * Detect, if it has limited resources, or it is running on a full-blown operating system.
  * All values can be overridden by scpi_user_config.h
@@ -96,6 +109,16 @@ extern "C" {
 #define USE_USER_ERROR_LIST 0
 #endif
 
+/**
+ * Translation of error numbers in SCPI_ErrorTranslate
+ * 0 = Switch over LIST_OF_ERRORS and LIST_OF_USER_ERRORS
+ * 1 = Binary search of sorted table of error numbers and offsets to one
+ *     blob of strings, LIST_OF_USER_ERRORS is translated by switch
+ */
+#ifndef USE_ERROR_TABLE
+#define USE_ERROR_TABLE 1
+#endif
+
 #ifndef USE_DEVICE_DEPENDENT_ERROR_INFORMATION
 #define USE_DEVICE_DEPENDENT_ERROR_INFORMATION SYSTEM_TYPE
 #endif
@@ -110,18 +133,133 @@ extern "C" {
 #endif
 #endif
 
+/**
+ * Storage of device dependent error information without malloc/free
+ * 0 = Circular heap, strings can be split at the end of the heap
+ * 1 = Slab with one fixed size slot per entry of error queue, longer
+ *     information is truncated to the slot size
+ */
+#ifndef USE_ERROR_INFO_SLAB
+#define USE_ERROR_INFO_SLAB 0
+#endif
+
+/**
+ * Error queue implementation
+ * 0 = Plain ring buffer, SCPI_ErrorPush must be serialized by the caller
+ * 1 = Lock-free multi producer single consumer queue, SCPI_ErrorPush may be
+ *     called from more threads or interrupts, SCPI_ErrorPop only from one.
+ *     Needs GCC compatible __atomic builtins. Size of the queue is rounded
+ *     down to power of two and must be at least 2.
+ */
+#ifndef USE_ERROR_QUEUE_LOCKFREE
+#define USE_ERROR_QUEUE_LOCKFREE 0
+#endif
+
+#if USE_ERROR_QUEUE_LOCKFREE && USE_DEVICE_DEPENDENT_ERROR_INFORMATION && !USE_MEMORY_ALLOCATION_FREE
+#error "USE_ERROR_QUEUE_LOCKFREE needs thread safe allocation of error information (USE_MEMORY_ALLOCATION_FREE)"
+#endif
+
+/**
+ * Event log of pushed errors, read by SCPI_EventLogRead and SYSTem:ERRor:LOG?
+ * 0 = No event log
+ * 1 = Bounded log with timestamp, command tag, error code and sequence
+ *     number of each pushed error, independent on the error queue. Writing
+ *     is lock-free, needs GCC compatible __atomic builtins. Memory for the
+ *     log is given by SCPI_EventLogInit.
+ */
+#ifndef USE_EVENT_LOG
+#define USE_EVENT_LOG 0
+#endif
+
 #ifndef USE_COMMAND_TAGS
 #define USE_COMMAND_TAGS 1
 #endif
 
+/**
+ * Exact value of numbers read by SCPI_ParamNumber
+ * 0 = Only double value in scpi_number_t
+ * 1 = Also integer mantissa and power of ten exponent in scpi_number_t,
+ *     read by SCPI_NumberToInt64 and SCPI_NumberToUInt64 without rounding
+ */
+#ifndef USE_NUMBER_EXACT
+#define USE_NUMBER_EXACT 1
+#endif
+
+/**
+ * Parameter schema of commands
+ * 0 = Command callbacks read their parameters by SCPI_Param* functions
+ * 1 = Optional scpi_command_t.schema, parameters are converted and
+ *     checked before the callback and read by SCPI_Argument
+ */
+#ifndef USE_PARAMETER_SCHEMA
+#define USE_PARAMETER_SCHEMA SYSTEM_TYPE
+#endif
+
+/* maximal number of parameters described by schema */
+#ifndef SCPI_SCHEMA_MAX_PARAMETERS
+#define SCPI_SCHEMA_MAX_PARAMETERS 8
+#endif
+
 #ifndef USE_DEPRECATED_FUNCTIONS
 #define USE_DEPRECATED_FUNCTIONS 1
 #endif
 
+/**
+ * Queue output data, which the interface did not accept
+ * 0 = Data not accepted by write callback are lost
+ * 1 = Data not accepted by write callback are queued in buffer given by
+ *     SCPI_InitOutputQueue and sent by SCPI_OutputPump
+ */
+#ifndef USE_OUTPUT_QUEUE
+#define USE_OUTPUT_QUEUE 1
+#endif
+
+/**
+ * Vendor specific FORMat:DATA PACKed,16|32 with zig-zag varint differences
+ * 0 = Only ASCii, REAL and INTeger formats
+ * 1 = PACKed format available for SCPI_ResultArrayAuto*
+ */
+#ifndef USE_PACKED_DATA_FORMAT
+#define USE_PACKED_DATA_FORMAT 1
+#endif
+
 #ifndef USE_CUSTOM_DTOSTRE
 #define USE_CUSTOM_DTOSTRE 0
 #endif
 
+/**
+ * Floating point to string conversion
+ * 0 = Use dtostre, snprintf or SCPI_dtostre, depending on platform
+ * 1 = Use built-in conversion, which does not depend on libc
+ */
+#ifndef USE_BUILTIN_DTOSTR
+#define USE_BUILTIN_DTOSTR (!USE_CUSTOM_DTOSTRE)
+#endif
+
+/**
+ * String to floating point conversion
+ * 0 = Use strtod and strtof from libc
+ * 1 = Use built-in conversion, which does not depend on libc and locale
+ */
+#ifndef USE_BUILTIN_STRTOD
+#define USE_BUILTIN_STRTOD 1
+#endif
+
+/**
+ * Number of significant digits of float and double results
+ * 0 = Shortest representation, which reads back to the same value
+ * N = N significant digits, correctly rounded, at most 24
+ *
+ * Used only with USE_BUILTIN_DTOSTR
+ */
+#ifndef SCPI_FLOAT_PRECISION
+#define SCPI_FLOAT_PRECISION 0
+#endif
+
+#ifndef SCPI_DOUBLE_PRECISION
+#define SCPI_DOUBLE_PRECISION 0
+#endif
+
 #ifndef USE_UNITS_IMPERIAL
 #define USE_UNITS_IMPERIAL 0
 #endif
@@ -178,6 +316,97 @@ extern "C" {
 #define USE_UNITS_ELECTRIC_CHARGE_CONDUCTANCE SYSTEM_TYPE
 #endif
 
+/**
+ * Unit suffix lookup
+ * 0 = Linear search of units table
+ * 1 = Hash index of units table in the context, built by SCPI_Init and
+ *     rebuilt on lookup if context->units was replaced
+ */
+#ifndef USE_UNITS_HASH
+#define USE_UNITS_HASH 1
+#endif
+
+/* number of slots of units hash index, power of two */
+#ifndef SCPI_UNITS_HASH_SIZE
+#define SCPI_UNITS_HASH_SIZE 128
+#endif
+
+/**
+ * Choice lookup in SCPI_ParamToChoice and SCPI_ChoiceToNameEx
+ * 0 = Linear search of choice list
+ * 1 = Hash index of bigger choice lists in the context, built on first use.
+ *     Lists are identified by pointer only, so they must be static and const
+ */
+#ifndef USE_CHOICE_INDEX
+#define USE_CHOICE_INDEX SYSTEM_TYPE
+#endif
+
+/* number of choice lists indexed at once in the context */
+#ifndef SCPI_CHOICE_INDEX_COUNT
+#define SCPI_CHOICE_INDEX_COUNT 4
+#endif
+
+/* number of slots of choice hash index, power of two, lists up to 3/8 of it are indexed */
+#ifndef SCPI_CHOICE_HASH_SIZE
+#define SCPI_CHOICE_HASH_SIZE 256
+#endif
+
+/* shorter choice lists are searched linearly */
+#ifndef SCPI_CHOICE_INDEX_MIN
+#define SCPI_CHOICE_INDEX_MIN 8
+#endif
+
+/* maximal number of dimensions of channel compiled by SCPI_ExprChannelListCompile */
+#ifndef SCPI_CHANNEL_DIMENSIONS
+#define SCPI_CHANNEL_DIMENSIONS 4
+#endif
+
+/**
+ * Arithmetic program expressions e.g. (2*PI*1E3) in SCPI_ParamDouble,
+ * SCPI_ParamFloat and SCPI_ParamNumber
+ * 0 = Program expressions are only numeric and channel lists
+ * 1 = Expressions are compiled to bytecode, cached in the context and
+ *     evaluated by SCPI_ExprEvalDouble
+ */
+#ifndef USE_EXPRESSION_EVAL
+#define USE_EXPRESSION_EVAL SYSTEM_TYPE
+#endif
+
+/* maximal number of bytecode bytes of compiled expression */
+#ifndef SCPI_EXPR_CODE_LENGTH
+#define SCPI_EXPR_CODE_LENGTH 32
+#endif
+
+/* maximal depth of evaluation stack of compiled expression */
+#ifndef SCPI_EXPR_STACK_SIZE
+#define SCPI_EXPR_STACK_SIZE 8
+#endif
+
+/* number of compiled expressions cached in the context */
+#ifndef SCPI_EXPR_CACHE_COUNT
+#define SCPI_EXPR_CACHE_COUNT 4
+#endif
+
+/* longer expressions are compiled on each use */
+#ifndef SCPI_EXPR_CACHE_TEXT_LENGTH
+#define SCPI_EXPR_CACHE_TEXT_LENGTH 32
+#endif
+
+/**
+ * Callbacks for transitions of status register bits, see SCPI_RegSubscribe
+ * 0 = Only SCPI_CTRL_SRQ control message
+ * 1 = Up to SCPI_REG_SUBSCRIPTION_COUNT callbacks in the context, called
+ *     from SCPI_RegSet and related functions for each matching transition
+ */
+#ifndef USE_REGISTER_SUBSCRIPTIONS
+#define USE_REGISTER_SUBSCRIPTIONS SYSTEM_TYPE
+#endif
+
+/* number of register subscriptions in the context */
+#ifndef SCPI_REG_SUBSCRIPTION_COUNT
+#define SCPI_REG_SUBSCRIPTION_COUNT 8
+#endif
+
 /* define local macros depending on existence of strnlen */
 #if HAVE_STRNLEN
 #define SCPIDEFINE_strnlen(s, l)	strnlen((s), (l))
@@ -194,7 +423,9 @@ extern "C" {
 #define SCPIDEFINE_strncasecmp(s1, s2, l) OUR_strncasecmp((s1), (s2), (l))
 #endif
 
-#if HAVE_DTOSTRE
+#if USE_BUILTIN_DTOSTR
+#define SCPIDEFINE_floatToStr(v, s, l) SCPI_FloatToStrPrecision((v), (s), (l), SCPI_FLOAT_PRECISION)
+#elif HAVE_DTOSTRE
 #define SCPIDEFINE_floatToStr(v, s, l) dtostre((double)(v), (s), 6, DTOSTR_PLUS_SIGN | DTOSTR_ALWAYS_SIGN | DTOSTR_UPPERCASE)
 #elif USE_CUSTOM_DTOSTRE
 #define SCPIDEFINE_floatToStr(v, s, l) SCPI_dtostre((v), (s), (l), 6, 0)
@@ -204,7 +435,9 @@ extern "C" {
 #define SCPIDEFINE_floatToStr(v, s, l) SCPI_dtostre((v), (s), (l), 6, 0)
 #endif
 
-#if HAVE_DTOSTRE
+#if USE_BUILTIN_DTOSTR
+#define SCPIDEFINE_doubleToStr(v, s, l) SCPI_DoubleToStrPrecision((v), (s), (l), SCPI_DOUBLE_PRECISION)
+#elif HAVE_DTOSTRE
 #define SCPIDEFINE_doubleToStr(v, s, l) dtostre((v), (s), 15, DTOSTR_PLUS_SIGN | DTOSTR_ALWAYS_SIGN | DTOSTR_UPPERCASE)
 #elif USE_CUSTOM_DTOSTRE
 #define SCPIDEFINE_doubleToStr(v, s, l) SCPI_dtostre((v), (s), (l), 15, 0)
@@ -226,6 +459,10 @@ extern "C" {
       #define SCPIDEFINE_strndup(h, s, l)               OUR_strndup((s), (l))
     #endif
     #define SCPIDEFINE_free(h, s, r)                    free((s))
+  #elif USE_ERROR_INFO_SLAB
+    #define SCPIDEFINE_DESCRIPTION_MAX_PARTS            2
+    #define SCPIDEFINE_strndup(h, s, l)                 scpislab_strndup((h), (s), (l))
+    #define SCPIDEFINE_free(h, s, r)                    scpislab_free((h), (s))
   #else
     #define SCPIDEFINE_DESCRIPTION_MAX_PARTS            3
     #define SCPIDEFINE_strndup(h, s, l)                 scpiheap_strndup((h), (s), (l))
@@ -52,6 +52,13 @@ extern "C" {
     void SCPI_ErrorPush(scpi_t * context, int16_t err);
     int32_t SCPI_ErrorCount(const scpi_t * context);
     const char * SCPI_ErrorTranslate(int16_t err);
+    const char * SCPI_ErrorTranslateEx(scpi_t * context, int16_t err);
+
+#if USE_EVENT_LOG
+    void SCPI_EventLogInit(scpi_t * context, scpi_event_record_t * data, uint32_t size);
+    uint32_t SCPI_EventLogSequence(const scpi_t * context);
+    size_t SCPI_EventLogRead(const scpi_t * context, uint32_t * sequence, scpi_event_record_t * records, size_t count);
+#endif
 
 
     /* Using X-Macro technique to define everything once
@@ -93,7 +100,7 @@ extern "C" {
     X(SCPI_ERROR_INVALID_STRING_DATA,           -151, "Invalid string data")                          \
     XE(SCPI_ERROR_STRING_DATA_NOT_ALLOWED,      -158, "String data not allowed")                      \
     XE(SCPI_ERROR_BLOCK_DATA_ERROR,             -160, "Block data error")                             \
-    XE(SCPI_ERROR_INVALID_BLOCK_DATA,           -161, "Invalid block data")                           \
+    X(SCPI_ERROR_INVALID_BLOCK_DATA,            -161, "Invalid block data")                           \
     XE(SCPI_ERROR_BLOCK_DATA_NOT_ALLOWED,       -168, "Block data not allowed")                       \
     X(SCPI_ERROR_EXPRESSION_PARSING_ERROR,      -170, "Expression error")                             \
     XE(SCPI_ERROR_INVAL_EXPRESSION,             -171, "Invalid expression")                           \
@@ -114,8 +121,8 @@ extern "C" {
     XE(SCPI_ERROR_ARM_DEADLOCK,                 -215, "Arm deadlock")                                 \
     XE(SCPI_ERROR_PARAMETER_ERROR,              -220, "Parameter error")                              \
     XE(SCPI_ERROR_SETTINGS_CONFLICT,            -221, "Settings conflict")                            \
-    XE(SCPI_ERROR_DATA_OUT_OF_RANGE,            -222, "Data out of range")                            \
-    XE(SCPI_ERROR_TOO_MUCH_DATA,                -223, "Too much data")                                \
+    X(SCPI_ERROR_DATA_OUT_OF_RANGE,             -222, "Data out of range")                            \
+    X(SCPI_ERROR_TOO_MUCH_DATA,                 -223, "Too much data")                                \
     X(SCPI_ERROR_ILLEGAL_PARAMETER_VALUE,       -224, "Illegal parameter value")                      \
     XE(SCPI_ERROR_OUT_OF_MEMORY_FOR_REQ_OP,     -225, "Out of memory")                                \
     XE(SCPI_ERROR_LISTS_NOT_SAME_LENGTH,        -226, "Lists not same length")                        \
@@ -176,7 +183,7 @@ extern "C" {
     XE(SCPI_ERROR_QUERY_ERROR,                  -400, "Query error")                                  \
     XE(SCPI_ERROR_QUERY_INTERRUPTED,            -410, "Query INTERRUPTED")                            \
     XE(SCPI_ERROR_QUERY_UNTERMINATED,           -420, "Query UNTERMINATED")                           \
-    XE(SCPI_ERROR_QUERY_DEADLOCKED,             -430, "Query DEADLOCKED")                             \
+    X(SCPI_ERROR_QUERY_DEADLOCKED,              -430, "Query DEADLOCKED")                             \
     XE(SCPI_ERROR_QUERY_UNTERM_INDEF_RESP,      -440, "Query UNTERMINATED after indefinite response") \
     XE(SCPI_ERROR_POWER_ON,                     -500, "Power on")                                     \
     XE(SCPI_ERROR_USER_REQUEST,                 -600, "User request")                                 \
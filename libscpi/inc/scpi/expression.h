@@ -50,10 +50,66 @@ extern "C" {
     };
     typedef enum _scpi_expr_result_t scpi_expr_result_t;
 
+    struct _scpi_expr_numeric_list_t {
+        lex_state_t lex;
+        int index;
+    };
+    typedef struct _scpi_expr_numeric_list_t scpi_expr_numeric_list_t;
+
+    struct _scpi_expr_channel_list_t {
+        lex_state_t lex;
+        int index;
+    };
+    typedef struct _scpi_expr_channel_list_t scpi_expr_channel_list_t;
+
+    struct _scpi_channel_range_t {
+        int32_t from[SCPI_CHANNEL_DIMENSIONS];
+        int32_t to[SCPI_CHANNEL_DIMENSIONS];
+        uint32_t stride[SCPI_CHANNEL_DIMENSIONS];
+        uint32_t count;
+    };
+    typedef struct _scpi_channel_range_t scpi_channel_range_t;
+
+    struct _scpi_channel_set_t {
+        size_t dimensions;
+        uint32_t * bits;
+        size_t bits_length;
+        scpi_channel_range_t * ranges;
+        size_t ranges_length;
+        size_t ranges_count;
+    };
+    typedef struct _scpi_channel_set_t scpi_channel_set_t;
+
+    struct _scpi_channel_iterator_t {
+        size_t range;
+        uint32_t offset;
+    };
+    typedef struct _scpi_channel_iterator_t scpi_channel_iterator_t;
+
     scpi_expr_result_t SCPI_ExprNumericListEntry(scpi_t * context, scpi_parameter_t * param, int index, scpi_bool_t * isRange, scpi_parameter_t * valueFrom, scpi_parameter_t * valueTo);
     scpi_expr_result_t SCPI_ExprNumericListEntryInt(scpi_t * context, scpi_parameter_t * param, int index, scpi_bool_t * isRange, int32_t * valueFrom, int32_t * valueTo);
     scpi_expr_result_t SCPI_ExprNumericListEntryDouble(scpi_t * context, scpi_parameter_t * param, int index, scpi_bool_t * isRange, double * valueFrom, double * valueTo);
+    scpi_expr_result_t SCPI_ExprNumericListBegin(scpi_t * context, scpi_parameter_t * param, scpi_expr_numeric_list_t * list);
+    scpi_expr_result_t SCPI_ExprNumericListNext(scpi_t * context, scpi_expr_numeric_list_t * list, scpi_bool_t * isRange, scpi_parameter_t * valueFrom, scpi_parameter_t * valueTo);
+    scpi_expr_result_t SCPI_ExprNumericListNextInt(scpi_t * context, scpi_expr_numeric_list_t * list, scpi_bool_t * isRange, int32_t * valueFrom, int32_t * valueTo);
+    scpi_expr_result_t SCPI_ExprNumericListNextDouble(scpi_t * context, scpi_expr_numeric_list_t * list, scpi_bool_t * isRange, double * valueFrom, double * valueTo);
+    scpi_expr_result_t SCPI_ExprNumericListExpandInt(scpi_t * context, scpi_parameter_t * param, int32_t * values, size_t length, size_t * count);
     scpi_expr_result_t SCPI_ExprChannelListEntry(scpi_t * context, scpi_parameter_t * param, int index, scpi_bool_t * isRange, int32_t * valuesFrom, int32_t * valuesTo, size_t length, size_t * dimensions);
+    scpi_expr_result_t SCPI_ExprChannelListBegin(scpi_t * context, scpi_parameter_t * param, scpi_expr_channel_list_t * list);
+    scpi_expr_result_t SCPI_ExprChannelListNext(scpi_t * context, scpi_expr_channel_list_t * list, scpi_bool_t * isRange, int32_t * valuesFrom, int32_t * valuesTo, size_t length, size_t * dimensions);
+
+    void SCPI_ChannelSetInit(scpi_channel_set_t * set, uint32_t * bits, size_t bits_length, scpi_channel_range_t * ranges, size_t ranges_length);
+    scpi_expr_result_t SCPI_ExprChannelListCompile(scpi_t * context, scpi_parameter_t * param, scpi_channel_set_t * set);
+    scpi_bool_t SCPI_ChannelSetContains(const scpi_channel_set_t * set, const int32_t * channel, size_t dimensions);
+    void SCPI_ChannelSetBegin(const scpi_channel_set_t * set, scpi_channel_iterator_t * iterator);
+    scpi_bool_t SCPI_ChannelSetNext(const scpi_channel_set_t * set, scpi_channel_iterator_t * iterator, int32_t * channel);
+
+#if USE_EXPRESSION_EVAL
+    void SCPI_ExprSetConstants(scpi_t * context, const scpi_expr_constant_t * constants);
+    scpi_expr_result_t SCPI_ExprCompile(scpi_t * context, scpi_parameter_t * param, scpi_expr_code_t * code);
+    scpi_expr_result_t SCPI_ExprEval(scpi_t * context, const scpi_expr_code_t * code, double * value);
+    scpi_expr_result_t SCPI_ExprEvalDouble(scpi_t * context, scpi_parameter_t * param, double * value);
+#endif
 
 #ifdef __cplusplus
 }
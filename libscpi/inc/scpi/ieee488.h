@@ -83,6 +83,11 @@ extern "C" {
     void SCPI_RegSet(scpi_t * context, scpi_reg_name_t name, scpi_reg_val_t val);
     void SCPI_RegSetBits(scpi_t * context, scpi_reg_name_t name, scpi_reg_val_t bits);
     void SCPI_RegClearBits(scpi_t * context, scpi_reg_name_t name, scpi_reg_val_t bits);
+    void SCPI_RegUpdateBatch(scpi_t * context, const scpi_reg_update_t * updates, size_t count);
+#if USE_REGISTER_SUBSCRIPTIONS
+    int SCPI_RegSubscribe(scpi_t * context, scpi_reg_name_t name, scpi_reg_val_t mask, scpi_reg_edge_t edge, scpi_reg_callback_t callback, void * user);
+    void SCPI_RegUnsubscribe(scpi_t * context, int handle);
+#endif
 
     void SCPI_EventClear(scpi_t * context);
 
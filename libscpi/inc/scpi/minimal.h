@@ -50,6 +50,9 @@ extern "C" {
     scpi_result_t SCPI_SystemVersionQ(scpi_t * context);
     scpi_result_t SCPI_SystemErrorNextQ(scpi_t * context);
     scpi_result_t SCPI_SystemErrorCountQ(scpi_t * context);
+#if USE_EVENT_LOG
+    scpi_result_t SCPI_SystemErrorLogQ(scpi_t * context);
+#endif
     scpi_result_t SCPI_StatusQuestionableEventQ(scpi_t * context);
     scpi_result_t SCPI_StatusQuestionableConditionQ(scpi_t * context);
     scpi_result_t SCPI_StatusQuestionableEnableQ(scpi_t * context);
@@ -59,6 +62,10 @@ extern "C" {
     scpi_result_t SCPI_StatusOperationEnableQ(scpi_t * context);
     scpi_result_t SCPI_StatusOperationEnable(scpi_t * context);
     scpi_result_t SCPI_StatusPreset(scpi_t * context);
+    scpi_result_t SCPI_FormatData(scpi_t * context);
+    scpi_result_t SCPI_FormatDataQ(scpi_t * context);
+    scpi_result_t SCPI_FormatBorder(scpi_t * context);
+    scpi_result_t SCPI_FormatBorderQ(scpi_t * context);
 
 
 #ifdef	__cplusplus
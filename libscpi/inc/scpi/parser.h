@@ -53,6 +53,13 @@ extern "C" {
             scpi_error_t * error_queue_data, int16_t error_queue_size);
 #if USE_DEVICE_DEPENDENT_ERROR_INFORMATION && !USE_MEMORY_ALLOCATION_FREE
     void SCPI_InitHeap(scpi_t * context, char * error_info_heap, size_t error_info_heap_length);
+    size_t SCPI_HeapPeak(const scpi_t * context);
+#endif
+#if USE_OUTPUT_QUEUE
+    void SCPI_InitOutputQueue(scpi_t * context, char * output_queue, size_t output_queue_length);
+    size_t SCPI_OutputPump(scpi_t * context);
+    size_t SCPI_OutputPending(const scpi_t * context);
+    void SCPI_OutputClear(scpi_t * context);
 #endif
 
     scpi_bool_t SCPI_Input(scpi_t * context, const char * data, int len);
@@ -91,6 +98,8 @@ extern "C" {
     size_t SCPI_ResultArrayUInt64(scpi_t * context, const uint64_t * array, size_t count, scpi_array_format_t format);
     size_t SCPI_ResultArrayFloat(scpi_t * context, const float * array, size_t count, scpi_array_format_t format);
     size_t SCPI_ResultArrayDouble(scpi_t * context, const double * array, size_t count, scpi_array_format_t format);
+    size_t SCPI_ResultArrayAutoFloat(scpi_t * context, const float * array, size_t count, double scale);
+    size_t SCPI_ResultArrayAutoDouble(scpi_t * context, const double * array, size_t count, double scale);
 
     scpi_bool_t SCPI_Parameter(scpi_t * context, scpi_parameter_t * parameter, scpi_bool_t mandatory);
     scpi_bool_t SCPI_ParamIsValid(const scpi_parameter_t * parameter);
@@ -104,6 +113,16 @@ extern "C" {
     scpi_bool_t SCPI_ParamToDouble(scpi_t * context, const scpi_parameter_t * parameter, double * value);
     scpi_bool_t SCPI_ParamToChoice(scpi_t * context, const scpi_parameter_t * parameter, const scpi_choice_def_t * options, int32_t * value);
     scpi_bool_t SCPI_ChoiceToName(const scpi_choice_def_t * options, int32_t tag, const char ** text);
+    scpi_bool_t SCPI_ChoiceToNameEx(scpi_t * context, const scpi_choice_def_t * options, int32_t tag, const char ** text);
+
+    void SCPI_ParamToView(const scpi_parameter_t * parameter, scpi_param_view_t * view);
+    scpi_bool_t SCPI_ParamView(scpi_t * context, scpi_param_view_t * view, scpi_bool_t mandatory);
+    scpi_bool_t SCPI_ViewIsKeyword(const scpi_param_view_t * view, const char * pattern);
+    scpi_bool_t SCPI_ViewToChoice(scpi_t * context, const scpi_param_view_t * view, const scpi_choice_def_t * options, int32_t * value);
+    scpi_bool_t SCPI_ViewToInt32(scpi_t * context, const scpi_param_view_t * view, int32_t * value);
+    scpi_bool_t SCPI_ViewToUInt32(scpi_t * context, const scpi_param_view_t * view, uint32_t * value);
+    scpi_bool_t SCPI_ViewToInt64(scpi_t * context, const scpi_param_view_t * view, int64_t * value);
+    scpi_bool_t SCPI_ViewToDouble(scpi_t * context, const scpi_param_view_t * view, double * value);
 
     scpi_bool_t SCPI_ParamInt32(scpi_t * context, int32_t * value, scpi_bool_t mandatory);
     scpi_bool_t SCPI_ParamUInt32(scpi_t * context, uint32_t * value, scpi_bool_t mandatory);
@@ -119,6 +138,10 @@ extern "C" {
     scpi_bool_t SCPI_ParamBool(scpi_t * context, scpi_bool_t * value, scpi_bool_t mandatory);
     scpi_bool_t SCPI_ParamChoice(scpi_t * context, const scpi_choice_def_t * options, int32_t * value, scpi_bool_t mandatory);
 
+    scpi_bool_t SCPI_ParamArrayInt8(scpi_t * context, int8_t *data, size_t i_count, size_t *o_count, scpi_array_format_t format, scpi_bool_t mandatory);
+    scpi_bool_t SCPI_ParamArrayUInt8(scpi_t * context, uint8_t *data, size_t i_count, size_t *o_count, scpi_array_format_t format, scpi_bool_t mandatory);
+    scpi_bool_t SCPI_ParamArrayInt16(scpi_t * context, int16_t *data, size_t i_count, size_t *o_count, scpi_array_format_t format, scpi_bool_t mandatory);
+    scpi_bool_t SCPI_ParamArrayUInt16(scpi_t * context, uint16_t *data, size_t i_count, size_t *o_count, scpi_array_format_t format, scpi_bool_t mandatory);
     scpi_bool_t SCPI_ParamArrayInt32(scpi_t * context, int32_t *data, size_t i_count, size_t *o_count, scpi_array_format_t format, scpi_bool_t mandatory);
     scpi_bool_t SCPI_ParamArrayUInt32(scpi_t * context, uint32_t *data, size_t i_count, size_t *o_count, scpi_array_format_t format, scpi_bool_t mandatory);
     scpi_bool_t SCPI_ParamArrayInt64(scpi_t * context, int64_t *data, size_t i_count, size_t *o_count, scpi_array_format_t format, scpi_bool_t mandatory);
@@ -127,6 +150,9 @@ extern "C" {
     scpi_bool_t SCPI_ParamArrayDouble(scpi_t * context, double *data, size_t i_count, size_t *o_count, scpi_array_format_t format, scpi_bool_t mandatory);
 
     scpi_bool_t SCPI_IsCmd(const scpi_t * context, const char * cmd);
+#if USE_PARAMETER_SCHEMA
+    const scpi_argument_t * SCPI_Argument(const scpi_t * context, size_t index);
+#endif /* USE_PARAMETER_SCHEMA */
 #if USE_COMMAND_TAGS
     int32_t SCPI_CmdTag(const scpi_t * context);
 #endif /* USE_COMMAND_TAGS */
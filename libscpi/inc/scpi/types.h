@@ -162,6 +162,22 @@ extern "C" {
     };
     typedef struct _scpi_reg_group_info_t scpi_reg_group_info_t;
 
+    struct _scpi_reg_update_t {
+        scpi_reg_name_t reg;
+        scpi_reg_val_t set_mask;
+        scpi_reg_val_t clear_mask;
+    };
+    typedef struct _scpi_reg_update_t scpi_reg_update_t;
+
+#if USE_REGISTER_SUBSCRIPTIONS
+    enum _scpi_reg_edge_t {
+        SCPI_REG_EDGE_RISING = 1,
+        SCPI_REG_EDGE_FALLING = 2,
+        SCPI_REG_EDGE_BOTH = 3,
+    };
+    typedef enum _scpi_reg_edge_t scpi_reg_edge_t;
+#endif
+
     /* scpi commands */
     enum _scpi_result_t {
         SCPI_RES_OK = 1,
@@ -171,12 +187,23 @@ extern "C" {
 
     typedef struct _scpi_command_t scpi_command_t;
 
-#if USE_COMMAND_TAGS
+#if USE_COMMAND_TAGS && USE_PARAMETER_SCHEMA
+	#define SCPI_CMD_LIST_END       {NULL, NULL, 0, NULL}
+	#define SCPI_CMD(p, c, t)       {p, c, t, NULL}
+#elif USE_COMMAND_TAGS
 	#define SCPI_CMD_LIST_END       {NULL, NULL, 0}
+	#define SCPI_CMD(p, c, t)       {p, c, t}
+#elif USE_PARAMETER_SCHEMA
+	#define SCPI_CMD_LIST_END       {NULL, NULL, NULL}
+	#define SCPI_CMD(p, c, t)       {p, c, NULL}
 #else
 	#define SCPI_CMD_LIST_END       {NULL, NULL}
+	#define SCPI_CMD(p, c, t)       {p, c}
 #endif
 
+/* SCPI_CMD(pattern, callback, tag) is command without schema for positional
+ * initializers, e.g. in C++ */
+
 
     /* scpi interface */
     typedef struct _scpi_t scpi_t;
@@ -199,6 +226,22 @@ extern "C" {
     typedef size_t(*scpi_write_t)(scpi_t * context, const char * data, size_t len);
     typedef scpi_result_t(*scpi_write_control_t)(scpi_t * context, scpi_ctrl_name_t ctrl, scpi_reg_val_t val);
     typedef int (*scpi_error_callback_t)(scpi_t * context, int_fast16_t error);
+    typedef const char * (*scpi_error_text_t)(scpi_t * context, int16_t error);
+#if USE_REGISTER_SUBSCRIPTIONS
+    typedef void (*scpi_reg_callback_t)(scpi_t * context, scpi_reg_name_t name, scpi_reg_val_t bits, scpi_reg_val_t val, void * user);
+
+    struct _scpi_reg_subscription_t {
+        scpi_reg_callback_t callback;
+        void * user;
+        scpi_reg_name_t name;
+        scpi_reg_val_t mask;
+        scpi_reg_edge_t edge;
+    };
+    typedef struct _scpi_reg_subscription_t scpi_reg_subscription_t;
+#endif
+#if USE_EVENT_LOG
+    typedef uint32_t(*scpi_timestamp_t)(scpi_t * context);
+#endif
 
     /* scpi lexer */
     enum _scpi_token_type_t {
@@ -269,12 +312,38 @@ extern "C" {
         /* size_t rd; */
         size_t count;
         size_t size;
+        size_t peak;
         char * data;
     };
     typedef struct _scpi_error_info_heap_t scpi_error_info_heap_t;
 
+    struct _scpi_error_info_slab_t {
+        char * data;
+        size_t slot_size;
+        uint16_t count;
+        uint16_t free;
+        uint16_t used;
+        uint16_t peak;
+    };
+    typedef struct _scpi_error_info_slab_t scpi_error_info_slab_t;
+
+    struct _scpi_output_queue_t {
+        size_t rd;
+        size_t count;
+        size_t pending;
+        size_t size;
+        char * data;
+        scpi_bool_t flush;
+        scpi_bool_t partial;
+        scpi_bool_t discard;
+    };
+    typedef struct _scpi_output_queue_t scpi_output_queue_t;
+
     struct _scpi_error_t {
         int16_t error_code;
+#if USE_ERROR_QUEUE_LOCKFREE
+        uint16_t sequence;
+#endif
 #if USE_DEVICE_DEPENDENT_ERROR_INFORMATION
         char * device_dependent_info;
 #endif
@@ -282,14 +351,37 @@ extern "C" {
     typedef struct _scpi_error_t scpi_error_t;
 
     struct _scpi_fifo_t {
+#if USE_ERROR_QUEUE_LOCKFREE
+        uint16_t wr;
+        uint16_t rd;
+        uint32_t overflow;
+#else
         int16_t wr;
         int16_t rd;
         int16_t count;
+#endif
         int16_t size;
         scpi_error_t * data;
     };
     typedef struct _scpi_fifo_t scpi_fifo_t;
 
+#if USE_EVENT_LOG
+    struct _scpi_event_record_t {
+        uint32_t sequence;
+        uint32_t timestamp;
+        int32_t tag;
+        int16_t error_code;
+    };
+    typedef struct _scpi_event_record_t scpi_event_record_t;
+
+    struct _scpi_event_log_t {
+        uint32_t wr;
+        uint32_t size;
+        scpi_event_record_t * data;
+    };
+    typedef struct _scpi_event_log_t scpi_event_log_t;
+#endif
+
     /* scpi units */
     enum _scpi_unit_t {
         SCPI_UNIT_NONE,
@@ -348,6 +440,7 @@ extern "C" {
         SCPI_UNIT_LITER
     };
     typedef enum _scpi_unit_t scpi_unit_t;
+#define SCPI_UNIT_COUNT (SCPI_UNIT_LITER + 1)
 
     struct _scpi_unit_def_t {
         const char * name;
@@ -357,6 +450,16 @@ extern "C" {
 #define SCPI_UNITS_LIST_END       {NULL, SCPI_UNIT_NONE, 0}
     typedef struct _scpi_unit_def_t scpi_unit_def_t;
 
+#if USE_UNITS_HASH
+    struct _scpi_units_index_t {
+        const scpi_unit_def_t * table;
+        scpi_bool_t valid;
+        uint8_t slot[SCPI_UNITS_HASH_SIZE];
+        uint8_t inverse[SCPI_UNIT_COUNT];
+    };
+    typedef struct _scpi_units_index_t scpi_units_index_t;
+#endif
+
     enum _scpi_special_number_t {
         SCPI_NUM_NUMBER,
         SCPI_NUM_MIN,
@@ -378,6 +481,42 @@ extern "C" {
 #define SCPI_CHOICE_LIST_END   {NULL, -1}
     typedef struct _scpi_choice_def_t scpi_choice_def_t;
 
+#if USE_CHOICE_INDEX
+    struct _scpi_choice_index_t {
+        const scpi_choice_def_t * table;
+        scpi_bool_t valid;
+        uint8_t slot[SCPI_CHOICE_HASH_SIZE];
+        uint8_t inverse[SCPI_CHOICE_HASH_SIZE];
+    };
+    typedef struct _scpi_choice_index_t scpi_choice_index_t;
+#endif
+
+#if USE_EXPRESSION_EVAL
+    struct _scpi_expr_constant_t {
+        const char * name;
+        double value;
+    };
+#define SCPI_EXPR_CONSTANTS_END {NULL, 0}
+    typedef struct _scpi_expr_constant_t scpi_expr_constant_t;
+
+    struct _scpi_expr_code_t {
+        const scpi_expr_constant_t * constants;
+        uint8_t length;
+        uint8_t literals;
+        uint8_t op[SCPI_EXPR_CODE_LENGTH];
+        double literal[(SCPI_EXPR_CODE_LENGTH + 1) / 2];
+    };
+    typedef struct _scpi_expr_code_t scpi_expr_code_t;
+
+    struct _scpi_expr_cache_t {
+        uint32_t hash;
+        uint8_t text_len;
+        char text[SCPI_EXPR_CACHE_TEXT_LENGTH];
+        scpi_expr_code_t code;
+    };
+    typedef struct _scpi_expr_cache_t scpi_expr_cache_t;
+#endif
+
     struct _scpi_param_list_t {
         const scpi_command_t * cmd;
         lex_state_t lex_state;
@@ -394,9 +533,44 @@ extern "C" {
         } content;
         scpi_unit_t unit;
         int8_t base;
+#if USE_NUMBER_EXACT
+        scpi_bool_t exact;
+        scpi_bool_t negative;
+        uint64_t mantissa;
+        int16_t exponent;
+#endif
     };
     typedef struct _scpi_number_parameter_t scpi_number_t;
 
+    enum _scpi_param_view_kind_t {
+        SCPI_VIEW_OTHER,
+        SCPI_VIEW_INTEGER,
+        SCPI_VIEW_REAL,
+        SCPI_VIEW_NONDECIMAL,
+        SCPI_VIEW_MNEMONIC,
+        SCPI_VIEW_STRING,
+        SCPI_VIEW_BLOCK,
+        SCPI_VIEW_EXPRESSION,
+    };
+    typedef enum _scpi_param_view_kind_t scpi_param_view_kind_t;
+
+    struct _scpi_param_view_t {
+        scpi_param_view_kind_t kind;
+        const char * ptr;
+        size_t len;
+        scpi_bool_t negative;
+        int8_t base;
+        const char * integer;
+        size_t integer_len;
+        const char * fraction;
+        size_t fraction_len;
+        const char * exponent;
+        size_t exponent_len;
+        const char * suffix;
+        size_t suffix_len;
+    };
+    typedef struct _scpi_param_view_t scpi_param_view_t;
+
     struct _scpi_data_parameter_t {
         const char * ptr;
         int32_t len;
@@ -405,12 +579,65 @@ extern "C" {
 
     typedef scpi_token_t scpi_parameter_t;
 
+#if USE_PARAMETER_SCHEMA
+    enum _scpi_param_type_t {
+        SCPI_PARAM_INT32,
+        SCPI_PARAM_UINT32,
+        SCPI_PARAM_DOUBLE,
+        SCPI_PARAM_BOOL,
+        SCPI_PARAM_CHOICE,
+        SCPI_PARAM_NUMBER,
+        SCPI_PARAM_TEXT
+    };
+    typedef enum _scpi_param_type_t scpi_param_type_t;
+
+    struct _scpi_param_schema_t {
+        scpi_param_type_t type;
+        /* SCPI_PARAM_NUMBER: expected unit, number without suffix gets this unit */
+        scpi_unit_t unit;
+        /* range check of numeric types and value of MIN and MAX, if min < max */
+        double min;
+        double max;
+        /* value of optional parameter, which is not present, and of DEFault */
+        double def;
+        /* SCPI_PARAM_CHOICE: list of choices, SCPI_PARAM_NUMBER: special numbers */
+        const scpi_choice_def_t * choices;
+    };
+    typedef struct _scpi_param_schema_t scpi_param_schema_t;
+
+    struct _scpi_command_schema_t {
+        const scpi_param_schema_t * params;
+        uint8_t count;
+        uint8_t mandatory;
+    };
+    typedef struct _scpi_command_schema_t scpi_command_schema_t;
+
+    struct _scpi_argument_t {
+        scpi_param_type_t type;
+        scpi_bool_t present;
+
+        union {
+            int32_t int32;
+            uint32_t uint32;
+            double value;
+            scpi_bool_t boolean;
+            int32_t tag;
+            scpi_number_t number;
+            scpi_data_parameter_t text;
+        } content;
+    };
+    typedef struct _scpi_argument_t scpi_argument_t;
+#endif /* USE_PARAMETER_SCHEMA */
+
     struct _scpi_command_t {
         const char * pattern;
         scpi_command_callback_t callback;
 #if USE_COMMAND_TAGS
         int32_t tag;
 #endif /* USE_COMMAND_TAGS */
+#if USE_PARAMETER_SCHEMA
+        const scpi_command_schema_t * schema;
+#endif /* USE_PARAMETER_SCHEMA */
     };
 
     struct _scpi_interface_t {
@@ -419,8 +646,34 @@ extern "C" {
         scpi_write_control_t control;
         scpi_command_callback_t flush;
         scpi_command_callback_t reset;
+        scpi_error_text_t error_text;
+#if USE_EVENT_LOG
+        scpi_timestamp_t timestamp;
+#endif
     };
 
+    enum _scpi_array_format_t {
+        SCPI_FORMAT_ASCII = 0,
+        SCPI_FORMAT_NORMAL = 1,
+        SCPI_FORMAT_SWAPPED = 2,
+        SCPI_FORMAT_BIGENDIAN = SCPI_FORMAT_NORMAL,
+        SCPI_FORMAT_LITTLEENDIAN = SCPI_FORMAT_SWAPPED,
+    };
+    typedef enum _scpi_array_format_t scpi_array_format_t;
+
+    enum _scpi_data_format_t {
+        SCPI_DATA_FORMAT_ASCII = 0,
+        SCPI_DATA_FORMAT_REAL32,
+        SCPI_DATA_FORMAT_REAL64,
+        SCPI_DATA_FORMAT_INT16,
+        SCPI_DATA_FORMAT_INT32,
+#if USE_PACKED_DATA_FORMAT
+        SCPI_DATA_FORMAT_PACKED16,
+        SCPI_DATA_FORMAT_PACKED32,
+#endif
+    };
+    typedef enum _scpi_data_format_t scpi_data_format_t;
+
     struct _scpi_t {
         const scpi_command_t * cmdlist;
         scpi_buffer_t buffer;
@@ -432,25 +685,47 @@ extern "C" {
         scpi_bool_t cmd_error;
         scpi_fifo_t error_queue;
 #if USE_DEVICE_DEPENDENT_ERROR_INFORMATION && !USE_MEMORY_ALLOCATION_FREE
+#if USE_ERROR_INFO_SLAB
+        scpi_error_info_slab_t error_info_heap;
+#else
         scpi_error_info_heap_t error_info_heap;
+#endif
+#endif
+#if USE_EVENT_LOG
+        scpi_event_log_t event_log;
+#endif
+#if USE_OUTPUT_QUEUE
+        scpi_output_queue_t output_queue;
 #endif
         scpi_reg_val_t registers[SCPI_REG_COUNT];
+#if USE_REGISTER_SUBSCRIPTIONS
+        scpi_reg_subscription_t reg_subscriptions[SCPI_REG_SUBSCRIPTION_COUNT];
+#endif
         const scpi_unit_def_t * units;
+#if USE_UNITS_HASH
+        scpi_units_index_t units_index;
+#endif
+#if USE_CHOICE_INDEX
+        scpi_choice_index_t choice_index[SCPI_CHOICE_INDEX_COUNT];
+        uint8_t choice_index_next;
+#endif
+#if USE_EXPRESSION_EVAL
+        const scpi_expr_constant_t * expr_constants;
+        scpi_expr_cache_t expr_cache[SCPI_EXPR_CACHE_COUNT];
+        uint8_t expr_cache_next;
+#endif
         void * user_context;
         scpi_parser_state_t parser_state;
         const char * idn[4];
         size_t arbitrary_remaining;
+        scpi_data_format_t data_format;
+        scpi_array_format_t byte_order;
+#if USE_PARAMETER_SCHEMA
+        const scpi_argument_t * arguments;
+        size_t argument_count;
+#endif
     };
 
-    enum _scpi_array_format_t {
-        SCPI_FORMAT_ASCII = 0,
-        SCPI_FORMAT_NORMAL = 1,
-        SCPI_FORMAT_SWAPPED = 2,
-        SCPI_FORMAT_BIGENDIAN = SCPI_FORMAT_NORMAL,
-        SCPI_FORMAT_LITTLEENDIAN = SCPI_FORMAT_SWAPPED,
-    };
-    typedef enum _scpi_array_format_t scpi_array_format_t;
-
 #ifdef  __cplusplus
 }
 #endif
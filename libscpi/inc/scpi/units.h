@@ -51,6 +51,11 @@ extern "C" {
 
     scpi_bool_t SCPI_ParamTranslateNumberVal(scpi_t * context, scpi_parameter_t * parameter);
     size_t SCPI_NumberToStr(const scpi_t * context, const scpi_choice_def_t * special, scpi_number_t * value, char * str, size_t len);
+    size_t SCPI_NumberToStrEng(const scpi_t * context, const scpi_choice_def_t * special, scpi_number_t * value, char * str, size_t len);
+#if USE_NUMBER_EXACT
+    scpi_bool_t SCPI_NumberToInt64(scpi_t * context, const scpi_number_t * value, int64_t * result);
+    scpi_bool_t SCPI_NumberToUInt64(scpi_t * context, const scpi_number_t * value, uint64_t * result);
+#endif
 
 #ifdef	__cplusplus
 }
@@ -50,6 +50,14 @@ extern "C" {
     size_t SCPI_Int64ToStr(int64_t val, char * str, size_t len);
     size_t SCPI_FloatToStr(float val, char * str, size_t len);
     size_t SCPI_DoubleToStr(double val, char * str, size_t len);
+    size_t SCPI_FloatToStrPrecision(float val, char * str, size_t len, uint8_t precision);
+    size_t SCPI_DoubleToStrPrecision(double val, char * str, size_t len, uint8_t precision);
+
+#if USE_PACKED_DATA_FORMAT
+#define SCPI_PACKED_MAGIC   'Z'
+#define SCPI_PACKED_VERSION 1
+    scpi_bool_t SCPI_PackedDecode(const void * data, size_t len, int32_t * values, size_t i_count, size_t * o_count);
+#endif
 
     /* deprecated function, should be removed later */
 #define SCPI_LongToStr(val, str, len, base) SCPI_Int32ToStr((val), (str), (len), (base), TRUE)
@@ -34,6 +34,7 @@
  *
  */
 
+#include <stddef.h>
 #include <stdint.h>
 
 #include "scpi/parser.h"
@@ -48,14 +49,25 @@
 #define SCPI_ERROR_SETVAL(e, c, i) do { (e)->error_code = (c); (void)(i);} while(0)
 #endif
 
+#if USE_ERROR_TABLE
+static scpi_bool_t errorListSorted(void);
+#endif
+
 /**
- * Initialize error queue
+ * Initialize error queue. Error table not sorted by error number is reported
+ * as System error, because binary search would not find all its entries.
  * @param context - scpi context
  * @param data - memory for error queue
  * @param size - size of data
  */
 void SCPI_ErrorInit(scpi_t * context, scpi_error_t * data, const int16_t size) {
     fifo_init(&context->error_queue, data, size);
+
+#if USE_ERROR_TABLE
+    if (!errorListSorted()) {
+        SCPI_ErrorPush(context, SCPI_ERROR_SYSTEM_ERROR);
+    }
+#endif
 }
 
 /**
@@ -111,6 +123,13 @@ scpi_bool_t SCPI_ErrorPop(scpi_t * context, scpi_error_t * error) {
     if (!error || !context) return FALSE;
     SCPI_ERROR_SETVAL(error, 0, NULL);
     fifo_remove(&context->error_queue, error);
+#if USE_ERROR_QUEUE_LOCKFREE && USE_DEVICE_DEPENDENT_ERROR_INFORMATION
+    if ((error->error_code == SCPI_ERROR_QUEUE_OVERFLOW) && error->device_dependent_info) {
+        /* information of error replaced by queue overflow */
+        SCPIDEFINE_free(&context->error_info_heap, error->device_dependent_info, false);
+        error->device_dependent_info = NULL;
+    }
+#endif
 
     SCPI_ErrorEmitEmpty(context);
 
@@ -143,15 +162,164 @@ static scpi_bool_t SCPI_ErrorAddInternal(scpi_t * context, const int16_t err, co
     SCPI_ERROR_SETVAL(&error_value, err, info_ptr);
     if (!fifo_add(&context->error_queue, &error_value)) {
         SCPIDEFINE_free(&context->error_info_heap, error_value.device_dependent_info, true);
+#if USE_ERROR_QUEUE_LOCKFREE
+        /* last error is replaced when it is popped by the consumer */
+        fifo_mark_overflow(&context->error_queue);
+        return FALSE;
+#else
         fifo_remove_last(&context->error_queue, &error_value);
         SCPIDEFINE_free(&context->error_info_heap, error_value.device_dependent_info, true);
         SCPI_ERROR_SETVAL(&error_value, SCPI_ERROR_QUEUE_OVERFLOW, NULL);
         fifo_add(&context->error_queue, &error_value);
         return FALSE;
+#endif
     }
     return TRUE;
 }
 
+#if USE_EVENT_LOG
+
+/*
+ * Records of the event log are published by their sequence number. While a
+ * record is written, its sequence is set to a value, which never belongs to
+ * its slot. Reader compares the sequence before and after copying the record
+ * to detect unpublished, torn or overwritten records.
+ */
+#define EVENT_LOAD(p)           __atomic_load_n((p), __ATOMIC_RELAXED)
+#define EVENT_STORE(p, v)       __atomic_store_n((p), (v), __ATOMIC_RELAXED)
+#define EVENT_SLOT_BUSY(seq)    ((uint32_t) ((seq) - 1))
+
+/**
+ * Initialize event log, call it after SCPI_Init
+ * @param context
+ * @param data - memory for records, NULL to disable the log
+ * @param size - number of records, rounded down to power of two, at least 2
+ */
+void SCPI_EventLogInit(scpi_t * context, scpi_event_record_t * data, uint32_t size) {
+    scpi_event_log_t * log = &context->event_log;
+    uint32_t i;
+
+    log->wr = 0;
+    log->size = 0;
+    log->data = data;
+    if (!data || size < 2) {
+        return;
+    }
+
+    log->size = 2;
+    while (log->size <= size / 2) {
+        log->size *= 2;
+    }
+
+    for (i = 0; i < log->size; i++) {
+        log->data[i].sequence = EVENT_SLOT_BUSY(i);
+        log->data[i].timestamp = 0;
+        log->data[i].tag = 0;
+        log->data[i].error_code = 0;
+    }
+}
+
+/**
+ * Add record to event log, oldest record is overwritten, if the log is full
+ * @param context
+ * @param err - error number
+ */
+static void SCPI_EventLogAdd(scpi_t * context, const int16_t err) {
+    scpi_event_log_t * log = &context->event_log;
+    scpi_event_record_t * record;
+    uint32_t timestamp = 0;
+    int32_t tag = 0;
+    uint32_t seq;
+
+    if (log->size == 0) {
+        return;
+    }
+
+    if (context->interface && context->interface->timestamp) {
+        timestamp = context->interface->timestamp(context);
+    }
+#if USE_COMMAND_TAGS
+    tag = SCPI_CmdTag(context);
+#endif
+
+    seq = __atomic_fetch_add(&log->wr, 1, __ATOMIC_RELAXED);
+    record = &log->data[seq & (log->size - 1)];
+
+    EVENT_STORE(&record->sequence, EVENT_SLOT_BUSY(seq));
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    EVENT_STORE(&record->timestamp, timestamp);
+    EVENT_STORE(&record->tag, tag);
+    EVENT_STORE(&record->error_code, err);
+    __atomic_store_n(&record->sequence, seq, __ATOMIC_RELEASE);
+}
+
+/**
+ * Sequence number of the next record written to event log
+ * @param context
+ * @return sequence number
+ */
+uint32_t SCPI_EventLogSequence(const scpi_t * context) {
+    return __atomic_load_n(&context->event_log.wr, __ATOMIC_ACQUIRE);
+}
+
+/**
+ * Read records from event log
+ *
+ * Reading starts at *sequence or at the oldest record still in the log and
+ * stops at first record, which is not yet completely written. Records
+ * overwritten during reading are skipped.
+ *
+ * @param context
+ * @param sequence - in: sequence number of first record to read,
+ *                   out: sequence number of next record to read
+ * @param records - destination
+ * @param count - maximal number of records
+ * @return number of records read
+ */
+size_t SCPI_EventLogRead(const scpi_t * context, uint32_t * sequence, scpi_event_record_t * records, size_t count) {
+    const scpi_event_log_t * log = &context->event_log;
+    const scpi_event_record_t * record;
+    uint32_t seq = *sequence;
+    uint32_t wr;
+    uint32_t published;
+    size_t n = 0;
+
+    if (log->size == 0) {
+        return 0;
+    }
+
+    wr = SCPI_EventLogSequence(context);
+    if (wr - seq > log->size) {
+        seq = wr - log->size;
+    }
+
+    for (; (n < count) && (seq != wr); seq++) {
+        record = &log->data[seq & (log->size - 1)];
+        published = __atomic_load_n(&record->sequence, __ATOMIC_ACQUIRE);
+        if ((int32_t) (published - seq) < 0) {
+            /* writer of this record has not finished yet */
+            break;
+        }
+        if (published != seq) {
+            continue;
+        }
+
+        records[n].timestamp = EVENT_LOAD(&record->timestamp);
+        records[n].tag = EVENT_LOAD(&record->tag);
+        records[n].error_code = EVENT_LOAD(&record->error_code);
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        if (EVENT_LOAD(&record->sequence) == seq) {
+            records[n].sequence = seq;
+            n++;
+        }
+    }
+
+    *sequence = seq;
+    return n;
+}
+
+#endif /* USE_EVENT_LOG */
+
 struct error_reg {
     int16_t from;
     int16_t to;
@@ -186,6 +354,12 @@ void SCPI_ErrorPushEx(scpi_t * context, const int16_t err, const char * info, si
     }
     const scpi_bool_t queue_overflow = !SCPI_ErrorAddInternal(context, err, info, info_len);
 
+#if USE_EVENT_LOG
+    if (context) {
+        SCPI_EventLogAdd(context, err);
+    }
+#endif
+
     for (int i = 0; i < ERROR_DEFS_N; i++) {
         if ((err <= errs[i].from) && (err >= errs[i].to)) {
             SCPI_RegSetBits(context, SCPI_REG_ESR, errs[i].esrBit);
@@ -211,26 +385,169 @@ void SCPI_ErrorPush(scpi_t * context, const int16_t err) {
     SCPI_ErrorPushEx(context, err, NULL, 0);
 }
 
+#if USE_FULL_ERROR_LIST
+#define XE X
+#else
+#define XE(def, val, str)
+#endif
+
+#if USE_ERROR_TABLE
+
+/* layout of error string blob, offset of each string is offset of member */
+struct _scpi_error_strings_t {
+#define X(def, val, str) char def[sizeof (str)];
+    LIST_OF_ERRORS
+#undef X
+};
+
+static const struct _scpi_error_strings_t errorStrings = {
+#define X(def, val, str) str,
+    LIST_OF_ERRORS
+#undef X
+};
+
+struct _scpi_error_entry_t {
+    int16_t code;
+    uint32_t offset;
+};
+typedef struct _scpi_error_entry_t scpi_error_entry_t;
+
+#define X(def, val, str) {def, offsetof(struct _scpi_error_strings_t, def)},
+static const scpi_error_entry_t errorTable[] = {
+    LIST_OF_ERRORS
+};
+#undef X
+
+#define ERROR_TABLE_COUNT(t) (sizeof (t) / sizeof ((t)[0]))
+
+/**
+ * Test if error table is strictly monotonic, in ascending or descending order
+ * @param table
+ * @param count number of entries
+ * @return TRUE if binary search finds all entries
+ */
+static scpi_bool_t errorTableSorted(const scpi_error_entry_t * table, size_t count) {
+    const int ascending = (count > 1) && (table[0].code < table[1].code);
+    size_t i;
+
+    for (i = 1; i < count; i++) {
+        if ((table[i - 1].code == table[i].code) || ((table[i - 1].code < table[i].code) != ascending)) {
+            return FALSE;
+        }
+    }
+
+    return TRUE;
+}
+
+/**
+ * Check order of error table, done once by SCPI_ErrorInit
+ * @return TRUE if the table is sorted
+ */
+static scpi_bool_t errorListSorted(void) {
+    return errorTableSorted(errorTable, ERROR_TABLE_COUNT(errorTable));
+}
+
+/**
+ * Binary search of error table sorted in ascending or descending order
+ * @param table
+ * @param count number of entries
+ * @param err - error number
+ * @return entry or NULL
+ */
+static const scpi_error_entry_t * errorTableFind(const scpi_error_entry_t * table, size_t count, const int16_t err) {
+    int descending;
+    size_t lo = 0;
+    size_t hi = count;
+
+    if (count == 0) {
+        return NULL;
+    }
+
+    descending = table[0].code > table[count - 1].code;
+
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (table[mid].code == err) {
+            return &table[mid];
+        }
+        if ((table[mid].code < err) != descending) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+
+    return NULL;
+}
+
 /**
  * Translate error number to string
+ *
+ * Error strings of LIST_OF_ERRORS are stored in one blob and found by
+ * binary search of table of error numbers. LIST_OF_USER_ERRORS is not
+ * required to be sorted, so it is translated by switch.
+ *
  * @param err - error number
  * @return Error string representation
  */
 const char * SCPI_ErrorTranslate(const int16_t err) {
+    const scpi_error_entry_t * entry;
+
+    entry = errorTableFind(errorTable, ERROR_TABLE_COUNT(errorTable), err);
+    if (entry) {
+        return (const char *) &errorStrings + entry->offset;
+    }
+
+#if USE_USER_ERROR_LIST
     switch (err) {
 #define X(def, val, str) case def: return str;
-#if USE_FULL_ERROR_LIST
-#define XE X
-#else
-#define XE(def, val, str)
+        LIST_OF_USER_ERRORS
+#undef X
+    default: break;
+    }
 #endif
+
+    return "Unknown error";
+}
+
+#else /* USE_ERROR_TABLE */
+
+/**
+ * Translate error number to string
+ * @param err - error number
+ * @return Error string representation
+ */
+const char * SCPI_ErrorTranslate(const int16_t err) {
+    switch (err) {
+#define X(def, val, str) case def: return str;
     LIST_OF_ERRORS
 
 #if USE_USER_ERROR_LIST
         LIST_OF_USER_ERRORS
 #endif
 #undef X
-#undef XE
     default: return "Unknown error";
     }
 }
+
+#endif /* USE_ERROR_TABLE */
+
+#undef XE
+
+/**
+ * Translate error number to string, text provided by error_text callback
+ * of the interface is preferred, e.g. localized or loaded from external
+ * resource
+ * @param context - scpi context
+ * @param err - error number
+ * @return Error string representation
+ */
+const char * SCPI_ErrorTranslateEx(scpi_t * context, const int16_t err) {
+    const char * text = NULL;
+
+    if (context && context->interface && context->interface->error_text) {
+        text = context->interface->error_text(context, err);
+    }
+
+    return text ? text : SCPI_ErrorTranslate(err);
+}
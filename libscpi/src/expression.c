@@ -34,11 +34,15 @@
  *
  */
 
+#include <float.h>
+#include <string.h>
+
 #include "scpi/expression.h"
 #include "scpi/error.h"
 #include "scpi/parser.h"
 
 #include "lexer_private.h"
+#include "utils_private.h"
 
 /**
  * Parse one range or single value
@@ -69,55 +73,212 @@ static scpi_expr_result_t numericRange(lex_state_t * state, scpi_bool_t * isRang
 }
 
 /**
- * Parse entry on specified position
+ * Start iteration over numeric list
  * @param context scpi context
  * @param param input parameter
- * @param index index of position (start from 0)
- * @param isRange return true if expression at index was range
+ * @param list iterator state
+ * @return SCPI_EXPR_OK - param is expression
+ *         SCPI_EXPR_ERROR - param is not expression
+ * @see SCPI_ExprNumericListNext, SCPI_ExprNumericListNextInt, SCPI_ExprNumericListNextDouble
+ */
+scpi_expr_result_t SCPI_ExprNumericListBegin(scpi_t * context, scpi_parameter_t * param, scpi_expr_numeric_list_t * list) {
+    if (!param || !list) {
+        SCPI_ErrorPush(context, SCPI_ERROR_SYSTEM_ERROR);
+        return SCPI_EXPR_ERROR;
+    }
+
+    if (param->type != SCPI_TOKEN_PROGRAM_EXPRESSION) {
+        SCPI_ErrorPush(context, SCPI_ERROR_DATA_TYPE_ERROR);
+        return SCPI_EXPR_ERROR;
+    }
+
+    list->lex.buffer = param->ptr + 1;
+    list->lex.pos = list->lex.buffer;
+    list->lex.len = param->len - 2;
+    list->index = 0;
+
+    return SCPI_EXPR_OK;
+}
+
+/**
+ * Parse next entry of numeric list, lexer position is kept in the iterator,
+ * so walking the whole list is linear
+ * @param context scpi context
+ * @param list iterator state initialized by SCPI_ExprNumericListBegin
+ * @param isRange return true if the entry was range
  * @param valueFrom return value from
  * @param valueTo return value to
  * @return SCPI_EXPR_OK - parsing was successful
  *         SCPI_EXPR_ERROR - parser error
  *         SCPI_EXPR_NO_MORE - no more data
- * @see SCPI_ExprNumericListEntryInt, SCPI_ExprNumericListEntryDouble
  */
-scpi_expr_result_t SCPI_ExprNumericListEntry(scpi_t * context, scpi_parameter_t * param, const int index, scpi_bool_t * isRange, scpi_parameter_t * valueFrom, scpi_parameter_t * valueTo) {
-    lex_state_t lex;
-    scpi_expr_result_t res = SCPI_EXPR_OK;
+scpi_expr_result_t SCPI_ExprNumericListNext(scpi_t * context, scpi_expr_numeric_list_t * list, scpi_bool_t * isRange, scpi_parameter_t * valueFrom, scpi_parameter_t * valueTo) {
+    scpi_expr_result_t res;
 
-    if (!isRange || !valueFrom || !valueTo || !param) {
+    if (!list || !isRange || !valueFrom || !valueTo) {
         SCPI_ErrorPush(context, SCPI_ERROR_SYSTEM_ERROR);
         return SCPI_EXPR_ERROR;
     }
 
-    if (param->type != SCPI_TOKEN_PROGRAM_EXPRESSION) {
-        SCPI_ErrorPush(context, SCPI_ERROR_DATA_TYPE_ERROR);
-        return SCPI_EXPR_ERROR;
+    if ((list->index > 0) && !scpiLex_Comma(&list->lex, valueFrom)) {
+        res = scpiLex_IsEos(&list->lex) ? SCPI_EXPR_NO_MORE : SCPI_EXPR_ERROR;
+    } else {
+        res = numericRange(&list->lex, isRange, valueFrom, valueTo);
+    }
+
+    if (res == SCPI_EXPR_OK) {
+        list->index++;
+    } else if (res == SCPI_EXPR_ERROR) {
+        SCPI_ErrorPush(context, SCPI_ERROR_EXPRESSION_PARSING_ERROR);
+    }
+    return res;
+}
+
+/**
+ * Parse next entry of numeric list and convert result to int32_t
+ * @param context scpi context
+ * @param list iterator state initialized by SCPI_ExprNumericListBegin
+ * @param isRange return true if the entry was range
+ * @param valueFrom return value from
+ * @param valueTo return value to
+ * @return SCPI_EXPR_OK - parsing was successful
+ *         SCPI_EXPR_ERROR - parser error or value is out of range
+ *         SCPI_EXPR_NO_MORE - no more data
+ */
+scpi_expr_result_t SCPI_ExprNumericListNextInt(scpi_t * context, scpi_expr_numeric_list_t * list, scpi_bool_t * isRange, int32_t * valueFrom, int32_t * valueTo) {
+    scpi_bool_t range = FALSE;
+    scpi_parameter_t paramFrom;
+    scpi_parameter_t paramTo;
+
+    scpi_expr_result_t res = SCPI_ExprNumericListNext(context, list, &range, &paramFrom, &paramTo);
+    if (res == SCPI_EXPR_OK) {
+        *isRange = range;
+        if (!SCPI_ParamToInt32(context, &paramFrom, valueFrom)
+                || (range && !SCPI_ParamToInt32(context, &paramTo, valueTo))) {
+            return SCPI_EXPR_ERROR;
+        }
     }
 
-    lex.buffer = param->ptr + 1;
-    lex.pos = lex.buffer;
-    lex.len = param->len - 2;
+    return res;
+}
 
-    for (int i = 0; i <= index; i++) {
-        res = numericRange(&lex, isRange, valueFrom, valueTo);
+/**
+ * Parse next entry of numeric list and convert result to double
+ * @param context scpi context
+ * @param list iterator state initialized by SCPI_ExprNumericListBegin
+ * @param isRange return true if the entry was range
+ * @param valueFrom return value from
+ * @param valueTo return value to
+ * @return SCPI_EXPR_OK - parsing was successful
+ *         SCPI_EXPR_ERROR - parser error
+ *         SCPI_EXPR_NO_MORE - no more data
+ */
+scpi_expr_result_t SCPI_ExprNumericListNextDouble(scpi_t * context, scpi_expr_numeric_list_t * list, scpi_bool_t * isRange, double * valueFrom, double * valueTo) {
+    scpi_bool_t range = FALSE;
+    scpi_parameter_t paramFrom;
+    scpi_parameter_t paramTo;
+
+    scpi_expr_result_t res = SCPI_ExprNumericListNext(context, list, &range, &paramFrom, &paramTo);
+    if (res == SCPI_EXPR_OK) {
+        *isRange = range;
+        if (!SCPI_ParamToDouble(context, &paramFrom, valueFrom)
+                || (range && !SCPI_ParamToDouble(context, &paramTo, valueTo))) {
+            return SCPI_EXPR_ERROR;
+        }
+    }
+
+    return res;
+}
+
+/**
+ * Expand numeric list to array of integers. Ranges are expanded with step 1
+ * in their direction, e.g. (1:3,7,5:4) gives 1, 2, 3, 7, 5, 4.
+ * @param context scpi context
+ * @param param input parameter
+ * @param values destination array
+ * @param length size of values
+ * @param count return number of stored values
+ * @return SCPI_EXPR_OK - parsing was successful
+ *         SCPI_EXPR_ERROR - parser error, value is out of range or values
+ *         array is too small
+ */
+scpi_expr_result_t SCPI_ExprNumericListExpandInt(scpi_t * context, scpi_parameter_t * param, int32_t * values, const size_t length, size_t * count) {
+    scpi_expr_numeric_list_t list;
+    scpi_expr_result_t res;
+    scpi_bool_t isRange;
+    int32_t valueFrom;
+    int32_t valueTo;
+    int64_t value;
+    int64_t step;
+    size_t n = 0;
+
+    if (!values || !count) {
+        SCPI_ErrorPush(context, SCPI_ERROR_SYSTEM_ERROR);
+        return SCPI_EXPR_ERROR;
+    }
+    *count = 0;
+
+    res = SCPI_ExprNumericListBegin(context, param, &list);
+    while (res == SCPI_EXPR_OK) {
+        res = SCPI_ExprNumericListNextInt(context, &list, &isRange, &valueFrom, &valueTo);
         if (res != SCPI_EXPR_OK) {
             break;
         }
-        if (i != index) {
-            if (!scpiLex_Comma(&lex, valueFrom)) {
-                res = scpiLex_IsEos(&lex) ? SCPI_EXPR_NO_MORE : SCPI_EXPR_ERROR;
-                break;
-            }
+        if (!isRange) {
+            valueTo = valueFrom;
+        }
+
+        step = (valueTo >= valueFrom) ? 1 : -1;
+        if ((uint64_t) ((valueTo - (int64_t) valueFrom) * step) >= length - n) {
+            SCPI_ErrorPush(context, SCPI_ERROR_DATA_OUT_OF_RANGE);
+            return SCPI_EXPR_ERROR;
+        }
+        for (value = valueFrom; value != valueTo + step; value += step) {
+            values[n++] = (int32_t) value;
         }
     }
 
-    if (res == SCPI_EXPR_ERROR) {
-        SCPI_ErrorPush(context, SCPI_ERROR_EXPRESSION_PARSING_ERROR);
+    if (res == SCPI_EXPR_NO_MORE) {
+        *count = n;
+        return SCPI_EXPR_OK;
     }
     return res;
 }
 
+/**
+ * Parse entry on specified position
+ *
+ * Each call parses the list from its beginning, use SCPI_ExprNumericListBegin
+ * and SCPI_ExprNumericListNext to walk the whole list.
+ *
+ * @param context scpi context
+ * @param param input parameter
+ * @param index index of position (start from 0)
+ * @param isRange return true if expression at index was range
+ * @param valueFrom return value from
+ * @param valueTo return value to
+ * @return SCPI_EXPR_OK - parsing was successful
+ *         SCPI_EXPR_ERROR - parser error
+ *         SCPI_EXPR_NO_MORE - no more data
+ * @see SCPI_ExprNumericListEntryInt, SCPI_ExprNumericListEntryDouble
+ */
+scpi_expr_result_t SCPI_ExprNumericListEntry(scpi_t * context, scpi_parameter_t * param, const int index, scpi_bool_t * isRange, scpi_parameter_t * valueFrom, scpi_parameter_t * valueTo) {
+    scpi_expr_numeric_list_t list;
+    scpi_expr_result_t res;
+
+    if (!isRange || !valueFrom || !valueTo || !param) {
+        SCPI_ErrorPush(context, SCPI_ERROR_SYSTEM_ERROR);
+        return SCPI_EXPR_ERROR;
+    }
+
+    res = SCPI_ExprNumericListBegin(context, param, &list);
+    while ((res == SCPI_EXPR_OK) && (list.index <= index)) {
+        res = SCPI_ExprNumericListNext(context, &list, isRange, valueFrom, valueTo);
+    }
+
+    return res;
+}
+
 /**
  * Parse entry on specified position and convert result to int32_t
  * @param context scpi context
@@ -249,8 +410,84 @@ static scpi_expr_result_t channelRange(scpi_t * context, lex_state_t * state, sc
     return err;
 }
 
+/**
+ * Start iteration over channel list
+ * @param context
+ * @param param input parameter
+ * @param list iterator state
+ * @return SCPI_EXPR_OK - param is channel list expression
+ *         SCPI_EXPR_ERROR - param is not channel list expression
+ */
+scpi_expr_result_t SCPI_ExprChannelListBegin(scpi_t * context, scpi_parameter_t * param, scpi_expr_channel_list_t * list) {
+    scpi_token_t token;
+
+    if (!param || !list) {
+        SCPI_ErrorPush(context, SCPI_ERROR_SYSTEM_ERROR);
+        return SCPI_EXPR_ERROR;
+    }
+
+    if (param->type != SCPI_TOKEN_PROGRAM_EXPRESSION) {
+        SCPI_ErrorPush(context, SCPI_ERROR_DATA_TYPE_ERROR);
+        return SCPI_EXPR_ERROR;
+    }
+
+    list->lex.buffer = param->ptr + 1;
+    list->lex.pos = list->lex.buffer;
+    list->lex.len = param->len - 2;
+    list->index = 0;
+
+    /* detect channel list expression */
+    if (!scpiLex_SpecificCharacter(&list->lex, &token, '@')) {
+        SCPI_ErrorPush(context, SCPI_ERROR_EXPRESSION_PARSING_ERROR);
+        return SCPI_EXPR_ERROR;
+    }
+
+    return SCPI_EXPR_OK;
+}
+
+/**
+ * Parse next entry of channel list e.g. "1!2:5!6", lexer position is kept
+ * in the iterator
+ * @param context
+ * @param list iterator state initialized by SCPI_ExprChannelListBegin
+ * @param isRange return true if it is range
+ * @param valuesFrom return array of values from
+ * @param valuesTo return array of values to
+ * @param length length of values arrays
+ * @param dimensions real number of dimensions
+ * @return SCPI_EXPR_OK - parsing was successful
+ *         SCPI_EXPR_ERROR - parser error
+ *         SCPI_EXPR_NO_MORE - no more data
+ */
+scpi_expr_result_t SCPI_ExprChannelListNext(scpi_t * context, scpi_expr_channel_list_t * list, scpi_bool_t * isRange, int32_t * valuesFrom, int32_t * valuesTo, const size_t length, size_t * dimensions) {
+    scpi_expr_result_t res;
+    scpi_token_t token;
+
+    if (!list || !isRange || !dimensions || (length && (!valuesFrom || !valuesTo))) {
+        SCPI_ErrorPush(context, SCPI_ERROR_SYSTEM_ERROR);
+        return SCPI_EXPR_ERROR;
+    }
+
+    if ((list->index > 0) && !scpiLex_Comma(&list->lex, &token)) {
+        res = scpiLex_IsEos(&list->lex) ? SCPI_EXPR_NO_MORE : SCPI_EXPR_ERROR;
+    } else {
+        res = channelRange(context, &list->lex, isRange, valuesFrom, valuesTo, length, dimensions);
+    }
+
+    if (res == SCPI_EXPR_OK) {
+        list->index++;
+    } else if (res == SCPI_EXPR_ERROR) {
+        SCPI_ErrorPush(context, SCPI_ERROR_EXPRESSION_PARSING_ERROR);
+    }
+    return res;
+}
+
 /**
  * Parse one list entry at specific position e.g. "1!2:5!6"
+ *
+ * Each call parses the list from its beginning, use SCPI_ExprChannelListBegin
+ * and SCPI_ExprChannelListNext to walk the whole list.
+ *
  * @param context
  * @param param
  * @param index
@@ -261,51 +498,650 @@ static scpi_expr_result_t channelRange(scpi_t * context, lex_state_t * state, sc
  * @param dimensions real number of dimensions
  */
 scpi_expr_result_t SCPI_ExprChannelListEntry(scpi_t * context, scpi_parameter_t * param, const int index, scpi_bool_t * isRange, int32_t * valuesFrom, int32_t * valuesTo, const size_t length, size_t * dimensions) {
-    lex_state_t lex;
-    scpi_expr_result_t res = SCPI_EXPR_OK;
-    scpi_token_t token;
+    scpi_expr_channel_list_t list;
+    scpi_expr_result_t res;
 
     if (!isRange || !param || !dimensions || (length && (!valuesFrom || !valuesTo))) {
         SCPI_ErrorPush(context, SCPI_ERROR_SYSTEM_ERROR);
         return SCPI_EXPR_ERROR;
     }
 
-    if (param->type != SCPI_TOKEN_PROGRAM_EXPRESSION) {
-        SCPI_ErrorPush(context, SCPI_ERROR_DATA_TYPE_ERROR);
-        return SCPI_EXPR_ERROR;
+    res = SCPI_ExprChannelListBegin(context, param, &list);
+    while ((res == SCPI_EXPR_OK) && (list.index <= index)) {
+        res = SCPI_ExprChannelListNext(context, &list, isRange, valuesFrom, valuesTo, (list.index == index) ? length : 0, dimensions);
     }
 
-    lex.buffer = param->ptr + 1;
-    lex.pos = lex.buffer;
-    lex.len = param->len - 2;
+    return res;
+}
 
-    /* detect channel list expression */
-    if (!scpiLex_SpecificCharacter(&lex, &token, '@')) {
-        SCPI_ErrorPush(context, SCPI_ERROR_EXPRESSION_PARSING_ERROR);
+/**
+ * Initialize compiled channel set
+ *
+ * One dimensional lists are stored in bitset of channels 0 to
+ * 32 * bits_length - 1, other lists in sorted array of ranges. One
+ * dimensional lists are stored as ranges, if bits_length is 0.
+ *
+ * @param set
+ * @param bits memory for bitset
+ * @param bits_length number of words in bits
+ * @param ranges memory for ranges
+ * @param ranges_length number of ranges
+ */
+void SCPI_ChannelSetInit(scpi_channel_set_t * set, uint32_t * bits, size_t bits_length, scpi_channel_range_t * ranges, size_t ranges_length) {
+    set->dimensions = 0;
+    set->bits = bits;
+    set->bits_length = bits ? bits_length : 0;
+    set->ranges = ranges;
+    set->ranges_length = ranges ? ranges_length : 0;
+    set->ranges_count = 0;
+}
+
+/**
+ * Compare first channels of two ranges
+ * @param a
+ * @param b
+ * @param dimensions
+ * @return negative, zero or positive value
+ */
+static int channelRangeCompare(const scpi_channel_range_t * a, const scpi_channel_range_t * b, size_t dimensions) {
+    size_t i;
+
+    for (i = 0; i < dimensions; i++) {
+        if (a->from[i] != b->from[i]) {
+            return (a->from[i] < b->from[i]) ? -1 : 1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * Add one list entry to compiled channel set
+ * @param set
+ * @param from first channel of entry
+ * @param to last channel of entry
+ * @return TRUE if there was space for the entry
+ */
+static scpi_bool_t channelSetAdd(scpi_channel_set_t * set, const int32_t * from, const int32_t * to) {
+    scpi_channel_range_t range;
+    uint64_t count = 1;
+    size_t pos;
+    size_t i;
+
+    if (set->dimensions == 1 && set->bits_length) {
+        int32_t lo = (from[0] < to[0]) ? from[0] : to[0];
+        int32_t hi = (from[0] < to[0]) ? to[0] : from[0];
+        if ((lo < 0) || ((uint64_t) hi >= 32 * (uint64_t) set->bits_length)) {
+            return FALSE;
+        }
+        for (; lo <= hi; lo++) {
+            set->bits[lo / 32] |= 1ul << (lo % 32);
+        }
+        return TRUE;
+    }
+
+    if (set->ranges_count >= set->ranges_length) {
+        return FALSE;
+    }
+
+    /* strides of the last dimension are 1, so channels are ordered
+     * from the first dimension */
+    for (i = set->dimensions; i-- > 0;) {
+        range.from[i] = (from[i] < to[i]) ? from[i] : to[i];
+        range.to[i] = (from[i] < to[i]) ? to[i] : from[i];
+        range.stride[i] = (uint32_t) count;
+        count *= (uint64_t) ((int64_t) range.to[i] - range.from[i] + 1);
+        if (count > UINT32_MAX) {
+            return FALSE;
+        }
+    }
+    range.count = (uint32_t) count;
+
+    /* insert sorted by first channel */
+    pos = set->ranges_count;
+    while ((pos > 0) && (channelRangeCompare(&set->ranges[pos - 1], &range, set->dimensions) > 0)) {
+        set->ranges[pos] = set->ranges[pos - 1];
+        pos--;
+    }
+    set->ranges[pos] = range;
+    set->ranges_count++;
+
+    return TRUE;
+}
+
+/**
+ * Compile channel list in one pass to channel set
+ *
+ * All entries of the list must have the same number of dimensions. Ranges
+ * of more dimensions contain all channels between from and to in each
+ * dimension, e.g. (@1!1:2!2) contains 1!1, 1!2, 2!1 and 2!2.
+ *
+ * @param context
+ * @param param input parameter
+ * @param set channel set initialized by SCPI_ChannelSetInit
+ * @return SCPI_EXPR_OK - parsing was successful
+ *         SCPI_EXPR_ERROR - parser error or channel set is too small
+ */
+scpi_expr_result_t SCPI_ExprChannelListCompile(scpi_t * context, scpi_parameter_t * param, scpi_channel_set_t * set) {
+    scpi_expr_channel_list_t list;
+    scpi_expr_result_t res;
+    scpi_bool_t isRange;
+    int32_t from[SCPI_CHANNEL_DIMENSIONS];
+    int32_t to[SCPI_CHANNEL_DIMENSIONS];
+    size_t dimensions;
+    size_t i;
+
+    if (!set) {
+        SCPI_ErrorPush(context, SCPI_ERROR_SYSTEM_ERROR);
         return SCPI_EXPR_ERROR;
     }
 
-    for (int i = 0; i <= index; i++) {
-        res = channelRange(context, &lex, isRange, valuesFrom, valuesTo, (i == index) ? length : 0, dimensions);
+    set->dimensions = 0;
+    set->ranges_count = 0;
+    for (i = 0; i < set->bits_length; i++) {
+        set->bits[i] = 0;
+    }
+
+    res = SCPI_ExprChannelListBegin(context, param, &list);
+    while (res == SCPI_EXPR_OK) {
+        res = SCPI_ExprChannelListNext(context, &list, &isRange, from, to, SCPI_CHANNEL_DIMENSIONS, &dimensions);
         if (res != SCPI_EXPR_OK) {
             break;
         }
-        if (i != index) {
-            if (!scpiLex_Comma(&lex, &token)) {
-                res = scpiLex_IsEos(&lex) ? SCPI_EXPR_NO_MORE : SCPI_EXPR_ERROR;
+
+        if ((dimensions > SCPI_CHANNEL_DIMENSIONS) || (set->dimensions && (set->dimensions != dimensions))) {
+            SCPI_ErrorPush(context, SCPI_ERROR_EXPRESSION_PARSING_ERROR);
+            return SCPI_EXPR_ERROR;
+        }
+        set->dimensions = dimensions;
+
+        if (!channelSetAdd(set, from, isRange ? to : from)) {
+            SCPI_ErrorPush(context, SCPI_ERROR_DATA_OUT_OF_RANGE);
+            return SCPI_EXPR_ERROR;
+        }
+    }
+
+    return (res == SCPI_EXPR_NO_MORE) ? SCPI_EXPR_OK : res;
+}
+
+/**
+ * Test if channel is in compiled channel set
+ * @param set
+ * @param channel values of channel in each dimension
+ * @param dimensions number of values in channel
+ * @return TRUE if the channel is in the set
+ */
+scpi_bool_t SCPI_ChannelSetContains(const scpi_channel_set_t * set, const int32_t * channel, size_t dimensions) {
+    const scpi_channel_range_t * range;
+    size_t r;
+    size_t i;
+
+    if (!set || !channel || !set->dimensions || (dimensions != set->dimensions)) {
+        return FALSE;
+    }
+
+    if (set->dimensions == 1 && set->bits_length) {
+        if ((channel[0] < 0) || ((uint64_t) channel[0] >= 32 * (uint64_t) set->bits_length)) {
+            return FALSE;
+        }
+        return (set->bits[channel[0] / 32] >> (channel[0] % 32)) & 1 ? TRUE : FALSE;
+    }
+
+    /* ranges are sorted by the first dimension */
+    for (r = 0; (r < set->ranges_count) && (set->ranges[r].from[0] <= channel[0]); r++) {
+        range = &set->ranges[r];
+        for (i = 0; i < dimensions; i++) {
+            if ((channel[i] < range->from[i]) || (channel[i] > range->to[i])) {
                 break;
             }
         }
+        if (i == dimensions) {
+            return TRUE;
+        }
     }
 
-    if (res == SCPI_EXPR_ERROR) {
-        SCPI_ErrorPush(context, SCPI_ERROR_EXPRESSION_PARSING_ERROR);
+    return FALSE;
+}
+
+/**
+ * Start iteration over compiled channel set
+ * @param set
+ * @param iterator
+ */
+void SCPI_ChannelSetBegin(const scpi_channel_set_t * set, scpi_channel_iterator_t * iterator) {
+    (void) set;
+
+    iterator->range = 0;
+    iterator->offset = 0;
+}
+
+/**
+ * Get next channel of compiled channel set
+ *
+ * Channels of bitset are returned in ascending order. Ranges are returned
+ * ordered by their first channel (ranges with the same first channel in
+ * order of the list), channels of each range in ascending order with the
+ * last dimension changing fastest. Channels of overlapping ranges are
+ * returned once for each range.
+ *
+ * @param set
+ * @param iterator iterator initialized by SCPI_ChannelSetBegin
+ * @param channel return values of channel, set->dimensions values
+ * @return TRUE if channel was returned, FALSE at the end of the set
+ */
+scpi_bool_t SCPI_ChannelSetNext(const scpi_channel_set_t * set, scpi_channel_iterator_t * iterator, int32_t * channel) {
+    const scpi_channel_range_t * range;
+    uint32_t offset;
+    size_t i;
+
+    if (!set || !iterator || !channel || !set->dimensions) {
+        return FALSE;
     }
-    if (res == SCPI_EXPR_NO_MORE) {
-        if (!scpiLex_IsEos(&lex)) {
-            res = SCPI_EXPR_ERROR;
-            SCPI_ErrorPush(context, SCPI_ERROR_EXPRESSION_PARSING_ERROR);
+
+    if (set->dimensions == 1 && set->bits_length) {
+        /* range is index of word, offset is index of bit */
+        for (; iterator->range < set->bits_length; iterator->range++, iterator->offset = 0) {
+            uint32_t word;
+            if (iterator->offset >= 32) {
+                /* last bit of the word was returned, shift by 32 is undefined */
+                continue;
+            }
+            word = set->bits[iterator->range] >> iterator->offset;
+            for (; word && (iterator->offset < 32); iterator->offset++, word >>= 1) {
+                if (word & 1) {
+                    channel[0] = (int32_t) (iterator->range * 32 + iterator->offset);
+                    iterator->offset++;
+                    return TRUE;
+                }
+            }
         }
+        return FALSE;
     }
-    return res;
+
+    if (iterator->range >= set->ranges_count) {
+        return FALSE;
+    }
+
+    range = &set->ranges[iterator->range];
+    offset = iterator->offset;
+    for (i = 0; i < set->dimensions; i++) {
+        channel[i] = range->from[i] + (int32_t) (offset / range->stride[i]);
+        offset %= range->stride[i];
+    }
+
+    iterator->offset++;
+    if (iterator->offset >= range->count) {
+        iterator->range++;
+        iterator->offset = 0;
+    }
+    return TRUE;
+}
+
+#if USE_EXPRESSION_EVAL
+
+/* bytecode of compiled expression, EXPR_OP_CONSTANT is followed by index */
+enum {
+    EXPR_OP_LITERAL,
+    EXPR_OP_CONSTANT,
+    EXPR_OP_NEG,
+    EXPR_OP_ADD,
+    EXPR_OP_SUB,
+    EXPR_OP_MUL,
+    EXPR_OP_DIV,
+};
+
+static const scpi_expr_constant_t exprBuiltinConstants[] = {
+    {"PI", 3.14159265358979323846},
+    {"E", 2.71828182845904523536},
+    SCPI_EXPR_CONSTANTS_END
+};
+
+struct _scpi_expr_compiler_t {
+    const scpi_expr_constant_t * constants;
+    lex_state_t lex;
+    scpi_expr_code_t * code;
+    int depth;
+};
+typedef struct _scpi_expr_compiler_t scpi_expr_compiler_t;
+
+/**
+ * Append one byte of bytecode
+ * @param compiler
+ * @param op operation or its argument
+ * @param push number of values pushed to stack by operation, -1 for binary operations
+ * @return FALSE if expression is too complex
+ */
+static scpi_bool_t exprEmit(scpi_expr_compiler_t * compiler, uint8_t op, int push) {
+    if (compiler->code->length >= SCPI_EXPR_CODE_LENGTH) {
+        return FALSE;
+    }
+    compiler->code->op[compiler->code->length++] = op;
+    compiler->depth += push;
+    return compiler->depth <= SCPI_EXPR_STACK_SIZE ? TRUE : FALSE;
+}
+
+/**
+ * Find constant by name
+ * @param constants list terminated by SCPI_EXPR_CONSTANTS_END
+ * @param name
+ * @param len
+ * @return index of constant or -1
+ */
+static int exprFindConstant(const scpi_expr_constant_t * constants, const char * name, size_t len) {
+    int i;
+
+    if (!constants) {
+        return -1;
+    }
+
+    for (i = 0; constants[i].name; i++) {
+        if (compareStr(constants[i].name, strlen(constants[i].name), name, len)) {
+            return i;
+        }
+    }
+    return -1;
 }
+
+/**
+ * Compile number, constant or its negation
+ * @param compiler
+ * @return TRUE if successful
+ */
+static scpi_bool_t exprFactor(scpi_expr_compiler_t * compiler) {
+    scpi_expr_code_t * code = compiler->code;
+    scpi_bool_t negate = FALSE;
+    scpi_token_t token;
+    double value;
+    int index;
+
+    for (;;) {
+        scpiLex_WhiteSpace(&compiler->lex, &token);
+        if (scpiLex_SpecificCharacter(&compiler->lex, &token, '-')) {
+            negate = !negate;
+        } else if (!scpiLex_SpecificCharacter(&compiler->lex, &token, '+')) {
+            break;
+        }
+    }
+
+    if (scpiLex_DecimalNumericProgramData(&compiler->lex, &token)) {
+        if ((strToDouble(token.ptr, token.len, &value) == 0) || (code->literals >= sizeof (code->literal) / sizeof (code->literal[0]))) {
+            return FALSE;
+        }
+        code->literal[code->literals++] = value;
+        if (!exprEmit(compiler, EXPR_OP_LITERAL, 1)) {
+            return FALSE;
+        }
+    } else if (scpiLex_CharacterProgramData(&compiler->lex, &token)) {
+        index = exprFindConstant(compiler->constants, token.ptr, token.len);
+        if ((index >= 0) && (index <= UINT8_MAX)) {
+            if (!exprEmit(compiler, EXPR_OP_CONSTANT, 1) || !exprEmit(compiler, (uint8_t) index, 0)) {
+                return FALSE;
+            }
+        } else {
+            index = exprFindConstant(exprBuiltinConstants, token.ptr, token.len);
+            if ((index < 0) || (code->literals >= sizeof (code->literal) / sizeof (code->literal[0]))) {
+                return FALSE;
+            }
+            code->literal[code->literals++] = exprBuiltinConstants[index].value;
+            if (!exprEmit(compiler, EXPR_OP_LITERAL, 1)) {
+                return FALSE;
+            }
+        }
+    } else {
+        return FALSE;
+    }
+
+    return negate ? exprEmit(compiler, EXPR_OP_NEG, 0) : TRUE;
+}
+
+/**
+ * Compile product or quotient of factors
+ * @param compiler
+ * @return TRUE if successful
+ */
+static scpi_bool_t exprTerm(scpi_expr_compiler_t * compiler) {
+    scpi_token_t token;
+    uint8_t op;
+
+    if (!exprFactor(compiler)) {
+        return FALSE;
+    }
+
+    for (;;) {
+        scpiLex_WhiteSpace(&compiler->lex, &token);
+        if (scpiLex_SpecificCharacter(&compiler->lex, &token, '*')) {
+            op = EXPR_OP_MUL;
+        } else if (scpiLex_SpecificCharacter(&compiler->lex, &token, '/')) {
+            op = EXPR_OP_DIV;
+        } else {
+            return TRUE;
+        }
+
+        if (!exprFactor(compiler) || !exprEmit(compiler, op, -1)) {
+            return FALSE;
+        }
+    }
+}
+
+/**
+ * Compile sum or difference of terms
+ * @param compiler
+ * @return TRUE if successful
+ */
+static scpi_bool_t exprSum(scpi_expr_compiler_t * compiler) {
+    scpi_token_t token;
+    uint8_t op;
+
+    if (!exprTerm(compiler)) {
+        return FALSE;
+    }
+
+    for (;;) {
+        scpiLex_WhiteSpace(&compiler->lex, &token);
+        if (scpiLex_SpecificCharacter(&compiler->lex, &token, '+')) {
+            op = EXPR_OP_ADD;
+        } else if (scpiLex_SpecificCharacter(&compiler->lex, &token, '-')) {
+            op = EXPR_OP_SUB;
+        } else {
+            return TRUE;
+        }
+
+        if (!exprTerm(compiler) || !exprEmit(compiler, op, -1)) {
+            return FALSE;
+        }
+    }
+}
+
+/**
+ * Set list of named constants usable in expressions, e.g. VOLT_MAX
+ *
+ * Compiled expressions refer to constants by index in the list given at the
+ * time of compilation and values are read during evaluation, so values may
+ * be changed later, but the list must stay valid. Compiled expressions
+ * cached in the context are dropped.
+ *
+ * @param context
+ * @param constants list terminated by SCPI_EXPR_CONSTANTS_END or NULL
+ */
+void SCPI_ExprSetConstants(scpi_t * context, const scpi_expr_constant_t * constants) {
+    size_t i;
+
+    context->expr_constants = constants;
+    for (i = 0; i < SCPI_EXPR_CACHE_COUNT; i++) {
+        context->expr_cache[i].code.length = 0;
+    }
+}
+
+/**
+ * Compile arithmetic expression e.g. (2*PI*1E3) to bytecode
+ *
+ * Expression consists of decimal numbers, constants set by
+ * SCPI_ExprSetConstants, built-in constants PI and E, unary + and -
+ * and binary +, -, * and / with usual precedence.
+ *
+ * @param context
+ * @param param input parameter
+ * @param code compiled expression
+ * @return SCPI_EXPR_OK - compilation was successful
+ *         SCPI_EXPR_ERROR - param is not valid or too complex expression
+ */
+scpi_expr_result_t SCPI_ExprCompile(scpi_t * context, scpi_parameter_t * param, scpi_expr_code_t * code) {
+    scpi_expr_compiler_t compiler;
+    scpi_token_t token;
+
+    if (!param || !code) {
+        SCPI_ErrorPush(context, SCPI_ERROR_SYSTEM_ERROR);
+        return SCPI_EXPR_ERROR;
+    }
+
+    if (param->type != SCPI_TOKEN_PROGRAM_EXPRESSION) {
+        SCPI_ErrorPush(context, SCPI_ERROR_DATA_TYPE_ERROR);
+        return SCPI_EXPR_ERROR;
+    }
+
+    compiler.constants = context->expr_constants;
+    compiler.lex.buffer = param->ptr + 1;
+    compiler.lex.pos = compiler.lex.buffer;
+    compiler.lex.len = param->len - 2;
+    compiler.code = code;
+    compiler.depth = 0;
+
+    code->constants = context->expr_constants;
+    code->length = 0;
+    code->literals = 0;
+
+    if (exprSum(&compiler)) {
+        scpiLex_WhiteSpace(&compiler.lex, &token);
+        if (scpiLex_IsEos(&compiler.lex)) {
+            return SCPI_EXPR_OK;
+        }
+    }
+
+    code->length = 0;
+    SCPI_ErrorPush(context, SCPI_ERROR_EXPRESSION_PARSING_ERROR);
+    return SCPI_EXPR_ERROR;
+}
+
+/**
+ * Evaluate compiled expression, values of constants are read from the list,
+ * which was set by SCPI_ExprSetConstants when the expression was compiled
+ * @param context
+ * @param code expression compiled by SCPI_ExprCompile
+ * @param value result
+ * @return SCPI_EXPR_OK - evaluation was successful
+ *         SCPI_EXPR_ERROR - result is not finite number
+ */
+scpi_expr_result_t SCPI_ExprEval(scpi_t * context, const scpi_expr_code_t * code, double * value) {
+    double stack[SCPI_EXPR_STACK_SIZE];
+    size_t sp = 0;
+    size_t literal = 0;
+    size_t pc;
+
+    if (!code || !value || !code->length) {
+        SCPI_ErrorPush(context, SCPI_ERROR_SYSTEM_ERROR);
+        return SCPI_EXPR_ERROR;
+    }
+
+    for (pc = 0; pc < code->length; pc++) {
+        switch (code->op[pc]) {
+            case EXPR_OP_LITERAL:
+                stack[sp++] = code->literal[literal++];
+                break;
+            case EXPR_OP_CONSTANT:
+                stack[sp++] = code->constants[code->op[++pc]].value;
+                break;
+            case EXPR_OP_NEG:
+                stack[sp - 1] = -stack[sp - 1];
+                break;
+            case EXPR_OP_ADD:
+                sp--;
+                stack[sp - 1] += stack[sp];
+                break;
+            case EXPR_OP_SUB:
+                sp--;
+                stack[sp - 1] -= stack[sp];
+                break;
+            case EXPR_OP_MUL:
+                sp--;
+                stack[sp - 1] *= stack[sp];
+                break;
+            case EXPR_OP_DIV:
+                sp--;
+                stack[sp - 1] /= stack[sp];
+                break;
+            default:
+                SCPI_ErrorPush(context, SCPI_ERROR_SYSTEM_ERROR);
+                return SCPI_EXPR_ERROR;
+        }
+    }
+
+    /* division by zero or overflow */
+    if (!(stack[0] >= -DBL_MAX && stack[0] <= DBL_MAX)) {
+        SCPI_ErrorPush(context, SCPI_ERROR_DATA_OUT_OF_RANGE);
+        return SCPI_EXPR_ERROR;
+    }
+
+    *value = stack[0];
+    return SCPI_EXPR_OK;
+}
+
+/**
+ * Evaluate arithmetic expression e.g. (VOLT_MAX/2)
+ *
+ * Compiled expressions are cached in the context, so repeated commands
+ * with the same expression are compiled only once.
+ *
+ * @param context
+ * @param param input parameter
+ * @param value result
+ * @return SCPI_EXPR_OK - evaluation was successful
+ *         SCPI_EXPR_ERROR - param is not valid expression or result is not finite
+ */
+scpi_expr_result_t SCPI_ExprEvalDouble(scpi_t * context, scpi_parameter_t * param, double * value) {
+    scpi_expr_cache_t * entry;
+    scpi_expr_code_t code;
+    const char * text;
+    size_t len;
+    uint32_t hash;
+    size_t i;
+
+    if (!param || !value) {
+        SCPI_ErrorPush(context, SCPI_ERROR_SYSTEM_ERROR);
+        return SCPI_EXPR_ERROR;
+    }
+
+    if (param->type != SCPI_TOKEN_PROGRAM_EXPRESSION) {
+        SCPI_ErrorPush(context, SCPI_ERROR_DATA_TYPE_ERROR);
+        return SCPI_EXPR_ERROR;
+    }
+
+    text = param->ptr + 1;
+    len = param->len - 2;
+
+    if (len > SCPI_EXPR_CACHE_TEXT_LENGTH) {
+        if (SCPI_ExprCompile(context, param, &code) != SCPI_EXPR_OK) {
+            return SCPI_EXPR_ERROR;
+        }
+        return SCPI_ExprEval(context, &code, value);
+    }
+
+    hash = strHashCase(text, len);
+    for (i = 0; i < SCPI_EXPR_CACHE_COUNT; i++) {
+        entry = &context->expr_cache[i];
+        if (entry->code.length && (entry->hash == hash) && compareStr(entry->text, entry->text_len, text, len)) {
+            return SCPI_ExprEval(context, &entry->code, value);
+        }
+    }
+
+    entry = &context->expr_cache[context->expr_cache_next];
+    if (SCPI_ExprCompile(context, param, &entry->code) != SCPI_EXPR_OK) {
+        return SCPI_EXPR_ERROR;
+    }
+    context->expr_cache_next = (uint8_t) ((context->expr_cache_next + 1) % SCPI_EXPR_CACHE_COUNT);
+    entry->hash = hash;
+    entry->text_len = (uint8_t) len;
+    memcpy(entry->text, text, len);
+
+    return SCPI_ExprEval(context, &entry->code, value);
+}
+
+#endif /* USE_EXPRESSION_EVAL */
@@ -27,6 +27,210 @@
  */
 
 #include "fifo_private.h"
+#include "scpi/error.h"
+
+#if USE_ERROR_QUEUE_LOCKFREE
+
+/*
+ * Bounded queue with sequence number in each entry. Producers reserve
+ * position by compare and swap of wr, then write the entry and publish it by
+ * its sequence number. Only one consumer may remove entries.
+ *
+ * sequence == position     entry is free for producer of this position
+ * sequence == position + 1 entry is published for consumer of this position
+ */
+#define FIFO_LOAD(p)            __atomic_load_n((p), __ATOMIC_ACQUIRE)
+#define FIFO_STORE(p, v)        __atomic_store_n((p), (v), __ATOMIC_RELEASE)
+#define FIFO_CAS(p, e, d)       __atomic_compare_exchange_n((p), (e), (d), 0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)
+
+#define FIFO_OVERFLOW_FLAG      0x10000ul
+
+/**
+ * Copy content of entry without its sequence number
+ * @param dst
+ * @param src
+ */
+static void fifo_copy(scpi_error_t * dst, const scpi_error_t * src) {
+    dst->error_code = src->error_code;
+#if USE_DEVICE_DEPENDENT_ERROR_INFORMATION
+    dst->device_dependent_info = src->device_dependent_info;
+#endif
+}
+
+/**
+ * Initialize fifo
+ * @param fifo
+ * @param data - memory for fifo
+ * @param size - size of data, rounded down to power of two
+ */
+void fifo_init(scpi_fifo_t * fifo, scpi_error_t * data, const int16_t size) {
+    int16_t i;
+
+    fifo->size = 1;
+    while ((fifo->size <= INT16_MAX / 2) && (fifo->size * 2 <= size)) {
+        fifo->size *= 2;
+    }
+    if (size < 2) {
+        fifo->size = 0;
+    }
+    fifo->data = data;
+
+    for (i = 0; i < fifo->size; i++) {
+        data[i].sequence = (uint16_t) i;
+    }
+
+    fifo->wr = 0;
+    fifo->rd = 0;
+    fifo->overflow = 0;
+}
+
+/**
+ * Retrieve number of elements in fifo including elements which are just
+ * being added
+ * @param fifo
+ * @param value
+ * @return
+ */
+scpi_bool_t fifo_count(const scpi_fifo_t * fifo, int16_t * value) {
+    uint16_t count = (uint16_t) (FIFO_LOAD(&fifo->wr) - FIFO_LOAD(&fifo->rd));
+
+    *value = (count > (uint16_t) fifo->size) ? fifo->size : (int16_t) count;
+    return TRUE;
+}
+
+/**
+ * Test if fifo is empty
+ * @param fifo
+ * @return
+ */
+scpi_bool_t fifo_is_empty(const scpi_fifo_t * fifo) {
+    int16_t count;
+
+    fifo_count(fifo, &count);
+    return count == 0;
+}
+
+/**
+ * Test if fifo is full
+ * @param fifo
+ * @return
+ */
+scpi_bool_t fifo_is_full(const scpi_fifo_t * fifo) {
+    int16_t count;
+
+    fifo_count(fifo, &count);
+    return count == fifo->size;
+}
+
+/**
+ * Add element to fifo. If fifo is full, return FALSE. Can be called
+ * concurrently from more producers.
+ * @param fifo - fifo to add to
+ * @param value - value to add
+ * @return
+ */
+scpi_bool_t fifo_add(scpi_fifo_t * fifo, const scpi_error_t * value) {
+    const uint16_t mask = (uint16_t) (fifo->size - 1);
+    scpi_error_t * entry;
+    uint16_t pos;
+    int16_t diff;
+
+    if (!value || (fifo->size == 0)) {
+        return FALSE;
+    }
+
+    pos = FIFO_LOAD(&fifo->wr);
+    for (;;) {
+        entry = &fifo->data[pos & mask];
+        diff = (int16_t) (FIFO_LOAD(&entry->sequence) - pos);
+        if (diff == 0) {
+            if (FIFO_CAS(&fifo->wr, &pos, (uint16_t) (pos + 1))) {
+                break;
+            }
+        } else if (diff < 0) {
+            /* FIFO full */
+            return FALSE;
+        } else {
+            pos = FIFO_LOAD(&fifo->wr);
+        }
+    }
+
+    fifo_copy(entry, value);
+    FIFO_STORE(&entry->sequence, (uint16_t) (pos + 1));
+    return TRUE;
+}
+
+/**
+ * Mark last element of full fifo to be replaced by queue overflow, when it
+ * is removed. Pending mark is kept until its element is removed. If the
+ * consumer removes the last element meanwhile, the overflow is lost.
+ * @param fifo
+ */
+void fifo_mark_overflow(scpi_fifo_t * fifo) {
+    uint16_t last = (uint16_t) (FIFO_LOAD(&fifo->wr) - 1);
+    uint32_t overflow = FIFO_LOAD(&fifo->overflow);
+
+    do {
+        if (overflow && ((int16_t) ((uint16_t) overflow - FIFO_LOAD(&fifo->rd)) >= 0)) {
+            return;
+        }
+    } while (!FIFO_CAS(&fifo->overflow, &overflow, FIFO_OVERFLOW_FLAG | last));
+}
+
+/**
+ * Remove element form fifo. Only one consumer may call it.
+ * @param fifo
+ * @param value
+ * @return FALSE - fifo is empty
+ */
+scpi_bool_t fifo_remove(scpi_fifo_t * fifo, scpi_error_t * value) {
+    const uint16_t mask = (uint16_t) (fifo->size - 1);
+    const uint16_t pos = fifo->rd;
+    scpi_error_t * entry;
+    uint32_t overflow;
+
+    if (fifo->size == 0) {
+        return FALSE;
+    }
+
+    entry = &fifo->data[pos & mask];
+    if (FIFO_LOAD(&entry->sequence) != (uint16_t) (pos + 1)) {
+        /* FIFO empty or first element is not yet written */
+        return FALSE;
+    }
+
+    if (value) {
+        fifo_copy(value, entry);
+    }
+
+    overflow = FIFO_LOAD(&fifo->overflow);
+    if (overflow) {
+        int16_t diff = (int16_t) ((uint16_t) overflow - pos);
+        if ((diff == 0) && value) {
+            value->error_code = SCPI_ERROR_QUEUE_OVERFLOW;
+        }
+        if (diff <= 0) {
+            FIFO_CAS(&fifo->overflow, &overflow, 0);
+        }
+    }
+
+    FIFO_STORE(&entry->sequence, (uint16_t) (pos + fifo->size));
+    FIFO_STORE(&fifo->rd, (uint16_t) (pos + 1));
+
+    return TRUE;
+}
+
+/**
+ * Empty fifo. Only the consumer may call it.
+ * @param fifo
+ */
+void fifo_clear(scpi_fifo_t * fifo) {
+    while (fifo_remove(fifo, NULL)) {
+        /* remove all published elements */
+    }
+}
+
+#else
 
 /**
  * Initialize fifo
@@ -145,3 +349,5 @@ scpi_bool_t fifo_count(const scpi_fifo_t * fifo, int16_t * value) {
     *value = fifo->count;
     return TRUE;
 }
+
+#endif
@@ -51,7 +51,11 @@ extern "C" {
     scpi_bool_t fifo_is_full(const scpi_fifo_t * fifo) LOCAL;
     scpi_bool_t fifo_add(scpi_fifo_t * fifo, const scpi_error_t * value) LOCAL;
     scpi_bool_t fifo_remove(scpi_fifo_t * fifo, scpi_error_t * value) LOCAL;
+#if USE_ERROR_QUEUE_LOCKFREE
+    void fifo_mark_overflow(scpi_fifo_t * fifo) LOCAL;
+#else
     scpi_bool_t fifo_remove_last(scpi_fifo_t * fifo, scpi_error_t * value) LOCAL;
+#endif
     scpi_bool_t fifo_count(const scpi_fifo_t * fifo, int16_t * value) LOCAL;
 
 #ifdef	__cplusplus
@@ -111,6 +111,12 @@ static const scpi_reg_group_info_t scpi_reg_group_details[SCPI_REG_GROUP_COUNT]
 
 };
 
+#if USE_REGISTER_ATOMIC
+#define REG_LOAD(c, n)          __atomic_load_n(&(c)->registers[(n)], __ATOMIC_ACQUIRE)
+#define REG_CAS(c, n, e, d)     __atomic_compare_exchange_n(&(c)->registers[(n)], (e), (d), 0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)
+#define REG_ALL_BITS            ((scpi_reg_val_t) ~0)
+#endif
+
 /**
  * Get register value
  * @param context
@@ -119,7 +125,11 @@ static const scpi_reg_group_info_t scpi_reg_group_details[SCPI_REG_GROUP_COUNT]
  */
 scpi_reg_val_t SCPI_RegGet(const scpi_t * context, const scpi_reg_name_t name) {
     if ((name < SCPI_REG_COUNT) && context) {
+#if USE_REGISTER_ATOMIC
+        return REG_LOAD(context, name);
+#else
         return context->registers[name];
+#endif
     } else {
         return 0;
     }
@@ -139,6 +149,306 @@ static size_t writeControl(scpi_t * context, const scpi_ctrl_name_t ctrl, const
     }
 }
 
+#if USE_REGISTER_SUBSCRIPTIONS
+
+/**
+ * Subscribe callback to transitions of register bits
+ *
+ * Callback is called from SCPI_RegSet and related functions with the
+ * transitioned bits and the new register value, after the register is
+ * changed and before the change is propagated to its parent.
+ *
+ * @param context
+ * @param name - register name
+ * @param mask - watched bits
+ * @param edge - rising, falling or both transitions
+ * @param callback
+ * @param user - user data passed to the callback
+ * @return handle of subscription or -1 if there is no free slot
+ */
+int SCPI_RegSubscribe(scpi_t * context, scpi_reg_name_t name, scpi_reg_val_t mask, scpi_reg_edge_t edge, scpi_reg_callback_t callback, void * user) {
+    int i;
+
+    if (!context || !callback || (name >= SCPI_REG_COUNT) || !mask) {
+        return -1;
+    }
+
+    for (i = 0; i < SCPI_REG_SUBSCRIPTION_COUNT; i++) {
+        scpi_reg_subscription_t * subscription = &context->reg_subscriptions[i];
+        if (!subscription->callback) {
+            subscription->name = name;
+            subscription->mask = mask;
+            subscription->edge = edge;
+            subscription->user = user;
+            subscription->callback = callback;
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+/**
+ * Remove subscription
+ * @param context
+ * @param handle - handle returned by SCPI_RegSubscribe
+ */
+void SCPI_RegUnsubscribe(scpi_t * context, int handle) {
+    if (context && (handle >= 0) && (handle < SCPI_REG_SUBSCRIPTION_COUNT)) {
+        context->reg_subscriptions[handle].callback = NULL;
+    }
+}
+
+/**
+ * Call subscribed callbacks for transitions of register
+ * @param context
+ * @param name - register name
+ * @param old_val - value before the change
+ * @param val - value after the change
+ */
+static void regNotify(scpi_t * context, scpi_reg_name_t name, scpi_reg_val_t old_val, scpi_reg_val_t val) {
+    const scpi_reg_subscription_t * subscription;
+    scpi_reg_val_t bits;
+    int i;
+
+    if (old_val == val) {
+        return;
+    }
+
+    for (i = 0; i < SCPI_REG_SUBSCRIPTION_COUNT; i++) {
+        subscription = &context->reg_subscriptions[i];
+        if (!subscription->callback || (subscription->name != name)) {
+            continue;
+        }
+
+        bits = 0;
+        if (subscription->edge & SCPI_REG_EDGE_RISING) {
+            bits |= ~old_val & val;
+        }
+        if (subscription->edge & SCPI_REG_EDGE_FALLING) {
+            bits |= old_val & ~val;
+        }
+        bits &= subscription->mask;
+
+        if (bits) {
+            subscription->callback(context, name, bits, val, subscription->user);
+        }
+    }
+}
+#else
+#define regNotify(context, name, old_val, val)
+#endif /* USE_REGISTER_SUBSCRIPTIONS */
+
+/**
+ * Replace masked bits of register without propagation of the change
+ * @param context
+ * @param name - register name
+ * @param mask - bits to replace
+ * @param bits - new value of masked bits
+ * @return register value before the change
+ */
+static scpi_reg_val_t regReplaceBits(scpi_t * context, scpi_reg_name_t name, scpi_reg_val_t mask, scpi_reg_val_t bits) {
+#if USE_REGISTER_ATOMIC
+    scpi_reg_val_t old_val = REG_LOAD(context, name);
+
+    while ((((old_val & ~mask) | (bits & mask)) != old_val)
+            && !REG_CAS(context, name, &old_val, (scpi_reg_val_t) ((old_val & ~mask) | (bits & mask)))) {
+    }
+#else
+    const scpi_reg_val_t old_val = context->registers[name];
+
+    context->registers[name] = (scpi_reg_val_t) ((old_val & ~mask) | (bits & mask));
+#endif
+    regNotify(context, name, old_val, (scpi_reg_val_t) ((old_val & ~mask) | (bits & mask)));
+    return old_val;
+}
+
+/**
+ * Events latched by change of condition register, filtered by PTR/NTR
+ * registers of the group
+ * @param context
+ * @param group - register group of the condition register
+ * @param old_val - condition before the change
+ * @param val - condition after the change
+ * @return bits to set in event register
+ */
+static scpi_reg_val_t regTransitions(const scpi_t * context, const scpi_reg_group_info_t * group, scpi_reg_val_t old_val, scpi_reg_val_t val) {
+    const scpi_reg_val_t ptrans = (old_val ^ val) & val;
+    const scpi_reg_val_t ntrans = (old_val ^ val) & old_val;
+    scpi_reg_val_t events = 0;
+
+    if (group->ptfilt == SCPI_REG_NONE && group->ntfilt == SCPI_REG_NONE) {
+        return ptrans;
+    }
+
+    if (group->ptfilt != SCPI_REG_NONE) {
+        events |= ptrans & SCPI_RegGet(context, group->ptfilt);
+    }
+    if (group->ntfilt != SCPI_REG_NONE) {
+        events |= ntrans & SCPI_RegGet(context, group->ntfilt);
+    }
+    return events;
+}
+
+/**
+ * Summary bit of register group from its event and enable registers
+ * @param context
+ * @param group - register group
+ * @return parent_bit or 0
+ */
+static scpi_reg_val_t regGroupSummary(const scpi_t * context, const scpi_reg_group_info_t * group) {
+    scpi_reg_val_t enable;
+
+    if (group->enable != SCPI_REG_NONE) {
+        enable = SCPI_RegGet(context, group->enable);
+    } else {
+        enable = 0xFFFF;
+    }
+
+    return (SCPI_RegGet(context, group->event) & enable) ? group->parent_bit : 0;
+}
+
+#if USE_REGISTER_ATOMIC
+
+static scpi_reg_val_t regUpdate(scpi_t * context, scpi_reg_name_t name, scpi_reg_val_t mask, scpi_reg_val_t bits);
+
+/**
+ * Update service request bit of STB from current STB and SRE
+ *
+ * Control message is sent only by the caller, which changed the bit
+ * from 0 to 1, so it is sent exactly once for each rising edge.
+ * @param context
+ */
+static void regServiceRequest(scpi_t * context) {
+    scpi_reg_val_t stb = REG_LOAD(context, SCPI_REG_STB);
+    scpi_reg_val_t srq;
+
+    for (;;) {
+        srq = (stb & REG_LOAD(context, SCPI_REG_SRE) & ~STB_SRQ) ? STB_SRQ : 0;
+        if ((stb & STB_SRQ) == srq) {
+            return;
+        }
+        if (REG_CAS(context, SCPI_REG_STB, &stb, stb ^ STB_SRQ)) {
+            regNotify(context, SCPI_REG_STB, stb, stb ^ STB_SRQ);
+            if (srq) {
+                writeControl(context, SCPI_CTRL_SRQ, stb ^ STB_SRQ);
+            }
+            stb = REG_LOAD(context, SCPI_REG_STB);
+        }
+    }
+}
+
+/**
+ * Update summary bit of register group in its parent register from current
+ * event and enable registers
+ * @param context
+ * @param group - register group
+ */
+static void regSummary(scpi_t * context, const scpi_reg_group_info_t * group) {
+    scpi_reg_val_t summary;
+
+    if (group->parent_reg == SCPI_REG_NONE) {
+        return;
+    }
+
+    /* summary is recomputed after each change, so the last of concurrent
+     * setters leaves the parent register consistent */
+    for (;;) {
+        summary = regGroupSummary(context, group);
+        if ((REG_LOAD(context, group->parent_reg) & group->parent_bit) == summary) {
+            return;
+        }
+        regUpdate(context, group->parent_reg, group->parent_bit, summary);
+    }
+}
+
+/**
+ * Propagate change of register value to the dependent registers
+ * @param context
+ * @param name - register name
+ * @param old_val - value before the change
+ * @param val - value after the change
+ */
+static void regPropagate(scpi_t * context, scpi_reg_name_t name, scpi_reg_val_t old_val, scpi_reg_val_t val) {
+    const scpi_reg_group_info_t * group = &scpi_reg_group_details[scpi_reg_details[name].group];
+
+    switch (scpi_reg_details[name].type) {
+        case SCPI_REG_CLASS_STB:
+        case SCPI_REG_CLASS_SRE:
+            regServiceRequest(context);
+            break;
+        case SCPI_REG_CLASS_EVEN:
+            regSummary(context, group);
+            break;
+        case SCPI_REG_CLASS_COND:
+        {
+            const scpi_reg_val_t events = regTransitions(context, group, old_val, val);
+            regUpdate(context, group->event, events, events);
+            break;
+        }
+        case SCPI_REG_CLASS_ENAB:
+        case SCPI_REG_CLASS_NTR:
+        case SCPI_REG_CLASS_PTR:
+            break;
+    }
+}
+
+/**
+ * Atomically replace masked bits of register and propagate the change
+ * @param context
+ * @param name - register name
+ * @param mask - bits to replace
+ * @param bits - new value of masked bits
+ * @return register value before the change
+ */
+static scpi_reg_val_t regUpdate(scpi_t * context, scpi_reg_name_t name, scpi_reg_val_t mask, scpi_reg_val_t bits) {
+    const scpi_reg_val_t old_val = regReplaceBits(context, name, mask, bits);
+    const scpi_reg_val_t val = (scpi_reg_val_t) ((old_val & ~mask) | (bits & mask));
+
+    if (val != old_val) {
+        regPropagate(context, name, old_val, val);
+    }
+    return old_val;
+}
+
+/**
+ * Set register value
+ * @param context
+ * @param name - register name
+ * @param val - new value
+ */
+void SCPI_RegSet(scpi_t * context, scpi_reg_name_t name, scpi_reg_val_t val) {
+    if ((name < SCPI_REG_COUNT) && context) {
+        regUpdate(context, name, REG_ALL_BITS, val);
+    }
+}
+
+/**
+ * Set register bits
+ * @param context
+ * @param name - register name
+ * @param bits bit mask
+ */
+void SCPI_RegSetBits(scpi_t * context, const scpi_reg_name_t name, const scpi_reg_val_t bits) {
+    if ((name < SCPI_REG_COUNT) && context) {
+        regUpdate(context, name, bits, bits);
+    }
+}
+
+/**
+ * Clear register bits
+ * @param context
+ * @param name - register name
+ * @param bits bit mask
+ */
+void SCPI_RegClearBits(scpi_t * context, const scpi_reg_name_t name, const scpi_reg_val_t bits) {
+    if ((name < SCPI_REG_COUNT) && context) {
+        regUpdate(context, name, bits, 0);
+    }
+}
+
+#else /* USE_REGISTER_ATOMIC */
+
 /**
  * Set register value
  * @param context
@@ -165,6 +475,7 @@ void SCPI_RegSet(scpi_t * context, scpi_reg_name_t name, scpi_reg_val_t val) {
             return;
         } else {
             context->registers[name] = val;
+            regNotify(context, name, old_val, val);
         }
 
         switch (register_type) {
@@ -176,12 +487,12 @@ void SCPI_RegSet(scpi_t * context, scpi_reg_name_t name, scpi_reg_val_t val) {
 
                 if (stb & sre) {
                     ptrans = ((old_val ^ val) & val);
-                    context->registers[SCPI_REG_STB] |= STB_SRQ;
+                    regReplaceBits(context, SCPI_REG_STB, STB_SRQ, STB_SRQ);
                     if (ptrans & val) {
                         writeControl(context, SCPI_CTRL_SRQ, context->registers[SCPI_REG_STB]);
                     }
                 } else {
-                    context->registers[SCPI_REG_STB] &= ~STB_SRQ;
+                    regReplaceBits(context, SCPI_REG_STB, STB_SRQ, 0);
                 }
                 break;
             }
@@ -258,6 +569,132 @@ void SCPI_RegClearBits(scpi_t * context, const scpi_reg_name_t name, const scpi_
     SCPI_RegSet(context, name, SCPI_RegGet(context, name) & ~bits);
 }
 
+#endif /* USE_REGISTER_ATOMIC */
+
+/**
+ * Apply change of register in SCPI_RegUpdateBatch and latch its events
+ * @param context
+ * @param name - changed register
+ * @param old_val - value before the change
+ * @param val - value after the change
+ * @param dirty - register groups, which summary must be updated
+ * @return TRUE if service request must be updated
+ */
+static scpi_bool_t regBatchChanged(scpi_t * context, scpi_reg_name_t name, scpi_reg_val_t old_val, scpi_reg_val_t val, scpi_bool_t * dirty) {
+    const scpi_reg_group_t group = scpi_reg_details[name].group;
+    scpi_reg_val_t events;
+
+    if (old_val == val) {
+        return FALSE;
+    }
+
+    switch (scpi_reg_details[name].type) {
+        case SCPI_REG_CLASS_STB:
+        case SCPI_REG_CLASS_SRE:
+            return TRUE;
+        case SCPI_REG_CLASS_EVEN:
+            dirty[group] = TRUE;
+            break;
+        case SCPI_REG_CLASS_COND:
+            events = regTransitions(context, &scpi_reg_group_details[group], old_val, val);
+            if ((regReplaceBits(context, scpi_reg_group_details[group].event, events, events) & events) != events) {
+                dirty[group] = TRUE;
+            }
+            break;
+        case SCPI_REG_CLASS_ENAB:
+        case SCPI_REG_CLASS_NTR:
+        case SCPI_REG_CLASS_PTR:
+            break;
+    }
+    return FALSE;
+}
+
+/**
+ * Apply changes of more registers at once
+ *
+ * All registers are changed first, then summary bit of each affected
+ * register group is updated once and at most one SCPI_CTRL_SRQ is sent.
+ * Bits present in both set_mask and clear_mask are set.
+ *
+ * @param context
+ * @param updates - register changes
+ * @param count - number of changes
+ */
+void SCPI_RegUpdateBatch(scpi_t * context, const scpi_reg_update_t * updates, size_t count) {
+    scpi_bool_t dirty[SCPI_REG_GROUP_COUNT];
+    scpi_bool_t srq = FALSE;
+    scpi_bool_t pending;
+    const scpi_reg_group_info_t * group;
+    scpi_reg_val_t mask;
+    scpi_reg_val_t summary;
+    scpi_reg_val_t old_val;
+    size_t i;
+    int g;
+
+    if (!context || !updates) {
+        return;
+    }
+
+#if !USE_REGISTER_ATOMIC
+    const scpi_reg_val_t requested = context->registers[SCPI_REG_STB] & context->registers[SCPI_REG_SRE] & ~STB_SRQ;
+#endif
+
+    for (g = 0; g < SCPI_REG_GROUP_COUNT; g++) {
+        dirty[g] = FALSE;
+    }
+
+    for (i = 0; i < count; i++) {
+        if (updates[i].reg >= SCPI_REG_COUNT) {
+            continue;
+        }
+        mask = updates[i].set_mask | updates[i].clear_mask;
+        old_val = regReplaceBits(context, updates[i].reg, mask, updates[i].set_mask);
+        srq |= regBatchChanged(context, updates[i].reg, old_val,
+                (scpi_reg_val_t) ((old_val & ~mask) | updates[i].set_mask), dirty);
+    }
+
+    /* parent of a group can be event register of other group */
+    do {
+        pending = FALSE;
+        for (g = 0; g < SCPI_REG_GROUP_COUNT; g++) {
+            group = &scpi_reg_group_details[g];
+            if (!dirty[g]) {
+                continue;
+            }
+            dirty[g] = FALSE;
+            if (group->parent_reg == SCPI_REG_NONE) {
+                continue;
+            }
+            pending = TRUE;
+
+            do {
+                summary = regGroupSummary(context, group);
+                old_val = regReplaceBits(context, group->parent_reg, group->parent_bit, summary);
+                srq |= regBatchChanged(context, group->parent_reg, old_val,
+                        (scpi_reg_val_t) ((old_val & ~group->parent_bit) | summary), dirty);
+            } while (USE_REGISTER_ATOMIC && (regGroupSummary(context, group) != summary));
+        }
+    } while (pending);
+
+    if (!srq) {
+        return;
+    }
+
+#if USE_REGISTER_ATOMIC
+    regServiceRequest(context);
+#else
+    const scpi_reg_val_t request = context->registers[SCPI_REG_STB] & context->registers[SCPI_REG_SRE] & ~STB_SRQ;
+    if (request) {
+        regReplaceBits(context, SCPI_REG_STB, STB_SRQ, STB_SRQ);
+        if (request & ~requested) {
+            writeControl(context, SCPI_CTRL_SRQ, context->registers[SCPI_REG_STB]);
+        }
+    } else {
+        regReplaceBits(context, SCPI_REG_STB, STB_SRQ, 0);
+    }
+#endif
+}
+
 /**
  * *CLS - This command clears all status data structures in a device. 
  *        For a device which minimally complies with SCPI. (SCPI std 4.1.3.2)
@@ -305,8 +742,13 @@ scpi_result_t SCPI_CoreEseQ(scpi_t * context) {
  * @return 
  */
 scpi_result_t SCPI_CoreEsrQ(scpi_t * context) {
+#if USE_REGISTER_ATOMIC
+    /* events set between reading and clearing must not be lost */
+    SCPI_ResultInt32(context, regUpdate(context, SCPI_REG_ESR, REG_ALL_BITS, 0));
+#else
     SCPI_ResultInt32(context, SCPI_RegGet(context, SCPI_REG_ESR));
     SCPI_RegSet(context, SCPI_REG_ESR, 0);
+#endif
     return SCPI_RES_OK;
 }
 
@@ -355,10 +797,15 @@ scpi_result_t SCPI_CoreOpcQ(scpi_t * context) {
 
 /**
  * *RST
+ * FORMat[:DATA] is set to ASCii and FORMat:BORDer to NORMal
  * @param context
  * @return 
  */
 scpi_result_t SCPI_CoreRst(scpi_t * context) {
+    if (context) {
+        context->data_format = SCPI_DATA_FORMAT_ASCII;
+        context->byte_order = SCPI_FORMAT_NORMAL;
+    }
     if (context && context->interface && context->interface->reset) {
         return context->interface->reset(context);
     }
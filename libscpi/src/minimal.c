@@ -98,6 +98,83 @@ scpi_result_t SCPI_SystemErrorCountQ(scpi_t * context) {
     return SCPI_RES_OK;
 }
 
+#if USE_EVENT_LOG
+#define EVENT_RECORD_LENGTH     14
+#define EVENT_RECORDS_CHUNK     8
+
+/**
+ * Store record of event log in big endian order
+ * @param data - destination of EVENT_RECORD_LENGTH bytes
+ * @param record
+ */
+static void eventRecordEncode(uint8_t * data, const scpi_event_record_t * record) {
+    const uint32_t tag = (uint32_t) record->tag;
+    const uint16_t error_code = (uint16_t) record->error_code;
+
+    data[0] = (uint8_t) (record->sequence >> 24);
+    data[1] = (uint8_t) (record->sequence >> 16);
+    data[2] = (uint8_t) (record->sequence >> 8);
+    data[3] = (uint8_t) (record->sequence);
+    data[4] = (uint8_t) (record->timestamp >> 24);
+    data[5] = (uint8_t) (record->timestamp >> 16);
+    data[6] = (uint8_t) (record->timestamp >> 8);
+    data[7] = (uint8_t) (record->timestamp);
+    data[8] = (uint8_t) (tag >> 24);
+    data[9] = (uint8_t) (tag >> 16);
+    data[10] = (uint8_t) (tag >> 8);
+    data[11] = (uint8_t) (tag);
+    data[12] = (uint8_t) (error_code >> 8);
+    data[13] = (uint8_t) (error_code);
+}
+
+/**
+ * SYSTem:ERRor:LOG?
+ *
+ * Return all records of event log as arbitrary block. Each record has
+ * sequence (4 bytes), timestamp (4 bytes), command tag (4 bytes) and error
+ * code (2 bytes) in big endian order. Records not readable during the
+ * transfer are sent with error code 0. Error queue is not affected.
+ *
+ * @param context
+ * @return
+ */
+scpi_result_t SCPI_SystemErrorLogQ(scpi_t * context) {
+    uint8_t data[EVENT_RECORDS_CHUNK * EVENT_RECORD_LENGTH];
+    scpi_event_record_t record;
+    uint32_t end = SCPI_EventLogSequence(context);
+    uint32_t seq = 0;
+    uint32_t next;
+    size_t len = 0;
+
+    if (end > context->event_log.size) {
+        seq = end - context->event_log.size;
+    }
+
+    SCPI_ResultArbitraryBlockHeader(context, (size_t) (end - seq) * EVENT_RECORD_LENGTH);
+    for (; seq != end; seq++) {
+        next = seq;
+        if ((SCPI_EventLogRead(context, &next, &record, 1) == 0) || (record.sequence != seq)) {
+            record.sequence = seq;
+            record.timestamp = 0;
+            record.tag = 0;
+            record.error_code = 0;
+        }
+
+        eventRecordEncode(&data[len], &record);
+        len += EVENT_RECORD_LENGTH;
+        if (len == sizeof (data)) {
+            SCPI_ResultArbitraryBlockData(context, data, len);
+            len = 0;
+        }
+    }
+    if (len > 0) {
+        SCPI_ResultArbitraryBlockData(context, data, len);
+    }
+
+    return SCPI_RES_OK;
+}
+#endif /* USE_EVENT_LOG */
+
 /**
  * STATus:QUEStionable:CONDition?
  * @param context
@@ -212,3 +289,155 @@ scpi_result_t SCPI_StatusPreset(scpi_t * context) {
     SCPI_RegSet(context, SCPI_REG_QUES, 0);
     return SCPI_RES_OK;
 }
+
+enum {
+    FORMAT_TYPE_ASCII,
+    FORMAT_TYPE_REAL,
+    FORMAT_TYPE_INTEGER,
+    FORMAT_TYPE_PACKED,
+};
+
+static const scpi_choice_def_t format_type_def[] = {
+    {"ASCii", FORMAT_TYPE_ASCII},
+    {"REAL", FORMAT_TYPE_REAL},
+    {"INTeger", FORMAT_TYPE_INTEGER},
+#if USE_PACKED_DATA_FORMAT
+    {"PACKed", FORMAT_TYPE_PACKED},
+#endif
+    SCPI_CHOICE_LIST_END
+};
+
+static const scpi_choice_def_t format_border_def[] = {
+    {"NORMal", SCPI_FORMAT_NORMAL},
+    {"SWAPped", SCPI_FORMAT_SWAPPED},
+    SCPI_CHOICE_LIST_END
+};
+
+/**
+ * FORMat[:DATA] ASCii|REAL[,32|64]|INTeger[,16|32]|PACKed[,16|32]
+ *
+ * Without length, REAL means REAL,64, INTeger means INTeger,16 and
+ * PACKed means PACKed,32. PACKed is vendor specific compressed format,
+ * see SCPI_PackedDecode.
+ * Length of ASCii is accepted and ignored.
+ * @param context
+ * @return
+ */
+scpi_result_t SCPI_FormatData(scpi_t * context) {
+    int32_t type;
+    int32_t length = 0;
+    scpi_data_format_t format;
+
+    if (!SCPI_ParamChoice(context, format_type_def, &type, TRUE)) {
+        return SCPI_RES_ERR;
+    }
+    if (!SCPI_ParamInt32(context, &length, FALSE) && SCPI_ParamErrorOccurred(context)) {
+        return SCPI_RES_ERR;
+    }
+
+    switch (type) {
+        case FORMAT_TYPE_REAL:
+            if (length == 0 || length == 64) {
+                format = SCPI_DATA_FORMAT_REAL64;
+            } else if (length == 32) {
+                format = SCPI_DATA_FORMAT_REAL32;
+            } else {
+                SCPI_ErrorPush(context, SCPI_ERROR_ILLEGAL_PARAMETER_VALUE);
+                return SCPI_RES_ERR;
+            }
+            break;
+        case FORMAT_TYPE_INTEGER:
+            if (length == 0 || length == 16) {
+                format = SCPI_DATA_FORMAT_INT16;
+            } else if (length == 32) {
+                format = SCPI_DATA_FORMAT_INT32;
+            } else {
+                SCPI_ErrorPush(context, SCPI_ERROR_ILLEGAL_PARAMETER_VALUE);
+                return SCPI_RES_ERR;
+            }
+            break;
+#if USE_PACKED_DATA_FORMAT
+        case FORMAT_TYPE_PACKED:
+            if (length == 16) {
+                format = SCPI_DATA_FORMAT_PACKED16;
+            } else if (length == 0 || length == 32) {
+                format = SCPI_DATA_FORMAT_PACKED32;
+            } else {
+                SCPI_ErrorPush(context, SCPI_ERROR_ILLEGAL_PARAMETER_VALUE);
+                return SCPI_RES_ERR;
+            }
+            break;
+#endif
+        default:
+            format = SCPI_DATA_FORMAT_ASCII;
+            break;
+    }
+
+    context->data_format = format;
+    return SCPI_RES_OK;
+}
+
+/**
+ * FORMat[:DATA]?
+ * @param context
+ * @return
+ */
+scpi_result_t SCPI_FormatDataQ(scpi_t * context) {
+    switch (context->data_format) {
+        case SCPI_DATA_FORMAT_REAL32:
+            SCPI_ResultMnemonic(context, "REAL");
+            SCPI_ResultInt32(context, 32);
+            break;
+        case SCPI_DATA_FORMAT_REAL64:
+            SCPI_ResultMnemonic(context, "REAL");
+            SCPI_ResultInt32(context, 64);
+            break;
+        case SCPI_DATA_FORMAT_INT16:
+            SCPI_ResultMnemonic(context, "INT");
+            SCPI_ResultInt32(context, 16);
+            break;
+        case SCPI_DATA_FORMAT_INT32:
+            SCPI_ResultMnemonic(context, "INT");
+            SCPI_ResultInt32(context, 32);
+            break;
+#if USE_PACKED_DATA_FORMAT
+        case SCPI_DATA_FORMAT_PACKED16:
+            SCPI_ResultMnemonic(context, "PACK");
+            SCPI_ResultInt32(context, 16);
+            break;
+        case SCPI_DATA_FORMAT_PACKED32:
+            SCPI_ResultMnemonic(context, "PACK");
+            SCPI_ResultInt32(context, 32);
+            break;
+#endif
+        default:
+            SCPI_ResultMnemonic(context, "ASC");
+            SCPI_ResultInt32(context, 0);
+            break;
+    }
+    return SCPI_RES_OK;
+}
+
+/**
+ * FORMat:BORDer NORMal|SWAPped
+ * @param context
+ * @return
+ */
+scpi_result_t SCPI_FormatBorder(scpi_t * context) {
+    int32_t border;
+    if (!SCPI_ParamChoice(context, format_border_def, &border, TRUE)) {
+        return SCPI_RES_ERR;
+    }
+    context->byte_order = (scpi_array_format_t) border;
+    return SCPI_RES_OK;
+}
+
+/**
+ * FORMat:BORDer?
+ * @param context
+ * @return
+ */
+scpi_result_t SCPI_FormatBorderQ(scpi_t * context) {
+    SCPI_ResultMnemonic(context, context->byte_order == SCPI_FORMAT_SWAPPED ? "SWAP" : "NORM");
+    return SCPI_RES_OK;
+}
@@ -45,6 +45,43 @@
 #include "scpi/error.h"
 #include "scpi/constants.h"
 #include "scpi/utils.h"
+#include "scpi/units.h"
+#include "scpi/expression.h"
+
+#if USE_OUTPUT_QUEUE
+
+/**
+ * Append data to the end of output queue, caller checks free space
+ * @param queue
+ * @param data
+ * @param len - length of data
+ */
+static void outputQueueAdd(scpi_output_queue_t * queue, const char * data, size_t len) {
+    size_t wr = queue->rd + queue->count;
+    size_t first;
+
+    if (wr >= queue->size) {
+        wr -= queue->size;
+    }
+
+    first = min(len, queue->size - wr);
+    memcpy(&queue->data[wr], data, first);
+    memcpy(queue->data, data + first, len - first);
+    queue->count += len;
+}
+
+/**
+ * End of response message, next overflow discards only the next message
+ * @param context
+ */
+static void outputQueueCommit(scpi_t * context) {
+    scpi_output_queue_t * queue = &context->output_queue;
+
+    queue->pending = 0;
+    queue->partial = FALSE;
+    queue->discard = FALSE;
+}
+#endif
 
 /**
  * Write data to SCPI output
@@ -54,10 +91,62 @@
  * @return number of bytes written
  */
 static size_t writeData(scpi_t * context, const char * data, const size_t len) {
+#if USE_OUTPUT_QUEUE
+    scpi_output_queue_t * queue = &context->output_queue;
+    size_t written = 0;
+
+    if ((len == 0) || (data == NULL)) {
+        return 0;
+    }
+
+    if (queue->data == NULL) {
+        return context->interface->write(context, data, len);
+    }
+
+    /* rest of response message, which did not fit to the queue */
+    if (queue->discard) {
+        return 0;
+    }
+
+    /* queued data are sent first to keep the order */
+    if (queue->count > 0) {
+        SCPI_OutputPump(context);
+    }
+
+    if (queue->count == 0) {
+        written = context->interface->write(context, data, len);
+        if (written > len) {
+            written = len;
+        }
+        if (written > 0) {
+            queue->partial = TRUE;
+        }
+        if (written == len) {
+            return len;
+        }
+    }
+
+    /* only the part not accepted by the interface is queued */
+    if (len - written > queue->size - queue->count) {
+        if (!queue->partial) {
+            /* nothing of the message was sent yet, drop it whole */
+            queue->count -= queue->pending;
+        }
+        queue->pending = 0;
+        queue->discard = TRUE;
+        SCPI_ErrorPush(context, SCPI_ERROR_QUERY_DEADLOCKED);
+        return written;
+    }
+
+    outputQueueAdd(queue, data + written, len - written);
+    queue->pending += len - written;
+    return len;
+#else
     if ((len > 0) && (data != NULL)) {
         return context->interface->write(context, data, len);
     }
     return 0;
+#endif
 }
 
 /**
@@ -66,6 +155,13 @@ static size_t writeData(scpi_t * context, const char * data, const size_t len) {
  * @return
  */
 static int flushData(scpi_t * context) {
+#if USE_OUTPUT_QUEUE
+    /* flush after the queue is drained by SCPI_OutputPump */
+    if (context && context->output_queue.count > 0) {
+        context->output_queue.flush = TRUE;
+        return SCPI_RES_OK;
+    }
+#endif
     if (context && context->interface && context->interface->flush) {
         return context->interface->flush(context);
     }
@@ -114,25 +210,179 @@ static size_t writeSemicolon(scpi_t * context) {
     return 0;
 }
 
+#if USE_PARAMETER_SCHEMA
+
 /**
- * Process command
+ * Check range of numeric argument, if the schema defines it
  * @param context
+ * @param schema
+ * @param value
+ * @return TRUE if value is in range
  */
-static scpi_bool_t processCommand(scpi_t * context) {
-    const scpi_command_t * cmd = context->param_list.cmd;
+static scpi_bool_t checkArgumentRange(scpi_t * context, const scpi_param_schema_t * schema, const double value) {
+    if ((schema->min < schema->max) && ((value < schema->min) || (value > schema->max))) {
+        SCPI_ErrorPush(context, SCPI_ERROR_DATA_OUT_OF_RANGE);
+        return FALSE;
+    }
+    return TRUE;
+}
+
+/**
+ * Convert number argument, resolve MIN, MAX and DEF and check its unit
+ * @param context
+ * @param schema
+ * @param number
+ * @param mandatory
+ * @return TRUE if parameter is present and valid
+ */
+static scpi_bool_t convertNumberArgument(scpi_t * context, const scpi_param_schema_t * schema, scpi_number_t * number, const scpi_bool_t mandatory) {
+    const scpi_choice_def_t * special = schema->choices ? schema->choices : scpi_special_numbers_def;
+
+    if (!SCPI_ParamNumber(context, special, number, mandatory)) {
+        number->special = FALSE;
+        number->content.value = schema->def;
+        number->unit = schema->unit;
+        number->base = 10;
+        return FALSE;
+    }
+
+    if (number->special) {
+        switch (number->content.tag) {
+            case SCPI_NUM_MIN:
+            case SCPI_NUM_MAX:
+                if (!(schema->min < schema->max)) {
+                    /* without range, MIN and MAX are left to the callback */
+                    return TRUE;
+                }
+                number->content.value = (number->content.tag == SCPI_NUM_MIN) ? schema->min : schema->max;
+                break;
+            case SCPI_NUM_DEF:
+                number->content.value = schema->def;
+                break;
+            default:
+                /* UP, DOWN, INF, ... are left to the callback */
+                return TRUE;
+        }
+        number->special = FALSE;
+        number->unit = schema->unit;
+        return TRUE;
+    }
+
+    if (number->unit == SCPI_UNIT_NONE) {
+        number->unit = schema->unit;
+    } else if (schema->unit == SCPI_UNIT_NONE) {
+        SCPI_ErrorPush(context, SCPI_ERROR_SUFFIX_NOT_ALLOWED);
+        return FALSE;
+    } else if (number->unit != schema->unit) {
+        SCPI_ErrorPush(context, SCPI_ERROR_INVALID_SUFFIX);
+        return FALSE;
+    }
+
+    return checkArgumentRange(context, schema, number->content.value);
+}
+
+/**
+ * Convert all parameters of the command by its schema before the callback
+ * is called. Missing optional parameters get default values.
+ * @param context
+ * @param schema
+ * @param arguments array of SCPI_SCHEMA_MAX_PARAMETERS items
+ * @return TRUE if all parameters are valid
+ */
+static scpi_bool_t convertArguments(scpi_t * context, const scpi_command_schema_t * schema, scpi_argument_t * arguments) {
     const lex_state_t * state = &context->param_list.lex_state;
-    scpi_bool_t result = TRUE;
-    const scpi_bool_t is_query = context->param_list.cmd_raw.data[context->param_list.cmd_raw.length - 1] == '?';
+    size_t i;
 
-    /* conditionally write ; */
-    if(!context->first_output && is_query) {
-        writeData(context, ";", 1);
+    if ((schema->count > SCPI_SCHEMA_MAX_PARAMETERS) || (schema->count && !schema->params)) {
+        SCPI_ErrorPush(context, SCPI_ERROR_SYSTEM_ERROR);
+        return FALSE;
     }
 
-    context->cmd_error = FALSE;
-    context->output_count = 0;
-    context->input_count = 0;
-    context->arbitrary_remaining = 0;
+    for (i = 0; i < schema->count; i++) {
+        const scpi_param_schema_t * param = &schema->params[i];
+        scpi_argument_t * arg = &arguments[i];
+        const scpi_bool_t mandatory = i < schema->mandatory ? TRUE : FALSE;
+        scpi_bool_t present = FALSE;
+        size_t len;
+
+        arg->type = param->type;
+
+        switch (param->type) {
+            case SCPI_PARAM_INT32:
+                present = SCPI_ParamInt32(context, &arg->content.int32, mandatory);
+                if (!present) {
+                    arg->content.int32 = (int32_t) param->def;
+                } else if (!checkArgumentRange(context, param, arg->content.int32)) {
+                    return FALSE;
+                }
+                break;
+            case SCPI_PARAM_UINT32:
+                present = SCPI_ParamUInt32(context, &arg->content.uint32, mandatory);
+                if (!present) {
+                    arg->content.uint32 = (uint32_t) param->def;
+                } else if (!checkArgumentRange(context, param, arg->content.uint32)) {
+                    return FALSE;
+                }
+                break;
+            case SCPI_PARAM_DOUBLE:
+                present = SCPI_ParamDouble(context, &arg->content.value, mandatory);
+                if (!present) {
+                    arg->content.value = param->def;
+                } else if (!checkArgumentRange(context, param, arg->content.value)) {
+                    return FALSE;
+                }
+                break;
+            case SCPI_PARAM_BOOL:
+                present = SCPI_ParamBool(context, &arg->content.boolean, mandatory);
+                if (!present) {
+                    arg->content.boolean = param->def != 0 ? TRUE : FALSE;
+                }
+                break;
+            case SCPI_PARAM_CHOICE:
+                present = SCPI_ParamChoice(context, param->choices, &arg->content.tag, mandatory);
+                if (!present) {
+                    arg->content.tag = (int32_t) param->def;
+                }
+                break;
+            case SCPI_PARAM_NUMBER:
+                present = convertNumberArgument(context, param, &arg->content.number, mandatory);
+                break;
+            case SCPI_PARAM_TEXT:
+                present = SCPI_ParamCharacters(context, &arg->content.text.ptr, &len, mandatory);
+                arg->content.text.len = present ? (int32_t) len : 0;
+                if (!present) {
+                    arg->content.text.ptr = "";
+                }
+                break;
+            default:
+                SCPI_ErrorPush(context, SCPI_ERROR_SYSTEM_ERROR);
+                return FALSE;
+        }
+
+        if (SCPI_ParamErrorOccurred(context)) {
+            return FALSE;
+        }
+
+        arg->present = present;
+    }
+
+    if (state->pos < (state->buffer + state->len)) {
+        SCPI_ErrorPush(context, SCPI_ERROR_PARAMETER_NOT_ALLOWED);
+        return FALSE;
+    }
+
+    return TRUE;
+}
+#endif /* USE_PARAMETER_SCHEMA */
+
+/**
+ * Call command callback and check its result
+ * @param context
+ * @param is_query
+ * @return FALSE if the command failed
+ */
+static scpi_bool_t callCommand(scpi_t * context, scpi_bool_t is_query) {
+    const scpi_command_t * cmd = context->param_list.cmd;
 
     /* if callback exists - call command callback */
     if (cmd->callback != NULL) {
@@ -140,10 +390,10 @@ static scpi_bool_t processCommand(scpi_t * context) {
             if (!context->cmd_error) {
                 SCPI_ErrorPush(context, SCPI_ERROR_EXECUTION_ERROR);
             }
-            result = FALSE;
+            return FALSE;
         } else {
             if (context->cmd_error) {
-                result = FALSE;
+                return FALSE;
             } else {
                 if(context->first_output && is_query) {
                     context->first_output = FALSE;
@@ -152,6 +402,51 @@ static scpi_bool_t processCommand(scpi_t * context) {
         }
     }
 
+    return TRUE;
+}
+
+/**
+ * Process command
+ * @param context
+ */
+static scpi_bool_t processCommand(scpi_t * context) {
+    const scpi_command_t * cmd = context->param_list.cmd;
+    const lex_state_t * state = &context->param_list.lex_state;
+    scpi_bool_t result;
+    const scpi_bool_t is_query = context->param_list.cmd_raw.data[context->param_list.cmd_raw.length - 1] == '?';
+
+    /* conditionally write ; */
+    if(!context->first_output && is_query) {
+        writeData(context, ";", 1);
+    }
+
+    context->cmd_error = FALSE;
+    context->output_count = 0;
+    context->input_count = 0;
+    context->arbitrary_remaining = 0;
+
+#if USE_PARAMETER_SCHEMA
+    if (cmd->schema != NULL) {
+        scpi_argument_t arguments[SCPI_SCHEMA_MAX_PARAMETERS];
+
+        /* reject invalid parameters before the callback has any side effect */
+        if (!convertArguments(context, cmd->schema, arguments)) {
+            return FALSE;
+        }
+        context->arguments = arguments;
+        context->argument_count = cmd->schema->count;
+
+        result = callCommand(context, is_query);
+
+        context->arguments = NULL;
+        context->argument_count = 0;
+    } else {
+        result = callCommand(context, is_query);
+    }
+#else
+    result = callCommand(context, is_query);
+#endif
+
     /* set error if command callback did not read all parameters */
     if (state->pos < (state->buffer + state->len) && !context->cmd_error) {
         SCPI_ErrorPush(context, SCPI_ERROR_PARAMETER_NOT_ALLOWED);
@@ -240,6 +535,11 @@ scpi_bool_t SCPI_Parse(scpi_t * context, char * data, int len) {
 
     /* conditionally write new line */
     writeNewLine(context);
+#if USE_OUTPUT_QUEUE
+    if (context->output_queue.data != NULL) {
+        outputQueueCommit(context);
+    }
+#endif
 
     return result;
 }
@@ -270,6 +570,9 @@ void SCPI_Init(scpi_t * context,
     context->cmdlist = commands;
     context->interface = interface;
     context->units = units;
+#if USE_UNITS_HASH
+    scpiUnits_BuildIndex(&context->units_index, units);
+#endif
     context->idn[0] = idn1;
     context->idn[1] = idn2;
     context->idn[2] = idn3;
@@ -277,6 +580,8 @@ void SCPI_Init(scpi_t * context,
     context->buffer.data = input_buffer;
     context->buffer.length = input_buffer_length;
     context->buffer.position = 0;
+    context->data_format = SCPI_DATA_FORMAT_ASCII;
+    context->byte_order = SCPI_FORMAT_NORMAL;
     SCPI_ErrorInit(context, error_queue_data, error_queue_size);
 }
 
@@ -291,7 +596,119 @@ void SCPI_Init(scpi_t * context,
  */
 void SCPI_InitHeap(scpi_t * context,
         char * error_info_heap, size_t error_info_heap_length) {
+#if USE_ERROR_INFO_SLAB
+    /* one slot for each queued error and one for error being pushed */
+    scpislab_init(&context->error_info_heap, error_info_heap, error_info_heap_length, (uint16_t) (context->error_queue.size + 1));
+#else
     scpiheap_init(&context->error_info_heap, error_info_heap, error_info_heap_length);
+#endif
+}
+
+/**
+ * Peak usage of error information heap
+ * @param context
+ * @return number of bytes
+ */
+size_t SCPI_HeapPeak(const scpi_t * context) {
+#if USE_ERROR_INFO_SLAB
+    return context->error_info_heap.peak * context->error_info_heap.slot_size;
+#else
+    return context->error_info_heap.peak;
+#endif
+}
+#endif
+
+#if USE_OUTPUT_QUEUE
+
+/**
+ * Initialize output queue
+ *
+ * Data are written directly to the write callback while the queue is empty.
+ * Data, which are not accepted by the write callback, are queued and sent
+ * later by SCPI_OutputPump. Output of later commands waits behind them, so
+ * the order is kept. The queue length is the limit of buffered data. If the
+ * data do not fit to the queue, rest of the response message is discarded
+ * and SCPI_ERROR_QUERY_DEADLOCKED is reported. Response message, which was
+ * not sent at all yet, is discarded whole.
+ *
+ * @param context
+ * @param output_queue - memory for queued data, NULL to disable the queue
+ * @param output_queue_length - maximal number of queued bytes
+ */
+void SCPI_InitOutputQueue(scpi_t * context,
+        char * output_queue, size_t output_queue_length) {
+    context->output_queue.data = output_queue;
+    context->output_queue.size = output_queue ? output_queue_length : 0;
+    SCPI_OutputClear(context);
+}
+
+/**
+ * Write queued data to the interface
+ *
+ * Call it, when the interface is able to accept more data,
+ * e.g. when the socket becomes writable.
+ *
+ * @param context
+ * @return number of bytes still waiting in the queue
+ */
+size_t SCPI_OutputPump(scpi_t * context) {
+    scpi_output_queue_t * queue = &context->output_queue;
+
+    while (queue->count > 0) {
+        const size_t chunk = min(queue->count, queue->size - queue->rd);
+        size_t written = context->interface->write(context, &queue->data[queue->rd], chunk);
+
+        if (written > chunk) {
+            written = chunk;
+        }
+        queue->rd += written;
+        if (queue->rd >= queue->size) {
+            queue->rd = 0;
+        }
+        queue->count -= written;
+
+        if (written < chunk) {
+            break;
+        }
+    }
+
+    /* part of current response message was sent */
+    if (queue->pending > queue->count) {
+        queue->pending = queue->count;
+        queue->partial = TRUE;
+    }
+
+    if (queue->count == 0) {
+        queue->rd = 0;
+        if (queue->flush) {
+            queue->flush = FALSE;
+            flushData(context);
+        }
+    }
+
+    return queue->count;
+}
+
+/**
+ * Number of bytes waiting in the output queue
+ * @param context
+ * @return
+ */
+size_t SCPI_OutputPending(const scpi_t * context) {
+    return context->output_queue.count;
+}
+
+/**
+ * Discard all data waiting in the output queue, e.g. when client disconnects
+ * @param context
+ */
+void SCPI_OutputClear(scpi_t * context) {
+    context->output_queue.rd = 0;
+    context->output_queue.count = 0;
+    context->output_queue.pending = 0;
+    context->output_queue.flush = FALSE;
+    context->output_queue.partial = FALSE;
+    context->output_queue.discard = FALSE;
 }
 #endif
 
@@ -546,12 +963,12 @@ size_t SCPI_ResultError(scpi_t * context, const scpi_error_t * error) {
     const char * data[SCPIDEFINE_DESCRIPTION_MAX_PARTS];
     size_t len[SCPIDEFINE_DESCRIPTION_MAX_PARTS];
 
-    data[0] = SCPI_ErrorTranslate(error->error_code);
+    data[0] = SCPI_ErrorTranslateEx(context, error->error_code);
     len[0] = strlen(data[0]);
 
 #if USE_DEVICE_DEPENDENT_ERROR_INFORMATION
     data[1] = error->device_dependent_info;
-#if USE_MEMORY_ALLOCATION_FREE
+#if USE_MEMORY_ALLOCATION_FREE || USE_ERROR_INFO_SLAB
     len[1] = error->device_dependent_info ? strlen(data[1]) : 0;
 #else
     SCPIDEFINE_get_parts(&context->error_info_heap, data[1], &len[1], &data[2], &len[2]);
@@ -762,6 +1179,8 @@ scpi_bool_t SCPI_ParamIsNumber(const scpi_parameter_t * parameter, const scpi_bo
  * @return TRUE if succesful
  */
 static scpi_bool_t ParamSignToUInt32(scpi_t * context, const scpi_parameter_t * parameter, uint32_t * value, const scpi_bool_t sign) {
+    size_t used;
+    scpi_bool_t overflow;
 
     if (!value) {
         SCPI_ErrorPush(context, SCPI_ERROR_SYSTEM_ERROR);
@@ -770,21 +1189,31 @@ static scpi_bool_t ParamSignToUInt32(scpi_t * context, const scpi_parameter_t *
 
     switch (parameter->type) {
         case SCPI_TOKEN_HEXNUM:
-            return strBaseToUInt32(parameter->ptr, value, 16) > 0 ? TRUE : FALSE;
+            used = strBaseToUInt32(parameter->ptr, parameter->len, value, 16, &overflow);
+            break;
         case SCPI_TOKEN_OCTNUM:
-            return strBaseToUInt32(parameter->ptr, value, 8) > 0 ? TRUE : FALSE;
+            used = strBaseToUInt32(parameter->ptr, parameter->len, value, 8, &overflow);
+            break;
         case SCPI_TOKEN_BINNUM:
-            return strBaseToUInt32(parameter->ptr, value, 2) > 0 ? TRUE : FALSE;
+            used = strBaseToUInt32(parameter->ptr, parameter->len, value, 2, &overflow);
+            break;
         case SCPI_TOKEN_DECIMAL_NUMERIC_PROGRAM_DATA:
-        case SCPI_TOKEN_DECIMAL_NUMERIC_PROGRAM_DATA_WITH_SUFFIX: {
+        case SCPI_TOKEN_DECIMAL_NUMERIC_PROGRAM_DATA_WITH_SUFFIX:
             if (sign) {
-                return strBaseToInt32(parameter->ptr, (int32_t *) value, 10) > 0 ? TRUE : FALSE;
+                used = strBaseToInt32(parameter->ptr, parameter->len, (int32_t *) value, 10, &overflow);
+            } else {
+                used = strBaseToUInt32(parameter->ptr, parameter->len, value, 10, &overflow);
             }
-            return strBaseToUInt32(parameter->ptr, value, 10) > 0 ? TRUE : FALSE;
-        }
+            break;
         default:
             return FALSE;
     }
+
+    if (overflow) {
+        SCPI_ErrorPush(context, SCPI_ERROR_DATA_OUT_OF_RANGE);
+        return FALSE;
+    }
+    return used > 0 ? TRUE : FALSE;
 }
 
 /**
@@ -796,6 +1225,8 @@ static scpi_bool_t ParamSignToUInt32(scpi_t * context, const scpi_parameter_t *
  * @return TRUE if succesful
  */
 static scpi_bool_t ParamSignToUInt64(scpi_t * context, const scpi_parameter_t * parameter, uint64_t * value, const scpi_bool_t sign) {
+    size_t used;
+    scpi_bool_t overflow;
 
     if (!value) {
         SCPI_ErrorPush(context, SCPI_ERROR_SYSTEM_ERROR);
@@ -804,21 +1235,31 @@ static scpi_bool_t ParamSignToUInt64(scpi_t * context, const scpi_parameter_t *
 
     switch (parameter->type) {
         case SCPI_TOKEN_HEXNUM:
-            return strBaseToUInt64(parameter->ptr, value, 16) > 0 ? TRUE : FALSE;
+            used = strBaseToUInt64(parameter->ptr, parameter->len, value, 16, &overflow);
+            break;
         case SCPI_TOKEN_OCTNUM:
-            return strBaseToUInt64(parameter->ptr, value, 8) > 0 ? TRUE : FALSE;
+            used = strBaseToUInt64(parameter->ptr, parameter->len, value, 8, &overflow);
+            break;
         case SCPI_TOKEN_BINNUM:
-            return strBaseToUInt64(parameter->ptr, value, 2) > 0 ? TRUE : FALSE;
+            used = strBaseToUInt64(parameter->ptr, parameter->len, value, 2, &overflow);
+            break;
         case SCPI_TOKEN_DECIMAL_NUMERIC_PROGRAM_DATA:
-        case SCPI_TOKEN_DECIMAL_NUMERIC_PROGRAM_DATA_WITH_SUFFIX: {
+        case SCPI_TOKEN_DECIMAL_NUMERIC_PROGRAM_DATA_WITH_SUFFIX:
             if (sign) {
-                return strBaseToInt64(parameter->ptr, (int64_t *) value, 10) > 0 ? TRUE : FALSE;
+                used = strBaseToInt64(parameter->ptr, parameter->len, (int64_t *) value, 10, &overflow);
+            } else {
+                used = strBaseToUInt64(parameter->ptr, parameter->len, value, 10, &overflow);
             }
-            return strBaseToUInt64(parameter->ptr, value, 10) > 0 ? TRUE : FALSE;
-        }
+            break;
         default:
             return FALSE;
     }
+
+    if (overflow) {
+        SCPI_ErrorPush(context, SCPI_ERROR_DATA_OUT_OF_RANGE);
+        return FALSE;
+    }
+    return used > 0 ? TRUE : FALSE;
 }
 
 /**
@@ -890,7 +1331,7 @@ scpi_bool_t SCPI_ParamToFloat(scpi_t * context, const scpi_parameter_t * paramet
             break;
         case SCPI_TOKEN_DECIMAL_NUMERIC_PROGRAM_DATA:
         case SCPI_TOKEN_DECIMAL_NUMERIC_PROGRAM_DATA_WITH_SUFFIX:
-            result = strToFloat(parameter->ptr, value) > 0 ? TRUE : FALSE;
+            result = strToFloat(parameter->ptr, parameter->len, value) > 0 ? TRUE : FALSE;
             break;
         default:
             result = FALSE;
@@ -923,7 +1364,7 @@ scpi_bool_t SCPI_ParamToDouble(scpi_t * context, const scpi_parameter_t * parame
             break;
         case SCPI_TOKEN_DECIMAL_NUMERIC_PROGRAM_DATA:
         case SCPI_TOKEN_DECIMAL_NUMERIC_PROGRAM_DATA_WITH_SUFFIX:
-            result = strToDouble(parameter->ptr, value) > 0 ? TRUE : FALSE;
+            result = strToDouble(parameter->ptr, parameter->len, value) > 0 ? TRUE : FALSE;
             break;
         default:
             result = FALSE;
@@ -953,6 +1394,14 @@ scpi_bool_t SCPI_ParamFloat(scpi_t * context, float * value, const scpi_bool_t m
         } else if (SCPI_ParamIsNumber(&param, TRUE)) {
             SCPI_ErrorPush(context, SCPI_ERROR_SUFFIX_NOT_ALLOWED);
             result = FALSE;
+#if USE_EXPRESSION_EVAL
+        } else if (param.type == SCPI_TOKEN_PROGRAM_EXPRESSION) {
+            double dvalue;
+            result = SCPI_ExprEvalDouble(context, &param, &dvalue) == SCPI_EXPR_OK ? TRUE : FALSE;
+            if (result) {
+                *value = (float) dvalue;
+            }
+#endif
         } else {
             SCPI_ErrorPush(context, SCPI_ERROR_DATA_TYPE_ERROR);
             result = FALSE;
@@ -983,6 +1432,10 @@ scpi_bool_t SCPI_ParamDouble(scpi_t * context, double * value, const scpi_bool_t
         } else if (SCPI_ParamIsNumber(&param, TRUE)) {
             SCPI_ErrorPush(context, SCPI_ERROR_SUFFIX_NOT_ALLOWED);
             result = FALSE;
+#if USE_EXPRESSION_EVAL
+        } else if (param.type == SCPI_TOKEN_PROGRAM_EXPRESSION) {
+            result = SCPI_ExprEvalDouble(context, &param, value) == SCPI_EXPR_OK ? TRUE : FALSE;
+#endif
         } else {
             SCPI_ErrorPush(context, SCPI_ERROR_DATA_TYPE_ERROR);
             result = FALSE;
@@ -1206,32 +1659,183 @@ scpi_bool_t SCPI_ParamCopyText(scpi_t * context, char * buffer, const size_t buf
     return result;
 }
 
+#if USE_CHOICE_INDEX
 /**
- * Convert parameter to choice
- * @param context
- * @param parameter - should be PROGRAM_MNEMONIC
- * @param options - NULL terminated list of choices
- * @param value - index to options
+ * Hash of choice tag for reverse index
+ * @param tag
  * @return
  */
-scpi_bool_t SCPI_ParamToChoice(scpi_t * context, const scpi_parameter_t * parameter, const scpi_choice_def_t * options, int32_t * value) {
-    scpi_bool_t result = FALSE;
+static size_t choiceTagHash(int32_t tag) {
+    uint32_t hash = (uint32_t) tag * 2654435761ul;
+    return (size_t) (hash ^ (hash >> 16));
+}
 
-    if (!options || !value) {
-        SCPI_ErrorPush(context, SCPI_ERROR_SYSTEM_ERROR);
-        return FALSE;
+/**
+ * Insert entry into the name part of choice index. Entries are inserted in
+ * list order, so the first matching entry is also found first.
+ * @param index
+ * @param name
+ * @param len
+ * @param entry
+ */
+static void choiceIndexInsert(scpi_choice_index_t * index, const char * name, size_t len, size_t entry) {
+    const size_t mask = SCPI_CHOICE_HASH_SIZE - 1;
+    size_t h = strHashCase(name, len) & mask;
+
+    while (index->slot[h]) {
+        h = (h + 1) & mask;
     }
+    index->slot[h] = (uint8_t) (entry + 1);
+}
 
-    if (parameter->type == SCPI_TOKEN_PROGRAM_MNEMONIC) {
-        for (size_t res = 0; options[res].name; ++res) {
-            if (matchPattern(options[res].name, strlen(options[res].name), parameter->ptr, parameter->len, NULL)) {
-                *value = options[res].tag;
-                result = TRUE;
-                break;
-            }
+/**
+ * Build hash index of short and long forms of choice names and reverse index
+ * of tags. Lists with numeric suffix patterns or lists too big for the index
+ * stay invalid and are searched linearly.
+ * @param index
+ * @param options
+ */
+static void choiceIndexBuild(scpi_choice_index_t * index, const scpi_choice_def_t * options) {
+    const size_t mask = SCPI_CHOICE_HASH_SIZE - 1;
+    size_t i;
+    size_t h;
+    size_t len;
+    size_t short_len;
+
+    index->table = options;
+    index->valid = FALSE;
+    memset(index->slot, 0, sizeof (index->slot));
+    memset(index->inverse, 0, sizeof (index->inverse));
+
+    for (i = 0; options[i].name != NULL; i++) {
+        if ((i >= UINT8_MAX) || (i >= SCPI_CHOICE_HASH_SIZE * 3 / 8)) {
+            return;
         }
 
-        if (!result) {
+        len = strlen(options[i].name);
+        if ((len > 0) && (options[i].name[len - 1] == '#')) {
+            return;
+        }
+    }
+
+    for (i = 0; options[i].name != NULL; i++) {
+        len = strlen(options[i].name);
+        short_len = patternSeparatorShortPos(options[i].name, len);
+        choiceIndexInsert(index, options[i].name, len, i);
+        if (short_len != len) {
+            choiceIndexInsert(index, options[i].name, short_len, i);
+        }
+
+        h = choiceTagHash(options[i].tag) & mask;
+        while (index->inverse[h]) {
+            if (options[index->inverse[h] - 1].tag == options[i].tag) {
+                break; /* first definition wins, same as linear search */
+            }
+            h = (h + 1) & mask;
+        }
+        if (!index->inverse[h]) {
+            index->inverse[h] = (uint8_t) (i + 1);
+        }
+    }
+
+    index->valid = TRUE;
+}
+
+/**
+ * Get index of choice list. Short lists are not indexed. Lists are identified
+ * by pointer only, so indexed lists must be static and const.
+ * @param context
+ * @param options
+ * @return valid index or NULL
+ */
+static const scpi_choice_index_t * choiceIndex(scpi_t * context, const scpi_choice_def_t * options) {
+    scpi_choice_index_t * index;
+    size_t i;
+
+    for (i = 0; i < SCPI_CHOICE_INDEX_COUNT; i++) {
+        if (context->choice_index[i].table == options) {
+            return context->choice_index[i].valid ? &context->choice_index[i] : NULL;
+        }
+    }
+
+    for (i = 0; i < SCPI_CHOICE_INDEX_MIN; i++) {
+        if (options[i].name == NULL) {
+            return NULL;
+        }
+    }
+
+    index = &context->choice_index[context->choice_index_next];
+    context->choice_index_next = (uint8_t) ((context->choice_index_next + 1) % SCPI_CHOICE_INDEX_COUNT);
+    choiceIndexBuild(index, options);
+
+    return index->valid ? index : NULL;
+}
+#endif
+
+/**
+ * Find choice matching the mnemonic
+ * @param context
+ * @param options
+ * @param str
+ * @param len
+ * @return matching choice or NULL
+ */
+static const scpi_choice_def_t * findChoice(scpi_t * context, const scpi_choice_def_t * options, const char * str, size_t len) {
+    size_t res;
+
+#if USE_CHOICE_INDEX
+    const scpi_choice_index_t * index = choiceIndex(context, options);
+
+    if (index) {
+        const size_t mask = SCPI_CHOICE_HASH_SIZE - 1;
+        size_t h = strHashCase(str, len) & mask;
+
+        while (index->slot[h]) {
+            res = index->slot[h] - 1;
+            if (matchPattern(options[res].name, strlen(options[res].name), str, len, NULL)) {
+                return &options[res];
+            }
+            h = (h + 1) & mask;
+        }
+
+        return NULL;
+    }
+#else
+    (void) context;
+#endif
+
+    for (res = 0; options[res].name; ++res) {
+        if (matchPattern(options[res].name, strlen(options[res].name), str, len, NULL)) {
+            return &options[res];
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * Convert parameter to choice
+ * @param context
+ * @param parameter - should be PROGRAM_MNEMONIC
+ * @param options - NULL terminated list of choices
+ * @param value - index to options
+ * @return
+ */
+scpi_bool_t SCPI_ParamToChoice(scpi_t * context, const scpi_parameter_t * parameter, const scpi_choice_def_t * options, int32_t * value) {
+    scpi_bool_t result = FALSE;
+    const scpi_choice_def_t * choice;
+
+    if (!options || !value) {
+        SCPI_ErrorPush(context, SCPI_ERROR_SYSTEM_ERROR);
+        return FALSE;
+    }
+
+    if (parameter->type == SCPI_TOKEN_PROGRAM_MNEMONIC) {
+        choice = findChoice(context, options, parameter->ptr, parameter->len);
+        if (choice) {
+            *value = choice->tag;
+            result = TRUE;
+        } else {
             SCPI_ErrorPush(context, SCPI_ERROR_ILLEGAL_PARAMETER_VALUE);
         }
     } else {
@@ -1259,6 +1863,428 @@ scpi_bool_t SCPI_ChoiceToName(const scpi_choice_def_t * options, const int32_t t
     return FALSE;
 }
 
+/**
+ * Find tag in choices and returns its first textual representation. Uses
+ * reverse index of the choice list in the context if available.
+ * @param context
+ * @param options specifications of choices numbers (patterns)
+ * @param tag numerical representatio of choice
+ * @param text result text
+ * @return TRUE if succesfule, else FALSE
+ */
+scpi_bool_t SCPI_ChoiceToNameEx(scpi_t * context, const scpi_choice_def_t * options, const int32_t tag, const char ** text) {
+#if USE_CHOICE_INDEX
+    const scpi_choice_index_t * index = choiceIndex(context, options);
+
+    if (index) {
+        const size_t mask = SCPI_CHOICE_HASH_SIZE - 1;
+        size_t h = choiceTagHash(tag) & mask;
+
+        while (index->inverse[h]) {
+            if (options[index->inverse[h] - 1].tag == tag) {
+                *text = options[index->inverse[h] - 1].name;
+                return TRUE;
+            }
+            h = (h + 1) & mask;
+        }
+
+        return FALSE;
+    }
+#else
+    (void) context;
+#endif
+
+    return SCPI_ChoiceToName(options, tag, text);
+}
+
+/**
+ * Classify parameter without converting it. Spans of a decimal number point
+ * to its integer digits, fraction digits, exponent (including sign) and
+ * suffix. Spans of a nondecimal number point to its digits.
+ * @param parameter
+ * @param view result
+ */
+void SCPI_ParamToView(const scpi_parameter_t * parameter, scpi_param_view_t * view) {
+    const char * ptr = parameter->ptr;
+    const char * end = parameter->ptr + parameter->len;
+    const char * rollback;
+
+    memset(view, 0, sizeof (*view));
+    view->ptr = parameter->ptr;
+    view->len = parameter->len;
+
+    switch (parameter->type) {
+        case SCPI_TOKEN_HEXNUM:
+        case SCPI_TOKEN_OCTNUM:
+        case SCPI_TOKEN_BINNUM:
+            view->kind = SCPI_VIEW_NONDECIMAL;
+            view->base = (parameter->type == SCPI_TOKEN_HEXNUM) ? 16 : ((parameter->type == SCPI_TOKEN_OCTNUM) ? 8 : 2);
+            view->integer = parameter->ptr;
+            view->integer_len = parameter->len;
+            return;
+        case SCPI_TOKEN_DECIMAL_NUMERIC_PROGRAM_DATA:
+        case SCPI_TOKEN_DECIMAL_NUMERIC_PROGRAM_DATA_WITH_SUFFIX:
+            break;
+        case SCPI_TOKEN_PROGRAM_MNEMONIC:
+            view->kind = SCPI_VIEW_MNEMONIC;
+            return;
+        case SCPI_TOKEN_SINGLE_QUOTE_PROGRAM_DATA:
+        case SCPI_TOKEN_DOUBLE_QUOTE_PROGRAM_DATA:
+            view->kind = SCPI_VIEW_STRING;
+            return;
+        case SCPI_TOKEN_ARBITRARY_BLOCK_PROGRAM_DATA:
+            view->kind = SCPI_VIEW_BLOCK;
+            return;
+        case SCPI_TOKEN_PROGRAM_EXPRESSION:
+            view->kind = SCPI_VIEW_EXPRESSION;
+            return;
+        default:
+            view->kind = SCPI_VIEW_OTHER;
+            return;
+    }
+
+    /* same grammar as scpiLex_DecimalNumericProgramData */
+    view->kind = SCPI_VIEW_INTEGER;
+    view->base = 10;
+
+    if ((ptr < end) && ((*ptr == '+') || (*ptr == '-'))) {
+        view->negative = (*ptr == '-') ? TRUE : FALSE;
+        ptr++;
+    }
+
+    view->integer = ptr;
+    while ((ptr < end) && isdigit((uint8_t) *ptr)) {
+        ptr++;
+    }
+    view->integer_len = ptr - view->integer;
+
+    if ((ptr < end) && (*ptr == '.')) {
+        view->kind = SCPI_VIEW_REAL;
+        ptr++;
+        view->fraction = ptr;
+        while ((ptr < end) && isdigit((uint8_t) *ptr)) {
+            ptr++;
+        }
+        view->fraction_len = ptr - view->fraction;
+    }
+
+    rollback = ptr;
+    ptr += skipWhitespace(ptr, end - ptr);
+    if ((ptr < end) && ((*ptr == 'e') || (*ptr == 'E'))) {
+        const char * exponent;
+
+        ptr++;
+        ptr += skipWhitespace(ptr, end - ptr);
+        exponent = ptr;
+        if ((ptr < end) && ((*ptr == '+') || (*ptr == '-'))) {
+            ptr++;
+        }
+        if ((ptr < end) && isdigit((uint8_t) *ptr)) {
+            while ((ptr < end) && isdigit((uint8_t) *ptr)) {
+                ptr++;
+            }
+            view->kind = SCPI_VIEW_REAL;
+            view->exponent = exponent;
+            view->exponent_len = ptr - exponent;
+        } else {
+            ptr = rollback;
+        }
+    } else {
+        ptr = rollback;
+    }
+
+    ptr += skipWhitespace(ptr, end - ptr);
+    if (ptr < end) {
+        view->suffix = ptr;
+        view->suffix_len = end - ptr;
+    }
+}
+
+/**
+ * Read next parameter as a view
+ * @param context
+ * @param view result
+ * @param mandatory
+ * @return
+ */
+scpi_bool_t SCPI_ParamView(scpi_t * context, scpi_param_view_t * view, const scpi_bool_t mandatory) {
+    scpi_parameter_t param;
+
+    if (!view) {
+        SCPI_ErrorPush(context, SCPI_ERROR_SYSTEM_ERROR);
+        return FALSE;
+    }
+
+    if (!SCPI_Parameter(context, &param, mandatory)) {
+        return FALSE;
+    }
+
+    SCPI_ParamToView(&param, view);
+    return TRUE;
+}
+
+/**
+ * Detect if view is mnemonic matching the pattern
+ * @param view
+ * @param pattern eg. MAXimum
+ * @return
+ */
+scpi_bool_t SCPI_ViewIsKeyword(const scpi_param_view_t * view, const char * pattern) {
+    if (view->kind != SCPI_VIEW_MNEMONIC) {
+        return FALSE;
+    }
+
+    return matchPattern(pattern, strlen(pattern), view->ptr, view->len, NULL);
+}
+
+/**
+ * Convert mnemonic view to choice
+ * @param context
+ * @param view
+ * @param options - NULL terminated list of choices
+ * @param value - tag of matching choice
+ * @return
+ */
+scpi_bool_t SCPI_ViewToChoice(scpi_t * context, const scpi_param_view_t * view, const scpi_choice_def_t * options, int32_t * value) {
+    const scpi_choice_def_t * choice;
+
+    if (!options || !value) {
+        SCPI_ErrorPush(context, SCPI_ERROR_SYSTEM_ERROR);
+        return FALSE;
+    }
+
+    if (view->kind != SCPI_VIEW_MNEMONIC) {
+        SCPI_ErrorPush(context, SCPI_ERROR_DATA_TYPE_ERROR);
+        return FALSE;
+    }
+
+    choice = findChoice(context, options, view->ptr, view->len);
+    if (!choice) {
+        SCPI_ErrorPush(context, SCPI_ERROR_ILLEGAL_PARAMETER_VALUE);
+        return FALSE;
+    }
+
+    *value = choice->tag;
+    return TRUE;
+}
+
+/**
+ * Compute magnitude of numeric view exactly, without floating point
+ * arithmetic. Decimal number must have integral value, eg. 1.5E1.
+ * @param context
+ * @param view
+ * @param value magnitude
+ * @return TRUE if successful, else error is pushed
+ */
+static scpi_bool_t viewToMagnitude(scpi_t * context, const scpi_param_view_t * view, uint64_t * value) {
+    scpi_bool_t overflow = FALSE;
+    int32_t exponent = 0;
+    int32_t keep;
+    size_t i;
+    size_t count;
+    uint64_t mag = 0;
+
+    if (view->kind == SCPI_VIEW_NONDECIMAL) {
+        if (strBaseToUInt64(view->integer, view->integer_len, value, view->base, &overflow) == 0) {
+            SCPI_ErrorPush(context, SCPI_ERROR_DATA_TYPE_ERROR);
+            return FALSE;
+        }
+        if (overflow) {
+            SCPI_ErrorPush(context, SCPI_ERROR_DATA_OUT_OF_RANGE);
+            return FALSE;
+        }
+        return TRUE;
+    }
+
+    if ((view->kind != SCPI_VIEW_INTEGER) && (view->kind != SCPI_VIEW_REAL)) {
+        SCPI_ErrorPush(context, SCPI_ERROR_DATA_TYPE_ERROR);
+        return FALSE;
+    }
+
+    for (i = 0; i < view->exponent_len; i++) {
+        if (isdigit((uint8_t) view->exponent[i]) && (exponent < 10000)) {
+            exponent = exponent * 10 + (view->exponent[i] - '0');
+        }
+    }
+    if ((view->exponent_len > 0) && (view->exponent[0] == '-')) {
+        exponent = -exponent;
+    }
+
+    /* digits after position keep are shifted out by the exponent */
+    count = view->integer_len + view->fraction_len;
+    keep = (int32_t) view->integer_len + exponent;
+    exponent = (keep > (int32_t) count) ? keep - (int32_t) count : 0;
+
+    for (i = 0; i < count; i++) {
+        char c = (i < view->integer_len) ? view->integer[i] : view->fraction[i - view->integer_len];
+        uint8_t digit = (uint8_t) (c - '0');
+
+        if ((int32_t) i >= keep) {
+            if (digit != 0) {
+                SCPI_ErrorPush(context, SCPI_ERROR_ILLEGAL_PARAMETER_VALUE);
+                return FALSE;
+            }
+        } else if (mag > (UINT64_MAX - digit) / 10) {
+            overflow = TRUE;
+        } else {
+            mag = mag * 10 + digit;
+        }
+    }
+
+    for (; (mag != 0) && (exponent > 0) && !overflow; exponent--) {
+        if (mag > UINT64_MAX / 10) {
+            overflow = TRUE;
+        } else {
+            mag *= 10;
+        }
+    }
+
+    if (overflow) {
+        SCPI_ErrorPush(context, SCPI_ERROR_DATA_OUT_OF_RANGE);
+        return FALSE;
+    }
+
+    *value = mag;
+    return TRUE;
+}
+
+/**
+ * Convert numeric view to signed/unsigned integer of given width. Number with
+ * suffix is not allowed. Nondecimal numbers are bit patterns of the type.
+ * @param context
+ * @param view
+ * @param value result
+ * @param bits width of the type
+ * @param sign
+ * @return
+ */
+static scpi_bool_t viewToInteger(scpi_t * context, const scpi_param_view_t * view, uint64_t * value, uint8_t bits, scpi_bool_t sign) {
+    uint64_t mag;
+    uint64_t limit = (bits < 64) ? ((uint64_t) 1 << bits) - 1 : UINT64_MAX;
+
+    if (!value) {
+        SCPI_ErrorPush(context, SCPI_ERROR_SYSTEM_ERROR);
+        return FALSE;
+    }
+
+    if (view->suffix_len > 0) {
+        SCPI_ErrorPush(context, SCPI_ERROR_SUFFIX_NOT_ALLOWED);
+        return FALSE;
+    }
+
+    if (!viewToMagnitude(context, view, &mag)) {
+        return FALSE;
+    }
+
+    if (view->kind != SCPI_VIEW_NONDECIMAL) {
+        if (sign) {
+            limit = (limit >> 1) + (view->negative ? 1 : 0);
+        } else if (view->negative && (mag != 0)) {
+            limit = 0;
+        }
+    }
+
+    if (mag > limit) {
+        SCPI_ErrorPush(context, SCPI_ERROR_DATA_OUT_OF_RANGE);
+        return FALSE;
+    }
+
+    *value = view->negative ? (uint64_t) 0 - mag : mag;
+    return TRUE;
+}
+
+/**
+ * Convert numeric view to signed 32 bit integer exactly
+ * @param context
+ * @param view
+ * @param value result
+ * @return
+ */
+scpi_bool_t SCPI_ViewToInt32(scpi_t * context, const scpi_param_view_t * view, int32_t * value) {
+    uint64_t val;
+
+    if (viewToInteger(context, view, value ? &val : NULL, 32, TRUE)) {
+        *value = (int32_t) (uint32_t) val;
+        return TRUE;
+    }
+    return FALSE;
+}
+
+/**
+ * Convert numeric view to unsigned 32 bit integer exactly
+ * @param context
+ * @param view
+ * @param value result
+ * @return
+ */
+scpi_bool_t SCPI_ViewToUInt32(scpi_t * context, const scpi_param_view_t * view, uint32_t * value) {
+    uint64_t val;
+
+    if (viewToInteger(context, view, value ? &val : NULL, 32, FALSE)) {
+        *value = (uint32_t) val;
+        return TRUE;
+    }
+    return FALSE;
+}
+
+/**
+ * Convert numeric view to signed 64 bit integer exactly
+ * @param context
+ * @param view
+ * @param value result
+ * @return
+ */
+scpi_bool_t SCPI_ViewToInt64(scpi_t * context, const scpi_param_view_t * view, int64_t * value) {
+    uint64_t val;
+
+    if (viewToInteger(context, view, value ? &val : NULL, 64, TRUE)) {
+        *value = (int64_t) val;
+        return TRUE;
+    }
+    return FALSE;
+}
+
+/**
+ * Convert numeric view to double. Number with suffix is not allowed.
+ * @param context
+ * @param view
+ * @param value result
+ * @return
+ */
+scpi_bool_t SCPI_ViewToDouble(scpi_t * context, const scpi_param_view_t * view, double * value) {
+    uint64_t val;
+
+    if (!value) {
+        SCPI_ErrorPush(context, SCPI_ERROR_SYSTEM_ERROR);
+        return FALSE;
+    }
+
+    if (view->suffix_len > 0) {
+        SCPI_ErrorPush(context, SCPI_ERROR_SUFFIX_NOT_ALLOWED);
+        return FALSE;
+    }
+
+    switch (view->kind) {
+        case SCPI_VIEW_NONDECIMAL:
+            if (!viewToMagnitude(context, view, &val)) {
+                return FALSE;
+            }
+            *value = val;
+            return TRUE;
+        case SCPI_VIEW_INTEGER:
+        case SCPI_VIEW_REAL:
+            if (strToDouble(view->ptr, view->len, value) > 0) {
+                return TRUE;
+            }
+            break;
+        default:
+            break;
+    }
+
+    SCPI_ErrorPush(context, SCPI_ERROR_DATA_TYPE_ERROR);
+    return FALSE;
+}
+
 /*
  * Definition of BOOL choice list
  */
@@ -1461,10 +2487,27 @@ scpi_bool_t SCPI_IsCmd(const scpi_t * context, const char * cmd) {
     if (!context->param_list.cmd) {
         return FALSE;
     }
-
-    const char *pattern = context->param_list.cmd->pattern;
-    return matchCommand(pattern, cmd, strlen(cmd), NULL, 0, 0);
+
+    const char *pattern = context->param_list.cmd->pattern;
+    return matchCommand(pattern, cmd, strlen(cmd), NULL, 0, 0);
+}
+
+#if USE_PARAMETER_SCHEMA
+
+/**
+ * Return argument converted by the .schema of the matching scpi_command_t
+ *  - valid only during the command callback
+ * @param context
+ * @param index index of parameter
+ * @return argument or NULL if command has no such parameter in its schema
+ */
+const scpi_argument_t * SCPI_Argument(const scpi_t * context, const size_t index) {
+    if (!context->arguments || index >= context->argument_count) {
+        return NULL;
+    }
+    return &context->arguments[index];
 }
+#endif /* USE_PARAMETER_SCHEMA */
 
 #if USE_COMMAND_TAGS
 
@@ -1706,11 +2749,440 @@ size_t SCPI_ResultArrayDouble(scpi_t * context, const double * array, const size
     RESULT_ARRAY(SCPI_ResultDouble);
 }
 
+/**
+ * Round and clamp scaled value to integer range, NaN is converted to 0
+ * @param val
+ * @param scale
+ * @param min
+ * @param max
+ * @return
+ */
+static int32_t scaleToInt(double val, double scale, int32_t min, int32_t max) {
+    double scaled = val * scale;
+    int32_t result;
+    double frac;
+
+    if (scaled != scaled) {
+        return 0;
+    }
+    if (scaled <= (double) min) {
+        return min;
+    }
+    if (scaled >= (double) max) {
+        return max;
+    }
+
+    /* round half away from zero, scaled - result is exact */
+    result = (int32_t) scaled;
+    frac = scaled - result;
+    if (frac >= 0.5) {
+        result++;
+    } else if (frac <= -0.5) {
+        result--;
+    }
+    return result;
+}
+
+/**
+ * Size of one item of the binary data format
+ * @param format
+ * @return 0 for ASCII
+ */
+static size_t dataFormatItemSize(scpi_data_format_t format) {
+    switch (format) {
+        case SCPI_DATA_FORMAT_REAL32: return sizeof (float);
+        case SCPI_DATA_FORMAT_REAL64: return sizeof (double);
+        case SCPI_DATA_FORMAT_INT16: return sizeof (int16_t);
+        case SCPI_DATA_FORMAT_INT32: return sizeof (int32_t);
+        default: return 0;
+    }
+}
+
+/**
+ * Convert doubles to binary items of the negotiated format and byte order
+ * @param out - count * item size bytes
+ * @param array
+ * @param count
+ * @param format
+ * @param swap - swap bytes of each item
+ * @param scale - multiplier for integer formats
+ */
+static void convertArrayAuto(uint8_t * out, const double * array, size_t count, scpi_data_format_t format, scpi_bool_t swap, double scale) {
+    size_t i;
+
+    switch (format) {
+        case SCPI_DATA_FORMAT_REAL32:
+            for (i = 0; i < count; i++) {
+                float val = (float) array[i];
+                uint32_t bits;
+                memcpy(&bits, &val, sizeof (bits));
+                if (swap) bits = SCPI_Swap32(bits);
+                memcpy(&out[i * sizeof (bits)], &bits, sizeof (bits));
+            }
+            break;
+        case SCPI_DATA_FORMAT_REAL64:
+            for (i = 0; i < count; i++) {
+                uint64_t bits;
+                memcpy(&bits, &array[i], sizeof (bits));
+                if (swap) bits = SCPI_Swap64(bits);
+                memcpy(&out[i * sizeof (bits)], &bits, sizeof (bits));
+            }
+            break;
+        case SCPI_DATA_FORMAT_INT16:
+            for (i = 0; i < count; i++) {
+                uint16_t bits = (uint16_t) scaleToInt(array[i], scale, INT16_MIN, INT16_MAX);
+                if (swap) bits = SCPI_Swap16(bits);
+                memcpy(&out[i * sizeof (bits)], &bits, sizeof (bits));
+            }
+            break;
+        case SCPI_DATA_FORMAT_INT32:
+            for (i = 0; i < count; i++) {
+                uint32_t bits = (uint32_t) scaleToInt(array[i], scale, INT32_MIN, INT32_MAX);
+                if (swap) bits = SCPI_Swap32(bits);
+                memcpy(&out[i * sizeof (bits)], &bits, sizeof (bits));
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+#if USE_PACKED_DATA_FORMAT
+
+/**
+ * Encode scaled values as zig-zag varint of difference to the previous value
+ * @param out - output buffer, NULL to compute size only
+ * @param array
+ * @param count
+ * @param min - minimal integer value
+ * @param max - maximal integer value
+ * @param scale - multiplier
+ * @param previous - last encoded value, updated
+ * @return number of encoded bytes
+ */
+static size_t packArrayAuto(uint8_t * out, const double * array, size_t count, int32_t min, int32_t max, double scale, int32_t * previous) {
+    size_t len = 0;
+    size_t i;
+    int32_t prev = *previous;
+
+    for (i = 0; i < count; i++) {
+        int32_t val = scaleToInt(array[i], scale, min, max);
+        int64_t delta = (int64_t) val - prev;
+        uint64_t zigzag = ((uint64_t) delta << 1) ^ (uint64_t) (delta >> 63);
+        prev = val;
+
+        if (out == NULL) {
+            do {
+                len++;
+                zigzag >>= 7;
+            } while (zigzag);
+            continue;
+        }
+
+        while (zigzag >= 0x80) {
+            out[len++] = (uint8_t) (zigzag | 0x80);
+            zigzag >>= 7;
+        }
+        out[len++] = (uint8_t) zigzag;
+    }
+
+    *previous = prev;
+    return len;
+}
+#endif /* USE_PACKED_DATA_FORMAT */
+
+#define RESULT_ARRAY_AUTO_CHUNK 32
+
+/**
+ * Get chunk of values as doubles
+ * @param darray - source array of doubles or NULL
+ * @param farray - source array of floats, used if darray is NULL
+ * @param index - first item of the chunk
+ * @param chunk - number of items
+ * @param values - space for converted floats
+ * @return pointer to doubles
+ */
+static const double * arrayAutoChunk(const double * darray, const float * farray, size_t index, size_t chunk, double * values) {
+    size_t i;
+
+    if (darray) {
+        return &darray[index];
+    }
+
+    for (i = 0; i < chunk; i++) {
+        values[i] = farray[index + i];
+    }
+    return values;
+}
+
+/**
+ * Result array of doubles or floats in format selected by FORMat[:DATA]
+ * and FORMat:BORDer
+ * @param context
+ * @param darray - array of doubles or NULL
+ * @param farray - array of floats, used if darray is NULL
+ * @param count
+ * @param scale
+ * @return
+ */
+static size_t produceResultArrayAuto(scpi_t * context, const double * darray, const float * farray, size_t count, double scale) {
+    const size_t item_size = dataFormatItemSize(context->data_format);
+    const scpi_bool_t swap = SCPI_GetNativeFormat() != context->byte_order;
+    uint8_t buffer[RESULT_ARRAY_AUTO_CHUNK * sizeof (double)];
+    double values[RESULT_ARRAY_AUTO_CHUNK];
+    const double * chunk_values;
+    size_t result = 0;
+    size_t i;
+    size_t chunk;
+
+#if USE_PACKED_DATA_FORMAT
+    if (context->data_format == SCPI_DATA_FORMAT_PACKED16 || context->data_format == SCPI_DATA_FORMAT_PACKED32) {
+        const int32_t min = context->data_format == SCPI_DATA_FORMAT_PACKED16 ? INT16_MIN : INT32_MIN;
+        const int32_t max = context->data_format == SCPI_DATA_FORMAT_PACKED16 ? INT16_MAX : INT32_MAX;
+        size_t header_len;
+        size_t payload_len;
+        int32_t previous = 0;
+
+        /* header */
+        header_len = 0;
+        buffer[header_len++] = SCPI_PACKED_MAGIC;
+        buffer[header_len++] = SCPI_PACKED_VERSION;
+        for (i = count; i >= 0x80; i >>= 7) {
+            buffer[header_len++] = (uint8_t) (i | 0x80);
+        }
+        buffer[header_len++] = (uint8_t) i;
+
+        /* first pass computes the block length, nothing is buffered */
+        payload_len = header_len;
+        for (i = 0; i < count; i += chunk) {
+            chunk = min(count - i, RESULT_ARRAY_AUTO_CHUNK);
+            chunk_values = arrayAutoChunk(darray, farray, i, chunk, values);
+            payload_len += packArrayAuto(NULL, chunk_values, chunk, min, max, scale, &previous);
+        }
+
+        result += SCPI_ResultArbitraryBlockHeader(context, payload_len);
+        result += SCPI_ResultArbitraryBlockData(context, buffer, header_len);
+
+        previous = 0;
+        for (i = 0; i < count; i += chunk) {
+            chunk = min(count - i, RESULT_ARRAY_AUTO_CHUNK);
+            chunk_values = arrayAutoChunk(darray, farray, i, chunk, values);
+            result += SCPI_ResultArbitraryBlockData(context, buffer,
+                    packArrayAuto(buffer, chunk_values, chunk, min, max, scale, &previous));
+        }
+        return result;
+    }
+#endif /* USE_PACKED_DATA_FORMAT */
+
+    if (item_size == 0) {
+        for (i = 0; i < count; i++) {
+            result += darray ? SCPI_ResultDouble(context, darray[i]) : SCPI_ResultFloat(context, farray[i]);
+        }
+        return result;
+    }
+
+    result += SCPI_ResultArbitraryBlockHeader(context, count * item_size);
+    for (i = 0; i < count; i += chunk) {
+        chunk = min(count - i, RESULT_ARRAY_AUTO_CHUNK);
+        chunk_values = arrayAutoChunk(darray, farray, i, chunk, values);
+        convertArrayAuto(buffer, chunk_values, chunk, context->data_format, swap, scale);
+        result += SCPI_ResultArbitraryBlockData(context, buffer, chunk * item_size);
+    }
+    return result;
+}
+
+/**
+ * Result array of doubles in format selected by FORMat[:DATA] and FORMat:BORDer
+ *
+ * ASCII values are sent unchanged. REAL,32 narrows values to float,
+ * INTeger,16 and INTeger,32 multiply values by scale, round them and clamp
+ * them to the range of the type. PACKed,16 and PACKed,32 scale values
+ * the same way and send them as zig-zag varint differences, see SCPI_PackedDecode.
+ *
+ * @param context
+ * @param array
+ * @param count
+ * @param scale - multiplier for integer formats
+ * @return
+ */
+size_t SCPI_ResultArrayAutoDouble(scpi_t * context, const double * array, const size_t count, const double scale) {
+    return produceResultArrayAuto(context, array, NULL, count, scale);
+}
+
+/**
+ * Result array of floats in format selected by FORMat[:DATA] and FORMat:BORDer
+ *
+ * Same as SCPI_ResultArrayAutoDouble, values are converted to double first.
+ *
+ * @param context
+ * @param array
+ * @param count
+ * @param scale - multiplier for integer formats
+ * @return
+ */
+size_t SCPI_ResultArrayAutoFloat(scpi_t * context, const float * array, const size_t count, const double scale) {
+    return produceResultArrayAuto(context, NULL, array, count, scale);
+}
+
+/**
+ * Read arbitrary block program data into array of binary items and swap
+ * bytes if needed (native endiannes != required endiannes)
+ * @param context
+ * @param data - array to fill
+ * @param i_count - number of elements of data
+ * @param o_count - real number of filled elements
+ * @param item_size - size of one element
+ * @param format
+ * @param mandatory
+ * @return TRUE on success
+ */
+static scpi_bool_t paramArrayBinary(scpi_t * context, void * data, const size_t i_count, size_t * o_count, const size_t item_size, const scpi_array_format_t format, const scpi_bool_t mandatory) {
+    scpi_parameter_t param;
+    size_t count;
+
+    *o_count = 0;
+
+    if (format != SCPI_FORMAT_BIGENDIAN && format != SCPI_FORMAT_LITTLEENDIAN) {
+        SCPI_ErrorPush(context, SCPI_ERROR_SYSTEM_ERROR);
+        return FALSE;
+    }
+
+    if (!SCPI_Parameter(context, &param, mandatory)) {
+        return mandatory ? FALSE : !SCPI_ParamErrorOccurred(context);
+    }
+
+    if (param.type != SCPI_TOKEN_ARBITRARY_BLOCK_PROGRAM_DATA) {
+        SCPI_ErrorPush(context, SCPI_ERROR_DATA_TYPE_ERROR);
+        return FALSE;
+    }
+
+    if (param.len % item_size != 0) {
+        SCPI_ErrorPush(context, SCPI_ERROR_INVALID_BLOCK_DATA);
+        return FALSE;
+    }
+
+    count = param.len / item_size;
+    if (count > i_count) {
+        SCPI_ErrorPush(context, SCPI_ERROR_TOO_MUCH_DATA);
+        return FALSE;
+    }
+
+    memcpy(data, param.ptr, param.len);
+    if (SCPI_GetNativeFormat() != format) {
+        SCPI_SwapArray(data, count, item_size);
+    }
+
+    *o_count = count;
+    return TRUE;
+}
+
+#if USE_BUILTIN_STRTOD
+
+/**
+ * Find start of next plain decimal number in the list of parameters
+ * @param context
+ * @return pointer to the number or NULL if the element must be processed
+ * by the lexer (end of list, other data type, missing comma)
+ */
+static const char * listDecimalStart(const scpi_t * context) {
+    const lex_state_t * state = &context->param_list.lex_state;
+    const char * ptr = state->pos;
+    const char * end = state->buffer + state->len;
+
+    if (context->input_count != 0) {
+        if (ptr >= end || *ptr != ',') {
+            return NULL;
+        }
+        ptr++;
+    }
+
+    while (ptr < end && (*ptr == ' ' || *ptr == '\t')) {
+        ptr++;
+    }
+
+    if (ptr >= end) {
+        return NULL;
+    }
+
+    if (isdigit((uint8_t) *ptr) || *ptr == '+' || *ptr == '-' || *ptr == '.') {
+        return ptr;
+    }
+
+    return NULL;
+}
+
+/**
+ * Finish plain decimal number found by listDecimalStart. The number is
+ * accepted only if it is followed by a comma or by the end of the list,
+ * so the element is exactly what the lexer would produce.
+ * @param context
+ * @param ptr - start of the number
+ * @param used - number of characters consumed by the conversion
+ * @return TRUE if the element was consumed
+ */
+static scpi_bool_t listDecimalEnd(scpi_t * context, const char * ptr, size_t used) {
+    lex_state_t * state = &context->param_list.lex_state;
+    const char * end = state->buffer + state->len;
+
+    if (used == 0) {
+        return FALSE;
+    }
+
+    ptr += used;
+    while (ptr < end && (*ptr == ' ' || *ptr == '\t')) {
+        ptr++;
+    }
+
+    if (ptr < end && *ptr != ',') {
+        return FALSE;
+    }
+
+    state->pos = (char *) ptr;
+    context->input_count++;
+    return TRUE;
+}
+
+/*
+ * Plain decimal elements are converted directly from the parameter buffer,
+ * comma and whitespace are handled in the same pass. Anything else
+ * (suffix, MIN/MAX, #H, errors) falls back to the common parameter path.
+ */
+#define PARAM_ARRAY_DECIMAL_TEMPLATE(conv, func) do{\
+    if (format != SCPI_FORMAT_ASCII) {\
+        return paramArrayBinary(context, data, i_count, o_count, sizeof(*data), format, mandatory);\
+    }\
+    const char * end = context->param_list.lex_state.buffer + context->param_list.lex_state.len;\
+    for (*o_count = 0; *o_count < i_count; (*o_count)++) {\
+        const char * ptr = listDecimalStart(context);\
+        if (ptr && listDecimalEnd(context, ptr, conv(ptr, end - ptr, &data[*o_count]))) {\
+            mandatory = FALSE;\
+            continue;\
+        }\
+        if (!func(context, &data[*o_count], mandatory)) {\
+            break;\
+        }\
+        mandatory = FALSE;\
+    }\
+    return mandatory ? FALSE : TRUE;\
+}while(0)
+
+#else /* USE_BUILTIN_STRTOD */
+
+/*
+ * strtod of the C library does not stop at the length of the element and
+ * accepts also 0x10, INF or NAN, so all elements go through the lexer.
+ */
+#define PARAM_ARRAY_DECIMAL_TEMPLATE(conv, func) PARAM_ARRAY_TEMPLATE(func)
+
+#endif /* USE_BUILTIN_STRTOD */
+
 /*
  * Template macro to generate all SCPI_ParamArrayXYZ function
  */
 #define PARAM_ARRAY_TEMPLATE(func) do{\
-    if (format != SCPI_FORMAT_ASCII) return FALSE;\
+    if (format != SCPI_FORMAT_ASCII) {\
+        return paramArrayBinary(context, data, i_count, o_count, sizeof(*data), format, mandatory);\
+    }\
     for (*o_count = 0; *o_count < i_count; (*o_count)++) {\
         if (!func(context, &data[*o_count], mandatory)) {\
             break;\
@@ -1720,6 +3192,91 @@ size_t SCPI_ResultArrayDouble(scpi_t * context, const double * array, const size
     return mandatory ? FALSE : TRUE;\
 }while(0)
 
+#define PARAM_NARROW_TEMPLATE(type, min, max) do{\
+    int32_t tmp;\
+    if (!SCPI_ParamInt32(context, &tmp, mandatory)) {\
+        return FALSE;\
+    }\
+    if (tmp < (min) || tmp > (max)) {\
+        SCPI_ErrorPush(context, SCPI_ERROR_DATA_OUT_OF_RANGE);\
+        return FALSE;\
+    }\
+    *value = (type) tmp;\
+    return TRUE;\
+}while(0)
+
+static scpi_bool_t ParamInt8(scpi_t * context, int8_t * value, scpi_bool_t mandatory) {
+    PARAM_NARROW_TEMPLATE(int8_t, INT8_MIN, INT8_MAX);
+}
+
+static scpi_bool_t ParamUInt8(scpi_t * context, uint8_t * value, scpi_bool_t mandatory) {
+    PARAM_NARROW_TEMPLATE(uint8_t, 0, UINT8_MAX);
+}
+
+static scpi_bool_t ParamInt16(scpi_t * context, int16_t * value, scpi_bool_t mandatory) {
+    PARAM_NARROW_TEMPLATE(int16_t, INT16_MIN, INT16_MAX);
+}
+
+static scpi_bool_t ParamUInt16(scpi_t * context, uint16_t * value, scpi_bool_t mandatory) {
+    PARAM_NARROW_TEMPLATE(uint16_t, 0, UINT16_MAX);
+}
+
+/**
+ * Read list of values up to i_count
+ * @param context
+ * @param data - array to fill
+ * @param i_count - number of elements of data
+ * @param o_count - real number of filled elements
+ * @param format
+ * @param mandatory
+ * @return TRUE on success
+ */
+scpi_bool_t SCPI_ParamArrayInt8(scpi_t * context, int8_t *data, const size_t i_count, size_t *o_count, const scpi_array_format_t format, scpi_bool_t mandatory) {
+    PARAM_ARRAY_TEMPLATE(ParamInt8);
+}
+
+/**
+ * Read list of values up to i_count
+ * @param context
+ * @param data - array to fill
+ * @param i_count - number of elements of data
+ * @param o_count - real number of filled elements
+ * @param format
+ * @param mandatory
+ * @return TRUE on success
+ */
+scpi_bool_t SCPI_ParamArrayUInt8(scpi_t * context, uint8_t *data, const size_t i_count, size_t *o_count, const scpi_array_format_t format, scpi_bool_t mandatory) {
+    PARAM_ARRAY_TEMPLATE(ParamUInt8);
+}
+
+/**
+ * Read list of values up to i_count
+ * @param context
+ * @param data - array to fill
+ * @param i_count - number of elements of data
+ * @param o_count - real number of filled elements
+ * @param format
+ * @param mandatory
+ * @return TRUE on success
+ */
+scpi_bool_t SCPI_ParamArrayInt16(scpi_t * context, int16_t *data, const size_t i_count, size_t *o_count, const scpi_array_format_t format, scpi_bool_t mandatory) {
+    PARAM_ARRAY_TEMPLATE(ParamInt16);
+}
+
+/**
+ * Read list of values up to i_count
+ * @param context
+ * @param data - array to fill
+ * @param i_count - number of elements of data
+ * @param o_count - real number of filled elements
+ * @param format
+ * @param mandatory
+ * @return TRUE on success
+ */
+scpi_bool_t SCPI_ParamArrayUInt16(scpi_t * context, uint16_t *data, const size_t i_count, size_t *o_count, const scpi_array_format_t format, scpi_bool_t mandatory) {
+    PARAM_ARRAY_TEMPLATE(ParamUInt16);
+}
+
 /**
  * Read list of values up to i_count
  * @param context
@@ -1781,13 +3338,14 @@ scpi_bool_t SCPI_ParamArrayUInt64(scpi_t * context, uint64_t *data, const size_t
  * @param context
  * @param data - array to fill
  * @param i_count - number of elements of data
- * @param o_count - real number of filled elements
+ * @param o_count - real number of filled elements, index of the first
+ * malformed element if SCPI_ParamErrorOccurred() is set
  * @param format
  * @param mandatory
  * @return TRUE on success
  */
 scpi_bool_t SCPI_ParamArrayFloat(scpi_t * context, float *data, const size_t i_count, size_t *o_count, const scpi_array_format_t format, scpi_bool_t mandatory) {
-    PARAM_ARRAY_TEMPLATE(SCPI_ParamFloat);
+    PARAM_ARRAY_DECIMAL_TEMPLATE(strToFloat, SCPI_ParamFloat);
 }
 
 /**
@@ -1795,11 +3353,12 @@ scpi_bool_t SCPI_ParamArrayFloat(scpi_t * context, float *data, const size_t i_c
  * @param context
  * @param data - array to fill
  * @param i_count - number of elements of data
- * @param o_count - real number of filled elements
+ * @param o_count - real number of filled elements, index of the first
+ * malformed element if SCPI_ParamErrorOccurred() is set
  * @param format
  * @param mandatory
  * @return TRUE on success
  */
 scpi_bool_t SCPI_ParamArrayDouble(scpi_t * context, double *data, const size_t i_count, size_t *o_count, const scpi_array_format_t format, scpi_bool_t mandatory) {
-    PARAM_ARRAY_TEMPLATE(SCPI_ParamDouble);
+    PARAM_ARRAY_DECIMAL_TEMPLATE(strToDouble, SCPI_ParamDouble);
 }
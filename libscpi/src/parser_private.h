@@ -47,6 +47,9 @@ extern "C" {
     int scpiParser_parseProgramData(lex_state_t * state, scpi_token_t * token) LOCAL;
     int scpiParser_parseAllProgramData(lex_state_t * state, scpi_token_t * token, int * numberOfParameters) LOCAL;
     int scpiParser_detectProgramMessageUnit(scpi_parser_state_t * state, char * buffer, int len) LOCAL;
+#if USE_UNITS_HASH
+    void scpiUnits_BuildIndex(scpi_units_index_t * index, const scpi_unit_def_t * units) LOCAL;
+#endif
 
 #ifdef	__cplusplus
 }
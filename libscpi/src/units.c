@@ -36,32 +36,52 @@
  */
 
 #include <string.h>
+#include <ctype.h>
+#include <math.h>
 #include "scpi/parser.h"
 #include "scpi/units.h"
 #include "utils_private.h"
 #include "scpi/utils.h"
 #include "scpi/error.h"
+#include "scpi/expression.h"
 #include "lexer_private.h"
+#include "parser_private.h"
 
 
+/* exponent of multiplier, which is not a power of ten */
+#define SCPI_UNIT_INEXACT INT8_MIN
+
 /*
  * multipliers IEEE 488.2-1992 tab 7-2
- * 1E18         EX
- * 1E15         PE
- * 1E12         T
- * 1E9          G
- * 1E6          MA (use M for OHM and HZ)
- * 1E3          K
- * 1E-3         M (disaalowed for OHM and HZ)
- * 1E-6         U
- * 1E-9         N
- * 1E-12        P
- * 1E-15        F
- * 1E-18        A
+ * ordered by multiplier, "MA" must be tested before "M" when parsing
  */
+static const struct {
+    const char * name;
+    size_t len;
+    double mult;
+    double scale; /* exact power of ten, 1E-9 is not exact */
+    int8_t exponent;
+} unit_prefixes[] = {
+    {/* name */ "EX", /* len */ 2, /* mult */ 1e18, /* scale */ 1e18, /* exponent */ 18},
+    {/* name */ "PE", /* len */ 2, /* mult */ 1e15, /* scale */ 1e15, /* exponent */ 15},
+    {/* name */ "T", /* len */ 1, /* mult */ 1e12, /* scale */ 1e12, /* exponent */ 12},
+    {/* name */ "G", /* len */ 1, /* mult */ 1e9, /* scale */ 1e9, /* exponent */ 9},
+    {/* name */ "MA", /* len */ 2, /* mult */ 1e6, /* scale */ 1e6, /* exponent */ 6},
+    {/* name */ "K", /* len */ 1, /* mult */ 1e3, /* scale */ 1e3, /* exponent */ 3},
+    {/* name */ "M", /* len */ 1, /* mult */ 1e-3, /* scale */ 1e3, /* exponent */ -3}, /* 1E6 for OHM and HZ */
+    {/* name */ "U", /* len */ 1, /* mult */ 1e-6, /* scale */ 1e6, /* exponent */ -6},
+    {/* name */ "N", /* len */ 1, /* mult */ 1e-9, /* scale */ 1e9, /* exponent */ -9},
+    {/* name */ "P", /* len */ 1, /* mult */ 1e-12, /* scale */ 1e12, /* exponent */ -12},
+    {/* name */ "F", /* len */ 1, /* mult */ 1e-15, /* scale */ 1e15, /* exponent */ -15},
+    {/* name */ "A", /* len */ 1, /* mult */ 1e-18, /* scale */ 1e18, /* exponent */ -18},
+};
 
 /*
  * units definition IEEE 488.2-1992 tab 7-1
+ *
+ * Only base units are listed, prefixed forms (MV, KOHM, NS, ...) are
+ * decomposed by translateUnit. Units with other multiplier than 1 and
+ * names which would be misread as prefixed unit are listed explicitly.
  */
 const scpi_unit_def_t scpi_units_def[] = {
 #if USE_UNITS_PARTICLES
@@ -75,19 +95,10 @@ const scpi_unit_def_t scpi_units_def[] = {
     {/* name */ "MOL", /* unit */ SCPI_UNIT_MOLE, /* mult */ 1},
 
     /* Dose equivalent */
-    {/* name */ "NSV", /* unit */ SCPI_UNIT_SIEVERT, /* mult */ 1e-9},
-    {/* name */ "USV", /* unit */ SCPI_UNIT_SIEVERT, /* mult */ 1e-6},
-    {/* name */ "MSV", /* unit */ SCPI_UNIT_SIEVERT, /* mult */ 1e-3},
     {/* name */ "SV", /* unit */ SCPI_UNIT_SIEVERT, /* mult */ 1},
-    {/* name */ "KSV", /* unit */ SCPI_UNIT_SIEVERT, /* mult */ 1e3},
-    {/* name */ "MASV", /* unit */ SCPI_UNIT_SIEVERT, /* mult */ 1e6},
 
     /* Energy */
     {/* name */ "EV", /* unit */ SCPI_UNIT_ELECTRONVOLT, /* mult */ 1},
-    {/* name */ "KEV", /* unit */ SCPI_UNIT_ELECTRONVOLT, /* mult */ 1e3},
-    {/* name */ "MAEV", /* unit */ SCPI_UNIT_ELECTRONVOLT, /* mult */ 1e6},
-    {/* name */ "GEV", /* unit */ SCPI_UNIT_ELECTRONVOLT, /* mult */ 1e9},
-    {/* name */ "TEV", /* unit */ SCPI_UNIT_ELECTRONVOLT, /* mult */ 1e12},
 
     /* Mass */
     {/* name */ "U", /* unit */ SCPI_UNIT_ATOMIC_MASS, /* mult */ 1},
@@ -106,32 +117,18 @@ const scpi_unit_def_t scpi_units_def[] = {
 
 #if USE_UNITS_ELECTRIC
     /* Electric - capacitance */
-    {/* name */ "PF", /* unit */ SCPI_UNIT_FARAD, /* mult */ 1e-12},
-    {/* name */ "NF", /* unit */ SCPI_UNIT_FARAD, /* mult */ 1e-9},
-    {/* name */ "UF", /* unit */ SCPI_UNIT_FARAD, /* mult */ 1e-6},
-    {/* name */ "MF", /* unit */ SCPI_UNIT_FARAD, /* mult */ 1e-3},
     {/* name */ "F", /* unit */ SCPI_UNIT_FARAD, /* mult */ 1},
 
     /* Electric - current */
-    {/* name */ "UA", /* unit */ SCPI_UNIT_AMPER, /* mult */ 1e-6},
-    {/* name */ "MA", /* unit */ SCPI_UNIT_AMPER, /* mult */ 1e-3},
     {/* name */ "A", /* unit */ SCPI_UNIT_AMPER, /* mult */ 1},
-    {/* name */ "KA", /* unit */ SCPI_UNIT_AMPER, /* mult */ 1e3},
 
     /* Electric - potential */
-    {/* name */ "UV", /* unit */ SCPI_UNIT_VOLT, /* mult */ 1e-6},
-    {/* name */ "MV", /* unit */ SCPI_UNIT_VOLT, /* mult */ 1e-3},
     {/* name */ "V", /* unit */ SCPI_UNIT_VOLT, /* mult */ 1},
-    {/* name */ "KV", /* unit */ SCPI_UNIT_VOLT, /* mult */ 1e3},
 
     /* Electric - resistance */
     {/* name */ "OHM", /* unit */ SCPI_UNIT_OHM, /* mult */ 1},
-    {/* name */ "KOHM", /* unit */ SCPI_UNIT_OHM, /* mult */ 1e3},
-    {/* name */ "MOHM", /* unit */ SCPI_UNIT_OHM, /* mult */ 1e6},
 
     /* Inductance */
-    {/* name */ "UH", /* unit */ SCPI_UNIT_HENRY, /* mult */ 1e-6},
-    {/* name */ "MH", /* unit */ SCPI_UNIT_HENRY, /* mult */ 1e-3},
     {/* name */ "H", /* unit */ SCPI_UNIT_HENRY, /* mult */ 1},
 #endif /* USE_UNITS_ELECTRIC */
 
@@ -140,20 +137,15 @@ const scpi_unit_def_t scpi_units_def[] = {
     {/* name */ "C", /* unit */ SCPI_UNIT_COULOMB, /* mult */ 1},
 
     /* Electric - conductance */
-    {/* name */ "USIE", /* unit */ SCPI_UNIT_SIEMENS, /* mult */ 1e-6},
-    {/* name */ "MSIE", /* unit */ SCPI_UNIT_SIEMENS, /* mult */ 1e-3},
     {/* name */ "SIE", /* unit */ SCPI_UNIT_SIEMENS, /* mult */ 1},
 #endif /* USE_UNITS_ELECTRIC_CHARGE_CONDUCTANCE */
 
 #if USE_UNITS_ENERGY_FORCE_MASS
     /* Energy */
     {/* name */ "J", /* unit */ SCPI_UNIT_JOULE, /* mult */ 1},
-    {/* name */ "KJ", /* unit */ SCPI_UNIT_JOULE, /* mult */ 1e3},
-    {/* name */ "MAJ", /* unit */ SCPI_UNIT_JOULE, /* mult */ 1e6},
 
     /* Force */
     {/* name */ "N", /* unit */ SCPI_UNIT_NEWTON, /* mult */ 1},
-    {/* name */ "KN", /* unit */ SCPI_UNIT_NEWTON, /* mult */ 1e3},
 
     /* Pressure */
     {/* name */ "ATM", /* unit */ SCPI_UNIT_ATMOSPHERE, /* mult */ 1},
@@ -164,8 +156,6 @@ const scpi_unit_def_t scpi_units_def[] = {
     {/* name */ "BAR", /* unit */ SCPI_UNIT_BAR, /* mult */ 1},
 
     {/* name */ "PAL", /* unit */ SCPI_UNIT_PASCAL, /* mult */ 1},
-    {/* name */ "KPAL", /* unit */ SCPI_UNIT_PASCAL, /* mult */ 1e3},
-    {/* name */ "MAPAL", /* unit */ SCPI_UNIT_PASCAL, /* mult */ 1e6},
 
     /* Viscosity kinematic */
     {/* name */ "ST", /* unit */ SCPI_UNIT_STROKES, /* mult */ 1},
@@ -177,7 +167,6 @@ const scpi_unit_def_t scpi_units_def[] = {
     {/* name */ "L", /* unit */ SCPI_UNIT_LITER, /* mult */ 1},
 
     /* Mass */
-    {/* name */ "MG", /* unit */ SCPI_UNIT_KILOGRAM, /* mult */ 1e-6},
     {/* name */ "G", /* unit */ SCPI_UNIT_KILOGRAM, /* mult */ 1e-3},
     {/* name */ "KG", /* unit */ SCPI_UNIT_KILOGRAM, /* mult */ 1},
     {/* name */ "TNE", /* unit */ SCPI_UNIT_KILOGRAM, /* mult */ 1000},
@@ -186,9 +175,6 @@ const scpi_unit_def_t scpi_units_def[] = {
 #if USE_UNITS_FREQUENCY
     /* Frequency */
     {/* name */ "HZ", /* unit */ SCPI_UNIT_HERTZ, /* mult */ 1},
-    {/* name */ "KHZ", /* unit */ SCPI_UNIT_HERTZ, /* mult */ 1e3},
-    {/* name */ "MHZ", /* unit */ SCPI_UNIT_HERTZ, /* mult */ 1e6},
-    {/* name */ "GHZ", /* unit */ SCPI_UNIT_HERTZ, /* mult */ 1e9},
 #endif /* USE_UNITS_FREQUENCY */
 
 #if USE_UNITS_DISTANCE
@@ -202,11 +188,7 @@ const scpi_unit_def_t scpi_units_def[] = {
     {/* name */ "NAMI", /* unit */ SCPI_UNIT_NAUTICAL_MILE, /* mult */ 1},
 #endif /* USE_UNITS_IMPERIAL */
 
-    {/* name */ "NM", /* unit */ SCPI_UNIT_METER, /* mult */ 1e-9},
-    {/* name */ "UM", /* unit */ SCPI_UNIT_METER, /* mult */ 1e-6},
-    {/* name */ "MM", /* unit */ SCPI_UNIT_METER, /* mult */ 1e-3},
     {/* name */ "M", /* unit */ SCPI_UNIT_METER, /* mult */ 1},
-    {/* name */ "KM", /* unit */ SCPI_UNIT_METER, /* mult */ 1e3},
 #endif /* USE_UNITS_DISTANCE */
 
 #if USE_UNITS_LIGHT
@@ -225,9 +207,6 @@ const scpi_unit_def_t scpi_units_def[] = {
     {/* name */ "WB", /* unit */ SCPI_UNIT_WEBER, /* mult */ 1},
 
     /* Magnetic induction */
-    {/* name */ "NT", /* unit */ SCPI_UNIT_TESLA, /* mult */ 1e-9},
-    {/* name */ "UT", /* unit */ SCPI_UNIT_TESLA, /* mult */ 1e-6},
-    {/* name */ "MT", /* unit */ SCPI_UNIT_TESLA, /* mult */ 1e-3},
     {/* name */ "T", /* unit */ SCPI_UNIT_TESLA, /* mult */ 1},
 #endif /* USE_UNITS_MAGNETIC */
 
@@ -256,10 +235,6 @@ const scpi_unit_def_t scpi_units_def[] = {
 
 #if USE_UNITS_TIME
     /* Time */
-    {/* name */ "PS", /* unit */ SCPI_UNIT_SECOND, /* mult */ 1e-12},
-    {/* name */ "NS", /* unit */ SCPI_UNIT_SECOND, /* mult */ 1e-9},
-    {/* name */ "US", /* unit */ SCPI_UNIT_SECOND, /* mult */ 1e-6},
-    {/* name */ "MS", /* unit */ SCPI_UNIT_SECOND, /* mult */ 1e-3},
     {/* name */ "S", /* unit */ SCPI_UNIT_SECOND, /* mult */ 1},
     {/* name */ "MIN", /* unit */ SCPI_UNIT_SECOND, /* mult */ 60},
     {/* name */ "HR", /* unit */ SCPI_UNIT_SECOND, /* mult */ 3600},
@@ -286,20 +261,94 @@ const scpi_choice_def_t scpi_special_numbers_def[] = {
     SCPI_CHOICE_LIST_END,
 };
 
+#if USE_UNITS_HASH
 /**
- * Convert string describing unit to its representation
- * @param units units patterns
+ * Build hash index of units table and reverse index of base units. If the
+ * table is too big for the index, it stays invalid and units are searched
+ * linearly.
+ * @param index
+ * @param units
+ */
+void scpiUnits_BuildIndex(scpi_units_index_t * index, const scpi_unit_def_t * units) {
+    const size_t mask = SCPI_UNITS_HASH_SIZE - 1;
+    size_t i;
+    size_t h;
+    size_t len;
+
+    index->table = units;
+    index->valid = FALSE;
+    memset(index->slot, 0, sizeof (index->slot));
+    memset(index->inverse, 0, sizeof (index->inverse));
+
+    if (units == NULL) {
+        return;
+    }
+
+    for (i = 0; units[i].name != NULL; i++) {
+        if ((i >= UINT8_MAX) || (i >= SCPI_UNITS_HASH_SIZE * 3 / 4)) {
+            return;
+        }
+
+        len = strlen(units[i].name);
+        h = strHashCase(units[i].name, len) & mask;
+        while (index->slot[h]) {
+            if (compareStr(units[index->slot[h] - 1].name, strlen(units[index->slot[h] - 1].name), units[i].name, len)) {
+                break; /* first definition wins, same as linear search */
+            }
+            h = (h + 1) & mask;
+        }
+
+        if (!index->slot[h]) {
+            index->slot[h] = (uint8_t) (i + 1);
+        }
+
+        if ((units[i].mult == 1) && ((size_t) units[i].unit < SCPI_UNIT_COUNT) && !index->inverse[units[i].unit]) {
+            index->inverse[units[i].unit] = (uint8_t) (i + 1);
+        }
+    }
+
+    index->valid = TRUE;
+}
+#endif
+
+/**
+ * Find unit by its exact name
+ * @param context
  * @param unit text representation of unknown unit
  * @param len length of text representation
  * @return pointer of related unit definition or NULL
  */
-static const scpi_unit_def_t * translateUnit(const scpi_unit_def_t * units, const char * unit, const size_t len) {
+static const scpi_unit_def_t * findUnit(scpi_t * context, const char * unit, const size_t len) {
+    const scpi_unit_def_t * units = context->units;
     int i;
 
     if (units == NULL) {
         return NULL;
     }
 
+#if USE_UNITS_HASH
+    scpi_units_index_t * index = &context->units_index;
+
+    if (index->table != units) {
+        scpiUnits_BuildIndex(index, units);
+    }
+
+    if (index->valid) {
+        const size_t mask = SCPI_UNITS_HASH_SIZE - 1;
+        size_t h = strHashCase(unit, len) & mask;
+
+        while (index->slot[h]) {
+            const char * name = units[index->slot[h] - 1].name;
+            if ((SCPIDEFINE_strncasecmp(name, unit, len) == 0) && (name[len] == '\0')) {
+                return &units[index->slot[h] - 1];
+            }
+            h = (h + 1) & mask;
+        }
+
+        return NULL;
+    }
+#endif
+
     for (i = 0; units[i].name != NULL; i++) {
         if (compareStr(unit, len, units[i].name, strlen(units[i].name))) {
             return &units[i];
@@ -309,19 +358,143 @@ static const scpi_unit_def_t * translateUnit(const scpi_unit_def_t * units, cons
     return NULL;
 }
 
+/**
+ * Find power of ten equal to multiplier
+ * @param mult
+ * @return exponent or SCPI_UNIT_INEXACT
+ */
+static int8_t multExponent(double mult) {
+    size_t i;
+
+    if (mult == 1) {
+        return 0;
+    }
+
+    for (i = 0; i < sizeof (unit_prefixes) / sizeof (unit_prefixes[0]); i++) {
+        if (mult == unit_prefixes[i].mult) {
+            return unit_prefixes[i].exponent;
+        }
+    }
+
+    return SCPI_UNIT_INEXACT;
+}
+
+/**
+ * Detect, if SI prefix makes sense for the unit in engineering notation
+ * @param unit
+ * @return
+ */
+static scpi_bool_t unitHasPrefix(const scpi_unit_t unit) {
+    switch (unit) {
+        case SCPI_UNIT_NONE:
+        case SCPI_UNIT_UNITLESS:
+        case SCPI_UNIT_DECIBEL:
+        case SCPI_UNIT_DBM:
+        case SCPI_UNIT_CELSIUS:
+        case SCPI_UNIT_FAHRENHEIT:
+        case SCPI_UNIT_KILOGRAM:
+        case SCPI_UNIT_DEGREE:
+        case SCPI_UNIT_GRADE:
+        case SCPI_UNIT_REVOLUTION:
+        case SCPI_UNIT_DAY:
+        case SCPI_UNIT_YEAR:
+        case SCPI_UNIT_INCH:
+        case SCPI_UNIT_FOOT:
+        case SCPI_UNIT_MILE:
+        case SCPI_UNIT_NAUTICAL_MILE:
+        case SCPI_UNIT_ASTRONOMIC_UNIT:
+        case SCPI_UNIT_PARSEC:
+        case SCPI_UNIT_ATMOSPHERE:
+        case SCPI_UNIT_INCH_OF_MERCURY:
+        case SCPI_UNIT_MM_OF_MERCURY:
+        case SCPI_UNIT_TORT:
+            return FALSE;
+        default:
+            return TRUE;
+    }
+}
+
+/**
+ * Convert string describing unit to its representation. Exact name is
+ * searched first, then the name is split to SI prefix and base unit.
+ * Prefix is accepted only on base units with multiplier 1, where it makes
+ * sense (see unitHasPrefix), and on gram.
+ * @param context
+ * @param unit text representation of unknown unit
+ * @param len length of text representation
+ * @param unit_type result type of unit
+ * @param mult result multiplier to base unit
+ * @param exponent result multiplier as power of ten or SCPI_UNIT_INEXACT
+ * @return TRUE if unit was found
+ */
+static scpi_bool_t translateUnit(scpi_t * context, const char * unit, const size_t len, scpi_unit_t * unit_type, double * mult, int8_t * exponent) {
+    const scpi_unit_def_t * unitDef;
+    int8_t unit_exponent;
+    size_t i;
+
+    unitDef = findUnit(context, unit, len);
+    if (unitDef != NULL) {
+        *unit_type = unitDef->unit;
+        *mult = unitDef->mult;
+        *exponent = multExponent(unitDef->mult);
+        return TRUE;
+    }
+
+    for (i = 0; i < sizeof (unit_prefixes) / sizeof (unit_prefixes[0]); i++) {
+        if ((len <= unit_prefixes[i].len) || (SCPIDEFINE_strncasecmp(unit, unit_prefixes[i].name, unit_prefixes[i].len) != 0)) {
+            continue;
+        }
+
+        unitDef = findUnit(context, unit + unit_prefixes[i].len, len - unit_prefixes[i].len);
+        /* only base units take prefix, gram is the prefixable form of kilogram */
+        if ((unitDef != NULL) && !((unitHasPrefix(unitDef->unit) && (unitDef->mult == 1))
+                || ((unitDef->unit == SCPI_UNIT_KILOGRAM) && (unitDef->mult == 1e-3)))) {
+            continue;
+        }
+        if (unitDef != NULL) {
+            *unit_type = unitDef->unit;
+            *mult = unit_prefixes[i].mult;
+            *exponent = unit_prefixes[i].exponent;
+            if ((unit_prefixes[i].len == 1) && (unit_prefixes[i].name[0] == 'M') && ((unitDef->unit == SCPI_UNIT_OHM) || (unitDef->unit == SCPI_UNIT_HERTZ))) {
+                *mult = 1e6;
+                *exponent = 6;
+            }
+            if (unitDef->mult != 1) {
+                *mult *= unitDef->mult;
+                unit_exponent = multExponent(unitDef->mult);
+                *exponent = (unit_exponent == SCPI_UNIT_INEXACT) ? SCPI_UNIT_INEXACT : (int8_t) (*exponent + unit_exponent);
+            }
+            return TRUE;
+        }
+    }
+
+    return FALSE;
+}
+
 /**
  * Convert unit definition to string
- * @param units units definitions (patterns)
+ * @param context
  * @param unit type of unit
  * @return string representation of unit
  */
-static const char * translateUnitInverse(const scpi_unit_def_t * units, const scpi_unit_t unit) {
+static const char * translateUnitInverse(const scpi_t * context, const scpi_unit_t unit) {
+    const scpi_unit_def_t * units = context->units;
     int i;
 
     if (units == NULL) {
         return NULL;
     }
 
+#if USE_UNITS_HASH
+    /* context is const here, so the index is used only if it is up to date */
+    if ((context->units_index.table == units) && context->units_index.valid) {
+        if (((size_t) unit < SCPI_UNIT_COUNT) && context->units_index.inverse[unit]) {
+            return units[context->units_index.inverse[unit] - 1].name;
+        }
+        return NULL;
+    }
+#endif
+
     for (i = 0; units[i].name != NULL; i++) {
         if ((units[i].unit == unit) && (units[i].mult == 1)) {
             return units[i].name;
@@ -331,6 +504,48 @@ static const char * translateUnitInverse(const scpi_unit_def_t * units, const sc
     return NULL;
 }
 
+/**
+ * Select SI prefix for engineering notation, so the mantissa is in range
+ * 1 to 1000.
+ * @param unit
+ * @param value
+ * @param mantissa result value scaled by the prefix
+ * @return prefix name, empty string for no prefix
+ */
+static const char * selectUnitPrefix(const scpi_unit_t unit, const double value, double * mantissa) {
+    const scpi_bool_t mega = (unit == SCPI_UNIT_OHM) || (unit == SCPI_UNIT_HERTZ);
+    const double abs_value = value < 0 ? -value : value;
+    const size_t count = sizeof (unit_prefixes) / sizeof (unit_prefixes[0]);
+    size_t i;
+
+    *mantissa = value;
+
+    if (abs_value >= 1 && abs_value < 1e3) {
+        return "";
+    }
+
+    for (i = 0; i + 1 < count; i++) {
+        if (abs_value >= unit_prefixes[i].mult) {
+            break;
+        }
+    }
+
+    if (unit_prefixes[i].mult < 1) {
+        if (mega && (unit_prefixes[i].scale == 1e3)) {
+            /* M is mega for OHM and HZ, there is no milli */
+            return "";
+        }
+        *mantissa = value * unit_prefixes[i].scale;
+    } else {
+        *mantissa = value / unit_prefixes[i].scale;
+    }
+
+    if (mega && (unit_prefixes[i].mult == 1e6)) {
+        return "M";
+    }
+    return unit_prefixes[i].name;
+}
+
 /**
  * Transform number to base units
  * @param context
@@ -341,7 +556,9 @@ static const char * translateUnitInverse(const scpi_unit_def_t * units, const sc
  */
 static scpi_bool_t transformNumber(scpi_t * context, const char * unit, const size_t len, scpi_number_t * value) {
     size_t s;
-    const scpi_unit_def_t * unitDef;
+    scpi_unit_t unit_type;
+    double mult;
+    int8_t exponent;
     s = skipWhitespace(unit, len);
 
     if (s == len) {
@@ -349,21 +566,214 @@ static scpi_bool_t transformNumber(scpi_t * context, const char * unit, const si
         return TRUE;
     }
 
-    unitDef = translateUnit(context->units, unit + s, len - s);
-
-    if (unitDef == NULL) {
+    if (!translateUnit(context, unit + s, len - s, &unit_type, &mult, &exponent)) {
         SCPI_ErrorPush(context, SCPI_ERROR_INVALID_SUFFIX);
         return FALSE;
     }
 
-    value->content.value *= unitDef->mult;
-    value->unit = unitDef->unit;
+    value->content.value *= mult;
+    value->unit = unit_type;
+
+#if USE_NUMBER_EXACT
+    if (exponent == SCPI_UNIT_INEXACT) {
+        value->exact = FALSE;
+    } else if (value->mantissa != 0) {
+        value->exponent += exponent;
+    }
+#else
+    (void) exponent;
+#endif
 
     return TRUE;
 }
 
+#if USE_NUMBER_EXACT
 /**
- * Parse parameter as number, number with unit or special value (min, max, default, ...)
+ * Store numeric parameter as integer mantissa and power of ten exponent.
+ * Digits which do not fit to the mantissa are dropped, the value stays
+ * exact only if they are zeros.
+ * @param parameter
+ * @param value
+ */
+static void numberToExact(const scpi_parameter_t * parameter, scpi_number_t * value) {
+    scpi_param_view_t view;
+    scpi_bool_t overflow = FALSE;
+    int32_t exponent = 0;
+    uint64_t mantissa = 0;
+    size_t count;
+    size_t i;
+
+    SCPI_ParamToView(parameter, &view);
+    value->exact = TRUE;
+    value->negative = view.negative;
+    value->mantissa = 0;
+    value->exponent = 0;
+
+    if (view.kind == SCPI_VIEW_NONDECIMAL) {
+        strBaseToUInt64(view.integer, view.integer_len, &value->mantissa, view.base, &overflow);
+        value->exact = overflow ? FALSE : TRUE;
+        return;
+    }
+
+    for (i = 0; i < view.exponent_len; i++) {
+        if (isdigit((uint8_t) view.exponent[i]) && (exponent < 10000)) {
+            exponent = exponent * 10 + (view.exponent[i] - '0');
+        }
+    }
+    if ((view.exponent_len > 0) && (view.exponent[0] == '-')) {
+        exponent = -exponent;
+    }
+
+    count = view.integer_len + view.fraction_len;
+    exponent -= (int32_t) view.fraction_len;
+    for (i = 0; i < count; i++) {
+        char c = (i < view.integer_len) ? view.integer[i] : view.fraction[i - view.integer_len];
+        uint8_t digit = (uint8_t) (c - '0');
+
+        if (!overflow && (mantissa > (UINT64_MAX - digit) / 10)) {
+            overflow = TRUE;
+        }
+
+        if (overflow) {
+            exponent++;
+            if (digit != 0) {
+                value->exact = FALSE;
+            }
+        } else {
+            mantissa = mantissa * 10 + digit;
+        }
+    }
+
+    if (mantissa == 0) {
+        return;
+    }
+
+    while ((mantissa % 10) == 0) {
+        mantissa /= 10;
+        exponent++;
+    }
+
+    if ((exponent > 10000) || (exponent < -10000)) {
+        value->exact = FALSE;
+        return;
+    }
+
+    value->mantissa = mantissa;
+    value->exponent = (int16_t) exponent;
+}
+
+/**
+ * Convert number to signed/unsigned 64 bit integer. Exact mantissa and
+ * exponent are used if available, double value otherwise. Nondecimal
+ * numbers are bit patterns of the type.
+ * @param context
+ * @param value
+ * @param result
+ * @param sign
+ * @return TRUE if successful, else error is pushed
+ */
+static scpi_bool_t numberToInteger(scpi_t * context, const scpi_number_t * value, uint64_t * result, scpi_bool_t sign) {
+    scpi_bool_t negative;
+    uint64_t mag;
+    uint64_t limit;
+    int16_t exponent;
+
+    if (!value || !result) {
+        SCPI_ErrorPush(context, SCPI_ERROR_SYSTEM_ERROR);
+        return FALSE;
+    }
+
+    if (value->special) {
+        SCPI_ErrorPush(context, SCPI_ERROR_DATA_TYPE_ERROR);
+        return FALSE;
+    }
+
+    if (value->exact) {
+        mag = value->mantissa;
+        negative = value->negative;
+        for (exponent = value->exponent; (exponent < 0) && (mag != 0); exponent++) {
+            if ((mag % 10) != 0) {
+                SCPI_ErrorPush(context, SCPI_ERROR_ILLEGAL_PARAMETER_VALUE);
+                return FALSE;
+            }
+            mag /= 10;
+        }
+        for (; (exponent > 0) && (mag != 0); exponent--) {
+            if (mag > UINT64_MAX / 10) {
+                SCPI_ErrorPush(context, SCPI_ERROR_DATA_OUT_OF_RANGE);
+                return FALSE;
+            }
+            mag *= 10;
+        }
+    } else {
+        double val = value->content.value;
+
+        if (val != val) {
+            SCPI_ErrorPush(context, SCPI_ERROR_ILLEGAL_PARAMETER_VALUE);
+            return FALSE;
+        }
+        negative = (val < 0) ? TRUE : FALSE;
+        val = negative ? -val : val;
+        if (val >= 18446744073709551616.0) {
+            SCPI_ErrorPush(context, SCPI_ERROR_DATA_OUT_OF_RANGE);
+            return FALSE;
+        }
+        mag = (uint64_t) val;
+        if ((double) mag != val) {
+            SCPI_ErrorPush(context, SCPI_ERROR_ILLEGAL_PARAMETER_VALUE);
+            return FALSE;
+        }
+    }
+
+    if (value->base != 10) {
+        limit = UINT64_MAX;
+    } else if (sign) {
+        limit = (uint64_t) INT64_MAX + (negative ? 1 : 0);
+    } else {
+        limit = negative ? 0 : UINT64_MAX;
+    }
+
+    if (mag > limit) {
+        SCPI_ErrorPush(context, SCPI_ERROR_DATA_OUT_OF_RANGE);
+        return FALSE;
+    }
+
+    *result = negative ? (uint64_t) 0 - mag : mag;
+    return TRUE;
+}
+
+/**
+ * Convert number to signed 64 bit integer without rounding
+ * @param context
+ * @param value number read by SCPI_ParamNumber
+ * @param result
+ * @return TRUE if value is integral and in range
+ */
+scpi_bool_t SCPI_NumberToInt64(scpi_t * context, const scpi_number_t * value, int64_t * result) {
+    uint64_t val;
+
+    if (numberToInteger(context, value, result ? &val : NULL, TRUE)) {
+        *result = (int64_t) val;
+        return TRUE;
+    }
+    return FALSE;
+}
+
+/**
+ * Convert number to unsigned 64 bit integer without rounding
+ * @param context
+ * @param value number read by SCPI_ParamNumber
+ * @param result
+ * @return TRUE if value is integral and in range
+ */
+scpi_bool_t SCPI_NumberToUInt64(scpi_t * context, const scpi_number_t * value, uint64_t * result) {
+    return numberToInteger(context, value, result, FALSE);
+}
+#endif
+
+/**
+ * Parse parameter as number, number with unit, special value (min, max, default, ...)
+ * or arithmetic expression, if enabled by USE_EXPRESSION_EVAL
  * @param context
  * @param value return value
  * @param mandatory if the parameter is mandatory
@@ -398,8 +808,14 @@ scpi_bool_t SCPI_ParamNumber(scpi_t * context, const scpi_choice_def_t * special
         case SCPI_TOKEN_BINNUM:
         case SCPI_TOKEN_DECIMAL_NUMERIC_PROGRAM_DATA_WITH_SUFFIX:
         case SCPI_TOKEN_PROGRAM_MNEMONIC:
+#if USE_EXPRESSION_EVAL
+        case SCPI_TOKEN_PROGRAM_EXPRESSION:
+#endif
             value->unit = SCPI_UNIT_NONE;
             value->special = FALSE;
+#if USE_NUMBER_EXACT
+            value->exact = FALSE;
+#endif
             result = TRUE;
             break;
         default:
@@ -410,6 +826,9 @@ scpi_bool_t SCPI_ParamNumber(scpi_t * context, const scpi_choice_def_t * special
         case SCPI_TOKEN_DECIMAL_NUMERIC_PROGRAM_DATA:
         case SCPI_TOKEN_DECIMAL_NUMERIC_PROGRAM_DATA_WITH_SUFFIX:
         case SCPI_TOKEN_PROGRAM_MNEMONIC:
+#if USE_EXPRESSION_EVAL
+        case SCPI_TOKEN_PROGRAM_EXPRESSION:
+#endif
             value->base = 10;
             break;
         case SCPI_TOKEN_BINNUM:
@@ -427,16 +846,13 @@ scpi_bool_t SCPI_ParamNumber(scpi_t * context, const scpi_choice_def_t * special
 
     switch (param.type) {
         case SCPI_TOKEN_DECIMAL_NUMERIC_PROGRAM_DATA:
-            SCPI_ParamToDouble(context, &param, &(value->content.value));
-            break;
         case SCPI_TOKEN_HEXNUM:
-            SCPI_ParamToDouble(context, &param, &(value->content.value));
-            break;
         case SCPI_TOKEN_OCTNUM:
-            SCPI_ParamToDouble(context, &param, &(value->content.value));
-            break;
         case SCPI_TOKEN_BINNUM:
             SCPI_ParamToDouble(context, &param, &(value->content.value));
+#if USE_NUMBER_EXACT
+            numberToExact(&param, value);
+#endif
             break;
         case SCPI_TOKEN_DECIMAL_NUMERIC_PROGRAM_DATA_WITH_SUFFIX:
             scpiLex_DecimalNumericProgramData(&state, &token);
@@ -444,6 +860,9 @@ scpi_bool_t SCPI_ParamNumber(scpi_t * context, const scpi_choice_def_t * special
             scpiLex_SuffixProgramData(&state, &token);
 
             SCPI_ParamToDouble(context, &param, &(value->content.value));
+#if USE_NUMBER_EXACT
+            numberToExact(&param, value);
+#endif
 
             result = transformNumber(context, token.ptr, token.len, value);
             break;
@@ -458,7 +877,13 @@ scpi_bool_t SCPI_ParamNumber(scpi_t * context, const scpi_choice_def_t * special
             value->content.tag = tag;
 
             break;
+#if USE_EXPRESSION_EVAL
+        case SCPI_TOKEN_PROGRAM_EXPRESSION:
+            result = SCPI_ExprEvalDouble(context, &param, &(value->content.value)) == SCPI_EXPR_OK ? TRUE : FALSE;
+            break;
+#endif
         default:
+            SCPI_ErrorPush(context, SCPI_ERROR_DATA_TYPE_ERROR);
             result = FALSE;
     }
 
@@ -468,14 +893,18 @@ scpi_bool_t SCPI_ParamNumber(scpi_t * context, const scpi_choice_def_t * special
 /**
  * Convert scpi_number_t to string
  * @param context
+ * @param special
  * @param value number value
  * @param str target string
  * @param len max length of string including null-character termination
+ * @param engineering use SI prefix of the unit
  * @return number of chars written to string
  */
-size_t SCPI_NumberToStr(const scpi_t * context, const scpi_choice_def_t * special, scpi_number_t * value, char * str, const size_t len) {
+static size_t numberToStr(const scpi_t * context, const scpi_choice_def_t * special, scpi_number_t * value, char * str, const size_t len, const scpi_bool_t engineering) {
     const char * type;
     const char * unit;
+    const char * prefix = "";
+    double mantissa;
     size_t result;
 
     if (!value || !str || len==0) {
@@ -494,15 +923,26 @@ size_t SCPI_NumberToStr(const scpi_t * context, const scpi_choice_def_t * specia
         }
     }
 
-    result = SCPI_DoubleToStr(value->content.value, str, len);
+    unit = translateUnitInverse(context, value->unit);
 
-    if (result + 1 < len) {
-        unit = translateUnitInverse(context->units, value->unit);
+    if (engineering && unit && unitHasPrefix(value->unit) && (value->content.value != 0)
+            && SCPIDEFINE_isfinite(value->content.value)) {
+        prefix = selectUnitPrefix(value->unit, value->content.value, &mantissa);
+    } else {
+        mantissa = value->content.value;
+    }
+
+    result = SCPI_DoubleToStr(mantissa, str, len);
 
+    if (result + 1 < len) {
         if (unit) {
             strncat(str, " ", len - result);
             if (result + 2 < len) {
-                strncat(str, unit, len - result - 1);
+                strncat(str, prefix, len - result - 2);
+                result = strlen(str);
+                if (result + 1 < len) {
+                    strncat(str, unit, len - result - 1);
+                }
             }
             result = strlen(str);
         }
@@ -510,3 +950,28 @@ size_t SCPI_NumberToStr(const scpi_t * context, const scpi_choice_def_t * specia
 
     return result;
 }
+
+/**
+ * Convert scpi_number_t to string
+ * @param context
+ * @param value number value
+ * @param str target string
+ * @param len max length of string including null-character termination
+ * @return number of chars written to string
+ */
+size_t SCPI_NumberToStr(const scpi_t * context, const scpi_choice_def_t * special, scpi_number_t * value, char * str, const size_t len) {
+    return numberToStr(context, special, value, str, len, FALSE);
+}
+
+/**
+ * Convert scpi_number_t to string in engineering notation, the value is
+ * scaled by SI prefix of its unit, e.g. 1.5 MV instead of 0.0015 V
+ * @param context
+ * @param value number value
+ * @param str target string
+ * @param len max length of string including null-character termination
+ * @return number of chars written to string
+ */
+size_t SCPI_NumberToStrEng(const scpi_t * context, const scpi_choice_def_t * special, scpi_number_t * value, char * str, const size_t len) {
+    return numberToStr(context, special, value, str, len, TRUE);
+}
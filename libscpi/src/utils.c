@@ -44,7 +44,6 @@
 #include "utils_private.h"
 #include "scpi/utils.h"
 
-static size_t patternSeparatorShortPos(const char * pattern, size_t len);
 static size_t patternSeparatorPos(const char * pattern, size_t len);
 static size_t cmdSeparatorPos(const char * cmd, size_t len);
 
@@ -67,8 +66,163 @@ char * strnpbrk(const char *str, const size_t size, const char *set) {
     return (NULL);
 }
 
+static const char digitPairs[201] =
+    "0001020304050607080910111213141516171819"
+    "2021222324252627282930313233343536373839"
+    "4041424344454647484950515253545556575859"
+    "6061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+static const char hexDigits[] = "0123456789ABCDEF";
+
+static const uint32_t pow10_32[10] = {
+    1UL, 10UL, 100UL, 1000UL, 10000UL, 100000UL, 1000000UL, 10000000UL,
+    100000000UL, 1000000000UL
+};
+
+static const uint64_t pow10_64[20] = {
+    1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL,
+    10000000ULL, 100000000ULL, 1000000000ULL, 10000000000ULL,
+    100000000000ULL, 1000000000000ULL, 10000000000000ULL,
+    100000000000000ULL, 1000000000000000ULL, 10000000000000000ULL,
+    100000000000000000ULL, 1000000000000000000ULL, 10000000000000000000ULL
+};
+
+/**
+ * Number of significant bits
+ * @param val   nonzero value
+ * @return position of the highest set bit plus one
+ */
+static uint8_t bitLength32(const uint32_t val) {
+#if defined(__GNUC__) && (__GNUC__ >= 4)
+    return (uint8_t) (32 - __builtin_clz(val));
+#else
+    uint32_t v = val;
+    uint8_t n = 1;
+    if (v >> 16) { v >>= 16; n += 16; }
+    if (v >> 8) { v >>= 8; n += 8; }
+    if (v >> 4) { v >>= 4; n += 4; }
+    if (v >> 2) { v >>= 2; n += 2; }
+    if (v >> 1) { n += 1; }
+    return n;
+#endif
+}
+
+static uint8_t bitLength64(const uint64_t val) {
+    const uint32_t hi = (uint32_t) (val >> 32);
+    return hi ? (uint8_t) (32 + bitLength32(hi)) : bitLength32((uint32_t) val);
+}
+
+/**
+ * Number of digits of nonzero value in specific base
+ * @param val   nonzero value
+ * @param bits  result of bitLength32 or bitLength64
+ * @param base  2, 8, 10 or 16
+ * @return number of digits
+ */
+static size_t digitCount32(const uint32_t val, const uint8_t bits, const int8_t base) {
+    uint8_t t;
+
+    switch (base) {
+        case 2:
+            return bits;
+        case 8:
+            return (bits + 2) / 3;
+        case 16:
+            return (bits + 3) / 4;
+        default:
+            /* 1233 / 4096 ~ log10(2) */
+            t = (uint8_t) ((bits * 1233) >> 12);
+            return t + 1 - ((val < pow10_32[t]) ? 1 : 0);
+    }
+}
+
+static size_t digitCount64(const uint64_t val, const uint8_t bits, const int8_t base) {
+    uint8_t t;
+
+    switch (base) {
+        case 2:
+            return bits;
+        case 8:
+            return (bits + 2) / 3;
+        case 16:
+            return (bits + 3) / 4;
+        default:
+            t = (uint8_t) ((bits * 1233) >> 12);
+            return t + 1 - ((val < pow10_64[t]) ? 1 : 0);
+    }
+}
+
+/**
+ * Write decimal digits backwards, two digits per step
+ * @param val   value
+ * @param end   pointer behind the last digit
+ * @return pointer to the first written digit
+ */
+static char * writeDecimal32(uint32_t val, char * end) {
+    while (val >= 100) {
+        const uint32_t i = (val % 100) * 2;
+        val /= 100;
+        *--end = digitPairs[i + 1];
+        *--end = digitPairs[i];
+    }
+    if (val >= 10) {
+        *--end = digitPairs[val * 2 + 1];
+        *--end = digitPairs[val * 2];
+    } else {
+        *--end = (char) ('0' + val);
+    }
+    return end;
+}
+
+static char * writeDecimal64(uint64_t val, char * end) {
+    /* split to 8 digit chunks, so only few 64bit divisions are needed */
+    while (val > 0xFFFFFFFFULL) {
+        const uint64_t q = val / 100000000ULL;
+        uint32_t low = (uint32_t) (val - q * 100000000ULL);
+        char * chunk = end - 8;
+        end = writeDecimal32(low, end);
+        while (end > chunk) {
+            *--end = '0';
+        }
+        val = q;
+    }
+    return writeDecimal32((uint32_t) val, end);
+}
+
+/**
+ * Write digits of power of two base backwards
+ * @param val   value
+ * @param end   pointer behind the last digit
+ * @param count number of digits
+ * @param shift bits per digit, 1, 3 or 4
+ */
+static void writePow2Base32(uint32_t val, char * end, size_t count, const uint8_t shift) {
+    const uint32_t mask = (1UL << shift) - 1;
+    while (count--) {
+        *--end = hexDigits[val & mask];
+        val >>= shift;
+    }
+}
+
+static void writePow2Base64(uint64_t val, char * end, size_t count, const uint8_t shift) {
+    const uint32_t mask = (1UL << shift) - 1;
+    /* switch to 32bit arithmetic as soon as possible, it is faster on 32bit targets */
+    while (count && (val >> 32)) {
+        *--end = hexDigits[(uint32_t) val & mask];
+        val >>= shift;
+        count--;
+    }
+    writePow2Base32((uint32_t) val, end, count, shift);
+}
+
 /**
  * Converts signed/unsigned 32-bit integer value to string in specific base
+ *
+ * Number of digits is computed in advance, so digits are written in place.
+ * Decimal digits are converted two at a time by table, other bases by bit
+ * shifts. If the buffer is too small, the output is truncated.
+ *
  * @param val   integer value
  * @param str   converted textual representation
  * @param len   string buffer length
@@ -77,56 +231,55 @@ char * strnpbrk(const char *str, const size_t size, const char *set) {
  * @return number of bytes written to str (without '\0')
  */
 size_t UInt32ToStrBaseSign(const uint32_t val, char * str, const size_t len, int8_t base, const scpi_bool_t sign) {
-    const char digits[] = "0123456789ABCDEF";
-
-#define ADD_CHAR(c) if (pos < len) str[pos++] = (c)
-    size_t pos = 0;
+    char buffer[33];
+    char * dst;
+    size_t count;
+    size_t total;
     uint32_t uval = val;
+    scpi_bool_t negative = FALSE;
 
-    if (uval == 0) {
-        ADD_CHAR('0');
-    } else {
-        uint32_t x = 0;
+    if (base != 2 && base != 8 && base != 16) {
+        base = 10;
+    }
 
-        switch (base) {
-            case 2:
-                x = 0x80000000L;
-                break;
-            case 8:
-                x = 0x40000000L;
-                break;
-            default:
-            case 10:
-                base = 10;
-                x = 1000000000L;
-                break;
-            case 16:
-                x = 0x10000000L;
-                break;
-        }
+    /* add sign for numbers in base 10 */
+    if (sign && ((int32_t) val < 0) && (base == 10)) {
+        uval = -val;
+        negative = TRUE;
+    }
 
-        /* add sign for numbers in base 10 */
-        if (sign && ((int32_t) val < 0) && (base == 10)) {
-            uval = -val;
-            ADD_CHAR('-');
-        }
+    count = (uval == 0) ? 1 : digitCount32(uval, bitLength32(uval), base);
+    total = count + (negative ? 1 : 0);
 
-        /* remove leading zeros */
-        while ((uval / x) == 0) {
-            x /= base;
-        }
+    /* write directly to str, if it fits */
+    dst = (total <= len) ? str : buffer;
 
-        do {
-            int_fast8_t digit = (uint8_t) (uval / x);
-            ADD_CHAR(digits[digit]);
-            uval -= digit * x;
-            x /= base;
-        } while (x && (pos < len));
+    if (negative) {
+        dst[0] = '-';
     }
 
-    if (pos < len) str[pos] = 0;
-    return pos;
-#undef ADD_CHAR
+    switch (base) {
+        case 2:
+            writePow2Base32(uval, dst + total, count, 1);
+            break;
+        case 8:
+            writePow2Base32(uval, dst + total, count, 3);
+            break;
+        case 16:
+            writePow2Base32(uval, dst + total, count, 4);
+            break;
+        default:
+            writeDecimal32(uval, dst + total);
+            break;
+    }
+
+    if (dst != str) {
+        total = len;
+        memcpy(str, buffer, total);
+    }
+
+    if (total < len) str[total] = 0;
+    return total;
 }
 
 /**
@@ -154,6 +307,9 @@ size_t SCPI_UInt32ToStrBase(const uint32_t val, char * str, const size_t len, co
 
 /**
  * Converts signed/unsigned 64-bit integer value to string in specific base
+ *
+ * See UInt32ToStrBaseSign
+ *
  * @param val   integer value
  * @param str   converted textual representation
  * @param len   string buffer length
@@ -162,54 +318,55 @@ size_t SCPI_UInt32ToStrBase(const uint32_t val, char * str, const size_t len, co
  * @return number of bytes written to str (without '\0')
  */
 size_t UInt64ToStrBaseSign(const uint64_t val, char * str, const size_t len, int8_t base, const scpi_bool_t sign) {
-    const char digits[] = "0123456789ABCDEF";
-
-#define ADD_CHAR(c) if (pos < len) str[pos++] = (c)
-    size_t pos = 0;
+    char buffer[65];
+    char * dst;
+    size_t count;
+    size_t total;
     uint64_t uval = val;
+    scpi_bool_t negative = FALSE;
 
-    if (uval == 0) {
-        ADD_CHAR('0');
-    } else {
-        uint64_t x = 0;
+    if (base != 2 && base != 8 && base != 16) {
+        base = 10;
+    }
 
-        switch (base) {
-            case 2:
-            case 8:
-                x = 0x8000000000000000ULL;
-                break;
-            default:
-            case 10:
-                x = 10000000000000000000ULL;
-                base = 10;
-                break;
-            case 16:
-                x = 0x1000000000000000ULL;
-                break;
-        }
+    /* add sign for numbers in base 10 */
+    if (sign && ((int64_t) val < 0) && (base == 10)) {
+        uval = -val;
+        negative = TRUE;
+    }
 
-        /* add sign for numbers in base 10 */
-        if (sign && ((int64_t) val < 0) && (base == 10)) {
-            uval = -val;
-            ADD_CHAR('-');
-        }
+    count = (uval == 0) ? 1 : digitCount64(uval, bitLength64(uval), base);
+    total = count + (negative ? 1 : 0);
 
-        /* remove leading zeros */
-        while ((uval / x) == 0) {
-            x /= base;
-        }
+    /* write directly to str, if it fits */
+    dst = (total <= len) ? str : buffer;
 
-        do {
-            int_fast8_t digit = (uint8_t) (uval / x);
-            ADD_CHAR(digits[digit]);
-            uval -= digit * x;
-            x /= base;
-        } while (x && (pos < len));
+    if (negative) {
+        dst[0] = '-';
     }
 
-    if (pos < len) str[pos] = 0;
-    return pos;
-#undef ADD_CHAR
+    switch (base) {
+        case 2:
+            writePow2Base64(uval, dst + total, count, 1);
+            break;
+        case 8:
+            writePow2Base64(uval, dst + total, count, 3);
+            break;
+        case 16:
+            writePow2Base64(uval, dst + total, count, 4);
+            break;
+        default:
+            writeDecimal64(uval, dst + total);
+            break;
+    }
+
+    if (dst != str) {
+        total = len;
+        memcpy(str, buffer, total);
+    }
+
+    if (total < len) str[total] = 0;
+    return total;
 }
 
 /**
@@ -235,6 +392,85 @@ size_t SCPI_UInt64ToStrBase(const uint64_t val, char * str, const size_t len, co
     return UInt64ToStrBaseSign(val, str, len, base, FALSE);
 }
 
+#if USE_PACKED_DATA_FORMAT
+
+/**
+ * Read one unsigned LEB128 varint
+ * @param data
+ * @param len
+ * @param pos   position in data, updated
+ * @param val   decoded value
+ * @return FALSE if data are truncated or value is too long
+ */
+static scpi_bool_t readVarint(const uint8_t * data, size_t len, size_t * pos, uint64_t * val) {
+    uint64_t result = 0;
+    unsigned shift;
+
+    for (shift = 0; shift < 64; shift += 7) {
+        uint8_t byte;
+        if (*pos >= len) {
+            return FALSE;
+        }
+        byte = data[(*pos)++];
+        result |= (uint64_t) (byte & 0x7F) << shift;
+        if (!(byte & 0x80)) {
+            *val = result;
+            return TRUE;
+        }
+    }
+    return FALSE;
+}
+
+/**
+ * Reference decoder of FORMat:DATA PACKed block payload
+ *
+ * Payload is SCPI_PACKED_MAGIC, SCPI_PACKED_VERSION, number of items and
+ * the items. All numbers are unsigned LEB128 varints, each item is zig-zag
+ * encoded difference to the previous item, first item is relative to 0.
+ *
+ * @param data      block payload (without #<n><length> header)
+ * @param len       payload length
+ * @param values    decoded values
+ * @param i_count   size of values
+ * @param o_count   number of items in the payload
+ * @return FALSE if payload is malformed or values is too small
+ */
+scpi_bool_t SCPI_PackedDecode(const void * data, size_t len, int32_t * values, size_t i_count, size_t * o_count) {
+    const uint8_t * bytes = (const uint8_t *) data;
+    size_t pos = 2;
+    uint64_t count;
+    uint64_t zigzag;
+    int64_t val = 0;
+    size_t i;
+
+    *o_count = 0;
+    if (len < 3 || bytes[0] != SCPI_PACKED_MAGIC || bytes[1] != SCPI_PACKED_VERSION) {
+        return FALSE;
+    }
+    if (!readVarint(bytes, len, &pos, &count) || (uint64_t) (size_t) count != count) {
+        return FALSE;
+    }
+    *o_count = (size_t) count;
+    if (count > i_count) {
+        return FALSE;
+    }
+
+    for (i = 0; i < count; i++) {
+        /* difference of two 32 bit values has at most 33 bits */
+        if (!readVarint(bytes, len, &pos, &zigzag) || zigzag >> 34) {
+            return FALSE;
+        }
+        val += (int64_t) (zigzag >> 1) ^ -(int64_t) (zigzag & 1);
+        if (val < INT32_MIN || val > INT32_MAX) {
+            return FALSE;
+        }
+        values[i] = (int32_t) val;
+    }
+
+    return pos == len ? TRUE : FALSE;
+}
+#endif /* USE_PACKED_DATA_FORMAT */
+
 /**
  * Converts float (32 bit) value to string
  * @param val   long value
@@ -259,66 +495,287 @@ size_t SCPI_DoubleToStr(const double val, char * str, const size_t len) {
     return strlen(str);
 }
 
+/**
+ * Load eight characters, first character is the most significant byte
+ * @param str
+ * @return
+ */
+static uint64_t loadEightChars(const char * str) {
+    const uint8_t * p = (const uint8_t *) str;
+    return ((uint64_t) p[0] << 56) | ((uint64_t) p[1] << 48) | ((uint64_t) p[2] << 40) | ((uint64_t) p[3] << 32)
+            | ((uint64_t) p[4] << 24) | ((uint64_t) p[5] << 16) | ((uint64_t) p[6] << 8) | (uint64_t) p[7];
+}
+
+/**
+ * Convert eight digits at once (SWAR)
+ * @param chunk eight characters loaded by loadEightChars
+ * @param base 2, 8, 10 or 16
+ * @param val value of the digits
+ * @return FALSE if some character is not a digit in the base
+ */
+static scpi_bool_t eightDigitsToUInt(uint64_t chunk, const int8_t base, uint64_t * val) {
+    const uint64_t ones = 0x0101010101010101ull;
+    const uint64_t high = 0x8080808080808080ull;
+    unsigned bits;
+
+    switch (base) {
+        case 10:
+            /* '0'..'9' is 0x30..0x39, adding 6 must not leave this range */
+            if (((chunk & 0xF0F0F0F0F0F0F0F0ull) | (((chunk + 0x0606060606060606ull) & 0xF0F0F0F0F0F0F0F0ull) >> 4)) != 0x3333333333333333ull) {
+                return FALSE;
+            }
+            chunk -= 0x3030303030303030ull;
+            chunk = ((chunk >> 8) & 0x00FF00FF00FF00FFull) * 10 + (chunk & 0x00FF00FF00FF00FFull);
+            chunk = ((chunk >> 16) & 0x0000FFFF0000FFFFull) * 100 + (chunk & 0x0000FFFF0000FFFFull);
+            *val = (chunk >> 32) * 10000 + (chunk & 0xFFFFFFFFull);
+            return TRUE;
+        case 16:
+        {
+            uint64_t lower;
+            uint64_t digit;
+            uint64_t letter;
+
+            if (chunk & high) {
+                return FALSE;
+            }
+            /* bytes are below 0x80, so byte-wise comparison by addition does not carry */
+            lower = chunk | 0x2020202020202020ull;
+            digit = ((chunk + (0x80 - '0') * ones) & ~(chunk + (0x80 - '9' - 1) * ones)) & high;
+            letter = ((lower + (0x80 - 'a') * ones) & ~(lower + (0x80 - 'f' - 1) * ones)) & high;
+            if ((digit | letter) != high) {
+                return FALSE;
+            }
+            chunk = (lower & 0x0F0F0F0F0F0F0F0Full) + (letter >> 7) * 9;
+            bits = 4;
+            break;
+        }
+        case 8:
+            if ((chunk & 0xF8F8F8F8F8F8F8F8ull) != 0x3030303030303030ull) {
+                return FALSE;
+            }
+            chunk &= 0x0707070707070707ull;
+            bits = 3;
+            break;
+        case 2:
+            if ((chunk & 0xFEFEFEFEFEFEFEFEull) != 0x3030303030303030ull) {
+                return FALSE;
+            }
+            chunk &= ones;
+            bits = 1;
+            break;
+        default:
+            return FALSE;
+    }
+
+    /* pack digits of power of two bases together */
+    chunk = (chunk | (chunk >> (8 - bits))) & (0x0001000100010001ull * ((1u << (2 * bits)) - 1));
+    chunk = (chunk | (chunk >> (16 - 2 * bits))) & (0x0000000100000001ull * ((1u << (4 * bits)) - 1));
+    *val = (chunk | (chunk >> (32 - 4 * bits))) & ((1ull << (8 * bits)) - 1);
+    return TRUE;
+}
+
+static unsigned digitValue(const char c) {
+    if (c >= '0' && c <= '9') {
+        return (unsigned) (c - '0');
+    }
+    if (c >= 'a' && c <= 'z') {
+        return (unsigned) (c - 'a' + 10);
+    }
+    if (c >= 'A' && c <= 'Z') {
+        return (unsigned) (c - 'A' + 10);
+    }
+    return 36;
+}
+
+/**
+ * Converts string to integer magnitude and sign
+ *
+ * Leading white space and sign are accepted for all bases. Eight digits are
+ * converted at once while they fit.
+ *
+ * @param str       string value
+ * @param len       string length
+ * @param val       magnitude, UINT64_MAX on overflow
+ * @param negative  sign
+ * @param base      2, 8, 10 or 16
+ * @param overflow  set to TRUE if magnitude does not fit 64 bits
+ * @return number of bytes used in string, 0 if there are no digits
+ */
+static size_t strBaseToMagnitude(const char * str, const size_t len, uint64_t * val, scpi_bool_t * negative, const int8_t base, scpi_bool_t * overflow) {
+    const uint64_t limit = UINT64_MAX / (uint64_t) base;
+    const unsigned limit_digit = (unsigned) (UINT64_MAX % (uint64_t) base);
+    const uint64_t chunk_scale = base == 10 ? 100000000ull : (base == 16 ? 1ull << 32 : (base == 8 ? 1ull << 24 : 1ull << 8));
+    uint64_t value = 0;
+    size_t pos = 0;
+    size_t start;
+
+    *negative = FALSE;
+    *overflow = FALSE;
+
+    while (pos < len && isspace((unsigned char) str[pos])) {
+        pos++;
+    }
+    if (pos < len && (str[pos] == '+' || str[pos] == '-')) {
+        *negative = str[pos] == '-';
+        pos++;
+    }
+    start = pos;
+
+    while (len - pos >= 8) {
+        uint64_t chunk;
+        if (!eightDigitsToUInt(loadEightChars(&str[pos]), base, &chunk)) {
+            break;
+        }
+        if (value > (UINT64_MAX - chunk) / chunk_scale) {
+            *overflow = TRUE;
+        } else {
+            value = value * chunk_scale + chunk;
+        }
+        pos += 8;
+    }
+
+    for (; pos < len; pos++) {
+        const unsigned digit = digitValue(str[pos]);
+        if (digit >= (unsigned) base) {
+            break;
+        }
+        if (value > limit || (value == limit && digit > limit_digit)) {
+            *overflow = TRUE;
+        } else {
+            value = value * (uint64_t) base + digit;
+        }
+    }
+
+    if (pos == start) {
+        *val = 0;
+        *negative = FALSE;
+        return 0;
+    }
+
+    *val = *overflow ? UINT64_MAX : value;
+    return pos;
+}
+
 /**
  * Converts string to signed 32bit integer representation
- * @param str   string value
- * @param val   32bit integer result
- * @param base
- * @return      number of bytes used in string
+ * @param str       string value
+ * @param len       string length
+ * @param val       32bit integer result, saturated on overflow
+ * @param base      2, 8, 10 or 16
+ * @param overflow  set to TRUE if the value does not fit, can be NULL
+ * @return          number of bytes used in string
  */
-size_t strBaseToInt32(const char * str, int32_t * val, const int8_t base) {
-    char * endptr;
-    *val = strtol(str, &endptr, base);
-    return endptr - str;
+size_t strBaseToInt32(const char * str, const size_t len, int32_t * val, const int8_t base, scpi_bool_t * overflow) {
+    int64_t result;
+    size_t used = strBaseToInt64(str, len, &result, base, overflow);
+
+    if (result > INT32_MAX || result < INT32_MIN) {
+        result = result > 0 ? INT32_MAX : INT32_MIN;
+        if (overflow) {
+            *overflow = TRUE;
+        }
+    }
+    *val = (int32_t) result;
+    return used;
 }
 
 /**
  * Converts string to unsigned 32bit integer representation
- * @param str   string value
- * @param val   32bit integer result
- * @param base
- * @return      number of bytes used in string
+ * @param str       string value
+ * @param len       string length
+ * @param val       32bit integer result, saturated on overflow
+ * @param base      2, 8, 10 or 16
+ * @param overflow  set to TRUE if the value does not fit, can be NULL
+ * @return          number of bytes used in string
  */
-size_t strBaseToUInt32(const char * str, uint32_t * val, const int8_t base) {
-    char * endptr;
-    *val = strtoul(str, &endptr, base);
-    return endptr - str;
+size_t strBaseToUInt32(const char * str, const size_t len, uint32_t * val, const int8_t base, scpi_bool_t * overflow) {
+    uint64_t result;
+    size_t used = strBaseToUInt64(str, len, &result, base, overflow);
+
+    if (result > UINT32_MAX) {
+        result = UINT32_MAX;
+        if (overflow) {
+            *overflow = TRUE;
+        }
+    }
+    *val = (uint32_t) result;
+    return used;
 }
 
 /**
  * Converts string to signed 64bit integer representation
- * @param str   string value
- * @param val   64bit integer result
- * @param base
- * @return      number of bytes used in string
+ * @param str       string value
+ * @param len       string length
+ * @param val       64bit integer result, saturated on overflow
+ * @param base      2, 8, 10 or 16
+ * @param overflow  set to TRUE if the value does not fit, can be NULL
+ * @return          number of bytes used in string
  */
-size_t strBaseToInt64(const char * str, int64_t * val, const int8_t base) {
-    char * endptr;
-    *val = SCPIDEFINE_strtoll(str, &endptr, base);
-    return endptr - str;
+size_t strBaseToInt64(const char * str, const size_t len, int64_t * val, const int8_t base, scpi_bool_t * overflow) {
+    uint64_t magnitude;
+    scpi_bool_t negative;
+    scpi_bool_t over;
+    size_t used = strBaseToMagnitude(str, len, &magnitude, &negative, base, &over);
+
+    if (negative) {
+        if (magnitude > (uint64_t) INT64_MAX + 1) {
+            over = TRUE;
+            magnitude = (uint64_t) INT64_MAX + 1;
+        }
+        *val = magnitude ? -(int64_t) (magnitude - 1) - 1 : 0;
+    } else {
+        if (magnitude > (uint64_t) INT64_MAX) {
+            over = TRUE;
+            magnitude = INT64_MAX;
+        }
+        *val = (int64_t) magnitude;
+    }
+
+    if (overflow) {
+        *overflow = over;
+    }
+    return used;
 }
 
 /**
  * Converts string to unsigned 64bit integer representation
- * @param str   string value
- * @param val   64bit integer result
- * @param base
- * @return      number of bytes used in string
+ * @param str       string value
+ * @param len       string length
+ * @param val       64bit integer result, saturated on overflow
+ * @param base      2, 8, 10 or 16
+ * @param overflow  set to TRUE if the value does not fit or is negative, can be NULL
+ * @return          number of bytes used in string
  */
-size_t strBaseToUInt64(const char * str, uint64_t * val, const int8_t base) {
-    char * endptr;
-    *val = SCPIDEFINE_strtoull(str, &endptr, base);
-    return endptr - str;
+size_t strBaseToUInt64(const char * str, const size_t len, uint64_t * val, const int8_t base, scpi_bool_t * overflow) {
+    uint64_t magnitude;
+    scpi_bool_t negative;
+    scpi_bool_t over;
+    size_t used = strBaseToMagnitude(str, len, &magnitude, &negative, base, &over);
+
+    if (negative && magnitude) {
+        over = TRUE;
+        magnitude = 0;
+    }
+    *val = magnitude;
+
+    if (overflow) {
+        *overflow = over;
+    }
+    return used;
 }
 
+#if !USE_BUILTIN_STRTOD
+
 /**
  * Converts string to float (32 bit) representation
  * @param str   string value
+ * @param len   string length, number must be followed by other character
  * @param val   float result
  * @return      number of bytes used in string
  */
-size_t strToFloat(const char * str, float * val) {
+size_t strToFloat(const char * str, size_t len, float * val) {
     char * endptr;
+    (void) len;
     *val = SCPIDEFINE_strtof(str, &endptr);
     return endptr - str;
 }
@@ -326,14 +783,17 @@ size_t strToFloat(const char * str, float * val) {
 /**
  * Converts string to double (64 bit) representation
  * @param str   string value
+ * @param len   string length, number must be followed by other character
  * @param val   double result
  * @return      number of bytes used in string
  */
-size_t strToDouble(const char * str, double * val) {
+size_t strToDouble(const char * str, size_t len, double * val) {
     char * endptr;
+    (void) len;
     *val = strtod(str, &endptr);
     return endptr - str;
 }
+#endif /* !USE_BUILTIN_STRTOD */
 
 /**
  * Compare two strings with exact length
@@ -380,8 +840,9 @@ scpi_bool_t compareStrAndNum(const char * str1, const size_t len1, const char *
                 /* *num = 1; */
             } else {
                 int32_t tmpNum;
-                i = len1 + strBaseToInt32(str2 + len1, &tmpNum, 10);
-                if (i != len2) {
+                scpi_bool_t overflow;
+                i = len1 + strBaseToInt32(str2 + len1, len2 - len1, &tmpNum, 10, &overflow);
+                if (i != len2 || overflow) {
                     result = FALSE;
                 } else {
                     *num = tmpNum;
@@ -422,7 +883,7 @@ size_t skipWhitespace(const char * cmd, const size_t len) {
  * @param len - max search length
  * @return position of separator or len
  */
-static size_t patternSeparatorShortPos(const char * pattern, const size_t len) {
+size_t patternSeparatorShortPos(const char * pattern, const size_t len) {
     size_t i;
     for (i = 0; (i < len) && pattern[i]; i++) {
         if (islower((unsigned char) pattern[i])) {
@@ -432,6 +893,24 @@ static size_t patternSeparatorShortPos(const char * pattern, const size_t len) {
     return i;
 }
 
+/**
+ * Case insensitive FNV-1a hash of string
+ * @param str
+ * @param len
+ * @return
+ */
+uint32_t strHashCase(const char * str, const size_t len) {
+    uint32_t hash = 2166136261ul;
+    size_t i;
+
+    for (i = 0; i < len; i++) {
+        hash ^= (uint8_t) toupper((uint8_t) str[i]);
+        hash *= 16777619ul;
+    }
+
+    return hash;
+}
+
 /**
  * Find pattern separator position
  * @param pattern
@@ -781,6 +1260,7 @@ void scpiheap_init(scpi_error_info_heap_t * heap, char * error_info_heap, size_t
     heap->wr = 0;
     heap->size = error_info_heap_length;
     heap->count = heap->size;
+    heap->peak = 0;
     memset(heap->data, 0, heap->size);
 }
 
@@ -824,6 +1304,9 @@ char * scpiheap_strndup(scpi_error_info_heap_t * heap, const char *s, size_t n)
     memcpy(&heap->data[heap->wr], ptrs, len);
     heap->wr += len;
     heap->count -= len;
+    if (heap->size - heap->count > heap->peak) {
+        heap->peak = heap->size - heap->count;
+    }
 
     /* ensure '\0' at the end */
     if (heap->wr > 0) {
@@ -904,6 +1387,90 @@ void scpiheap_free(scpi_error_info_heap_t * heap, char * s, scpi_bool_t rollback
     }
 }
 
+/**
+ * Initialize slab of fixed size slots for device dependent error information.
+ * Free slots are linked by index stored at their beginning.
+ *
+ * @param slab
+ * @param data - memory for slots
+ * @param length - size of data
+ * @param count - number of slots
+ */
+void scpislab_init(scpi_error_info_slab_t * slab, char * data, size_t length, uint16_t count) {
+    uint16_t i;
+    uint16_t next;
+
+    slab->data = data;
+    slab->slot_size = count ? length / count : 0;
+    slab->count = (slab->slot_size > sizeof (uint16_t)) ? count : 0;
+    slab->free = 0;
+    slab->used = 0;
+    slab->peak = 0;
+
+    for (i = 0; i < slab->count; i++) {
+        next = (uint16_t) (i + 1);
+        memcpy(&data[i * slab->slot_size], &next, sizeof (next));
+    }
+}
+
+/**
+ * Duplicate string to free slot of slab, the string is truncated to the slot
+ * size
+ *
+ * @param slab
+ * @param s - string to duplicate
+ * @param n - maximal length of the string
+ * @return pointer of duplicated string or NULL, if there is no free slot
+ */
+char * scpislab_strndup(scpi_error_info_slab_t * slab, const char * s, size_t n) {
+    char * slot;
+    size_t len;
+
+    if (!s || !slab || (*s == '\0') || (slab->free >= slab->count)) {
+        return NULL;
+    }
+
+    slot = &slab->data[slab->free * slab->slot_size];
+    memcpy(&slab->free, slot, sizeof (slab->free));
+
+    slab->used++;
+    if (slab->used > slab->peak) {
+        slab->peak = slab->used;
+    }
+
+    len = SCPIDEFINE_strnlen(s, n);
+    if (len > slab->slot_size - 1) {
+        len = slab->slot_size - 1;
+    }
+    memcpy(slot, s, len);
+    slot[len] = '\0';
+
+    return slot;
+}
+
+/**
+ * Return slot of string to the slab
+ *
+ * @param slab
+ * @param s - pointer of duplicated string
+ */
+void scpislab_free(scpi_error_info_slab_t * slab, char * s) {
+    size_t offset;
+
+    if (!s || !slab || (s < slab->data)) {
+        return;
+    }
+
+    offset = s - slab->data;
+    if ((offset % slab->slot_size) || (offset / slab->slot_size >= slab->count)) {
+        return;
+    }
+
+    memcpy(s, &slab->free, sizeof (slab->free));
+    slab->free = (uint16_t) (offset / slab->slot_size);
+    slab->used--;
+}
+
 #endif
 
 /*
@@ -1143,3 +1710,55 @@ uint64_t SCPI_Swap64(const uint64_t val) {
             ((val & 0x00FF000000000000ull) >> 40) |
             ((val & 0xFF00000000000000ull) >> 56);
 }
+
+/**
+ * Swap bytes of all items of an array in place
+ *
+ * Eight bytes are loaded into one 64bit word and all 16bit or 32bit
+ * lanes in it are swapped by masks and shifts at once.
+ * @param data - array of items
+ * @param count - number of items
+ * @param item_size - size of one item (1, 2, 4 or 8)
+ */
+void SCPI_SwapArray(void * data, size_t count, size_t item_size) {
+    uint8_t * ptr = (uint8_t *) data;
+    size_t len = count * item_size;
+    size_t i;
+    uint64_t word;
+
+    if (item_size < 2) {
+        return;
+    }
+
+    for (i = 0; i + 8 <= len; i += 8) {
+        memcpy(&word, ptr + i, 8);
+        switch (item_size) {
+            case 2:
+                word = ((word & 0x00FF00FF00FF00FFull) << 8) | ((word >> 8) & 0x00FF00FF00FF00FFull);
+                break;
+            case 4:
+                word = ((word & 0x00FF00FF00FF00FFull) << 8) | ((word >> 8) & 0x00FF00FF00FF00FFull);
+                word = ((word & 0x0000FFFF0000FFFFull) << 16) | ((word >> 16) & 0x0000FFFF0000FFFFull);
+                break;
+            default:
+                word = SCPI_Swap64(word);
+                break;
+        }
+        memcpy(ptr + i, &word, 8);
+    }
+
+    /* remaining items, at most three 16bit or one 32bit */
+    for (; i + item_size <= len; i += item_size) {
+        if (item_size == 2) {
+            uint16_t val;
+            memcpy(&val, ptr + i, 2);
+            val = SCPI_Swap16(val);
+            memcpy(ptr + i, &val, 2);
+        } else {
+            uint32_t val;
+            memcpy(&val, ptr + i, 4);
+            val = SCPI_Swap32(val);
+            memcpy(ptr + i, &val, 4);
+        }
+    }
+}
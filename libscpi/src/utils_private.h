@@ -57,15 +57,17 @@ extern "C" {
     scpi_bool_t compareStrAndNum(const char * str1, size_t len1, const char * str2, size_t len2, int32_t * num) LOCAL;
     size_t UInt32ToStrBaseSign(uint32_t val, char * str, size_t len, int8_t base, scpi_bool_t sign) LOCAL;
     size_t UInt64ToStrBaseSign(uint64_t val, char * str, size_t len, int8_t base, scpi_bool_t sign) LOCAL;
-    size_t strBaseToInt32(const char * str, int32_t * val, int8_t base) LOCAL;
-    size_t strBaseToUInt32(const char * str, uint32_t * val, int8_t base) LOCAL;
-    size_t strBaseToInt64(const char * str, int64_t * val, int8_t base) LOCAL;
-    size_t strBaseToUInt64(const char * str, uint64_t * val, int8_t base) LOCAL;
-    size_t strToFloat(const char * str, float * val) LOCAL;
-    size_t strToDouble(const char * str, double * val) LOCAL;
+    size_t strBaseToInt32(const char * str, size_t len, int32_t * val, int8_t base, scpi_bool_t * overflow) LOCAL;
+    size_t strBaseToUInt32(const char * str, size_t len, uint32_t * val, int8_t base, scpi_bool_t * overflow) LOCAL;
+    size_t strBaseToInt64(const char * str, size_t len, int64_t * val, int8_t base, scpi_bool_t * overflow) LOCAL;
+    size_t strBaseToUInt64(const char * str, size_t len, uint64_t * val, int8_t base, scpi_bool_t * overflow) LOCAL;
+    size_t strToFloat(const char * str, size_t len, float * val) LOCAL;
+    size_t strToDouble(const char * str, size_t len, double * val) LOCAL;
     scpi_bool_t locateText(const char * str1, size_t len1, const char ** str2, size_t * len2) LOCAL;
     scpi_bool_t locateStr(const char * str1, size_t len1, const char ** str2, size_t * len2) LOCAL;
     size_t skipWhitespace(const char * cmd, size_t len) LOCAL;
+    size_t patternSeparatorShortPos(const char * pattern, size_t len) LOCAL;
+    uint32_t strHashCase(const char * str, size_t len) LOCAL;
     scpi_bool_t matchPattern(const char * pattern, size_t pattern_len, const char * str, size_t str_len, int32_t * num) LOCAL;
     scpi_bool_t matchCommand(const char * pattern, const char * cmd, size_t len, int32_t *numbers, size_t numbers_len, int32_t default_value) LOCAL;
     scpi_bool_t composeCompoundCommand(const scpi_token_t * prev, scpi_token_t * current) LOCAL;
@@ -79,6 +81,7 @@ extern "C" {
     uint16_t SCPI_Swap16(uint16_t val);
     uint32_t SCPI_Swap32(uint32_t val);
     uint64_t SCPI_Swap64(uint64_t val);
+    void SCPI_SwapArray(void * data, size_t count, size_t item_size);
 
 #if !HAVE_STRNLEN
     size_t BSD_strnlen(const char *s, size_t maxlen) LOCAL;
@@ -93,6 +96,9 @@ extern "C" {
     char * scpiheap_strndup(scpi_error_info_heap_t * heap, const char *s, size_t n) LOCAL;
     void scpiheap_free(scpi_error_info_heap_t * heap, char *s, scpi_bool_t rollback) LOCAL;
     scpi_bool_t scpiheap_get_parts(scpi_error_info_heap_t * heap, const char *s1, size_t * len1, const char ** s2, size_t * len2) LOCAL;
+    void scpislab_init(scpi_error_info_slab_t * slab, char * data, size_t length, uint16_t count) LOCAL;
+    char * scpislab_strndup(scpi_error_info_slab_t * slab, const char *s, size_t n) LOCAL;
+    void scpislab_free(scpi_error_info_slab_t * slab, char *s) LOCAL;
 #endif
 
 #if !HAVE_STRNDUP
@@ -0,0 +1,103 @@
+/*-
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2012-2018, Jan Breuer
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file   bench_dtostr.c
+ *
+ * @brief  Benchmark of floating point to string conversion
+ *
+ * Compares built-in conversion with snprintf and SCPI_dtostre
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "scpi/scpi.h"
+#include "../src/utils_private.h"
+
+#define BENCH_VALUES 4096
+#define BENCH_ROUNDS 200
+
+static double values[BENCH_VALUES];
+static volatile size_t sink;
+
+static void fillValues(void) {
+    uint64_t x = 88172645463325252ull;
+    int i;
+
+    for (i = 0; i < BENCH_VALUES; i++) {
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+        /* mix of instrument-like values and random magnitudes */
+        if (i & 1) {
+            values[i] = (double) (int32_t) (x % 2000001 - 1000000) / 1000.0;
+        } else {
+            values[i] = (double) (x >> 11) * 1e-10 * ((x & 1) ? 1e-6 : 1e6);
+        }
+    }
+}
+
+static void report(const char * name, clock_t start) {
+    double elapsed = (double) (clock() - start) / CLOCKS_PER_SEC;
+    printf("%-32s %8.1f ns/value\n", name, elapsed * 1e9 / ((double) BENCH_VALUES * BENCH_ROUNDS));
+}
+
+#define BENCH(name, expr)                                                       \
+    do {                                                                        \
+        clock_t start = clock();                                                \
+        int r, i;                                                               \
+        for (r = 0; r < BENCH_ROUNDS; r++) {                                    \
+            for (i = 0; i < BENCH_VALUES; i++) {                                \
+                double v = values[i];                                           \
+                (void) v;                                                       \
+                expr;                                                           \
+                sink += (size_t) str[0];                                        \
+            }                                                                   \
+        }                                                                       \
+        report(name, start);                                                    \
+    } while(0)
+
+int main() {
+    char str[64];
+
+    fillValues();
+
+    BENCH("double shortest", SCPI_DoubleToStrPrecision(v, str, sizeof (str), 0));
+    BENCH("double 15 digits", SCPI_DoubleToStrPrecision(v, str, sizeof (str), 15));
+    BENCH("double snprintf %.15lg", snprintf(str, sizeof (str), "%.15lg", v));
+    BENCH("double SCPI_dtostre 15", SCPI_dtostre(v, str, sizeof (str), 15, 0));
+    BENCH("float shortest", SCPI_FloatToStrPrecision((float) v, str, sizeof (str), 0));
+    BENCH("float 6 digits", SCPI_FloatToStrPrecision((float) v, str, sizeof (str), 6));
+    BENCH("float snprintf %g", snprintf(str, sizeof (str), "%g", (float) v));
+    BENCH("float SCPI_dtostre 6", SCPI_dtostre((float) v, str, sizeof (str), 6, 0));
+
+    return 0;
+}
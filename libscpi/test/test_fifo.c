@@ -32,6 +32,12 @@
 
 #include "../src/fifo_private.h"
 
+#if USE_ERROR_QUEUE_LOCKFREE
+#include <pthread.h>
+#include <sched.h>
+#include <string.h>
+#endif
+
 /*
  * CUnit Test Suite
  */
@@ -44,6 +50,7 @@ static int clean_suite(void) {
     return 0;
 }
 
+#if !USE_ERROR_QUEUE_LOCKFREE
 static void testFifo() {
     scpi_fifo_t fifo;
     scpi_error_t fifo_data[4];
@@ -166,6 +173,216 @@ static void testFifo() {
 
     CU_ASSERT_FALSE(fifo_remove_last(&fifo, NULL));
 }
+#else
+static void testFifoLockFree() {
+    scpi_fifo_t fifo;
+    scpi_error_t fifo_data[5];
+    scpi_error_t value;
+    int16_t count_value;
+    int32_t i;
+
+#define TEST_FIFO_COUNT(n)                      \
+    do {                                        \
+        fifo_count(&fifo, &count_value);        \
+        CU_ASSERT_EQUAL(count_value, n);        \
+    } while(0)                                  \
+
+    /* size is rounded down to power of two */
+    fifo_init(&fifo, fifo_data, 5);
+    CU_ASSERT_EQUAL(fifo.size, 4);
+    TEST_FIFO_COUNT(0);
+    CU_ASSERT_TRUE(fifo_is_empty(&fifo));
+    CU_ASSERT_FALSE(fifo_remove(&fifo, &value));
+
+    for (i = 1; i <= 4; i++) {
+        value.error_code = i;
+        CU_ASSERT_TRUE(fifo_add(&fifo, &value));
+        TEST_FIFO_COUNT(i);
+    }
+    CU_ASSERT_TRUE(fifo_is_full(&fifo));
+
+    value.error_code = 5;
+    CU_ASSERT_FALSE(fifo_add(&fifo, &value));
+    fifo_mark_overflow(&fifo);
+    TEST_FIFO_COUNT(4);
+
+    CU_ASSERT_TRUE(fifo_remove(&fifo, &value));
+    CU_ASSERT_EQUAL(value.error_code, 1);
+
+    value.error_code = 6;
+    CU_ASSERT_TRUE(fifo_add(&fifo, &value));
+    TEST_FIFO_COUNT(4);
+
+    CU_ASSERT_TRUE(fifo_remove(&fifo, &value));
+    CU_ASSERT_EQUAL(value.error_code, 2);
+    CU_ASSERT_TRUE(fifo_remove(&fifo, &value));
+    CU_ASSERT_EQUAL(value.error_code, 3);
+    CU_ASSERT_TRUE(fifo_remove(&fifo, &value));
+    CU_ASSERT_EQUAL(value.error_code, -350);
+    CU_ASSERT_TRUE(fifo_remove(&fifo, &value));
+    CU_ASSERT_EQUAL(value.error_code, 6);
+    CU_ASSERT_FALSE(fifo_remove(&fifo, &value));
+    TEST_FIFO_COUNT(0);
+
+    /* first overflow mark is kept until it is removed */
+    for (i = 10; i <= 13; i++) {
+        value.error_code = i;
+        CU_ASSERT_TRUE(fifo_add(&fifo, &value));
+    }
+    CU_ASSERT_FALSE(fifo_add(&fifo, &value));
+    fifo_mark_overflow(&fifo);
+    CU_ASSERT_FALSE(fifo_add(&fifo, &value));
+    fifo_mark_overflow(&fifo);
+    CU_ASSERT_TRUE(fifo_remove(&fifo, &value));
+    CU_ASSERT_EQUAL(value.error_code, 10);
+    value.error_code = 14;
+    CU_ASSERT_TRUE(fifo_add(&fifo, &value));
+    CU_ASSERT_FALSE(fifo_add(&fifo, &value));
+    fifo_mark_overflow(&fifo);
+    CU_ASSERT_TRUE(fifo_remove(&fifo, &value));
+    CU_ASSERT_EQUAL(value.error_code, 11);
+    CU_ASSERT_TRUE(fifo_remove(&fifo, &value));
+    CU_ASSERT_EQUAL(value.error_code, 12);
+    CU_ASSERT_TRUE(fifo_remove(&fifo, &value));
+    CU_ASSERT_EQUAL(value.error_code, -350);
+    CU_ASSERT_TRUE(fifo_remove(&fifo, &value));
+    CU_ASSERT_EQUAL(value.error_code, 14);
+    TEST_FIFO_COUNT(0);
+
+    /* positions wrap around */
+    for (i = 0; i < 70000; i++) {
+        value.error_code = (int16_t) (i & 0x7fff);
+        CU_ASSERT_TRUE(fifo_add(&fifo, &value));
+        value.error_code = (int16_t) ((i + 1) & 0x7fff);
+        CU_ASSERT_TRUE(fifo_add(&fifo, &value));
+        CU_ASSERT_TRUE(fifo_remove(&fifo, &value));
+        CU_ASSERT_EQUAL(value.error_code, (int16_t) (i & 0x7fff));
+        CU_ASSERT_TRUE(fifo_remove(&fifo, &value));
+        CU_ASSERT_EQUAL(value.error_code, (int16_t) ((i + 1) & 0x7fff));
+    }
+    TEST_FIFO_COUNT(0);
+
+    /* stale overflow mark is dropped */
+    value.error_code = 7;
+    CU_ASSERT_TRUE(fifo_add(&fifo, &value));
+    fifo_mark_overflow(&fifo);
+    CU_ASSERT_TRUE(fifo_remove(&fifo, &value));
+    CU_ASSERT_EQUAL(value.error_code, -350);
+    value.error_code = 8;
+    CU_ASSERT_TRUE(fifo_add(&fifo, &value));
+    CU_ASSERT_TRUE(fifo_remove(&fifo, &value));
+    CU_ASSERT_EQUAL(value.error_code, 8);
+
+    value.error_code = 9;
+    CU_ASSERT_TRUE(fifo_add(&fifo, &value));
+    fifo_clear(&fifo);
+    TEST_FIFO_COUNT(0);
+    CU_ASSERT_TRUE(fifo_is_empty(&fifo));
+}
+
+#define STRESS_PRODUCERS 4
+#define STRESS_COUNT 4000
+#define STRESS_FIFO_SIZE 16
+
+static scpi_fifo_t stress_fifo;
+static scpi_error_t stress_data[STRESS_FIFO_SIZE];
+static uint8_t stress_added[STRESS_PRODUCERS][STRESS_COUNT];
+static uint8_t stress_removed[STRESS_PRODUCERS][STRESS_COUNT];
+static int stress_running;
+
+/**
+ * Push tagged codes like SCPI_ErrorPush, full fifo marks overflow and the
+ * code is dropped
+ * @param arg producer number
+ * @return
+ */
+static void * stressProducer(void * arg) {
+    const int producer = (int) (intptr_t) arg;
+    scpi_error_t value;
+    int i;
+
+    memset(&value, 0, sizeof (value));
+    for (i = 0; i < STRESS_COUNT; i++) {
+        value.error_code = (int16_t) (producer * 4096 + i);
+        if (fifo_add(&stress_fifo, &value)) {
+            stress_added[producer][i] = 1;
+        } else {
+            fifo_mark_overflow(&stress_fifo);
+        }
+        if ((i & 7) == 0) {
+            sched_yield();
+        }
+    }
+
+    __atomic_sub_fetch(&stress_running, 1, __ATOMIC_RELEASE);
+    return NULL;
+}
+
+static void testFifoLockFreeStress() {
+    pthread_t threads[STRESS_PRODUCERS];
+    int last[STRESS_PRODUCERS];
+    scpi_error_t value;
+    int overflows = 0;
+    int missing = 0;
+    int producer;
+    int i;
+
+    memset(stress_added, 0, sizeof (stress_added));
+    memset(stress_removed, 0, sizeof (stress_removed));
+    fifo_init(&stress_fifo, stress_data, STRESS_FIFO_SIZE);
+    stress_running = STRESS_PRODUCERS;
+
+    for (producer = 0; producer < STRESS_PRODUCERS; producer++) {
+        last[producer] = -1;
+        CU_ASSERT_EQUAL(pthread_create(&threads[producer], NULL, stressProducer, (void *) (intptr_t) producer), 0);
+    }
+
+    /* single consumer, every code at most once and in order of its producer */
+    for (;;) {
+        const int running = __atomic_load_n(&stress_running, __ATOMIC_ACQUIRE);
+
+        if (!fifo_remove(&stress_fifo, &value)) {
+            if (!running) {
+                break;
+            }
+            sched_yield();
+            continue;
+        }
+
+        if (value.error_code == -350) {
+            overflows++;
+            continue;
+        }
+
+        producer = value.error_code / 4096;
+        i = value.error_code % 4096;
+        CU_ASSERT_TRUE((producer >= 0) && (producer < STRESS_PRODUCERS) && (i < STRESS_COUNT));
+        if ((producer < 0) || (producer >= STRESS_PRODUCERS) || (i >= STRESS_COUNT)) {
+            continue;
+        }
+        CU_ASSERT_TRUE(i > last[producer]);
+        CU_ASSERT_FALSE(stress_removed[producer][i]);
+        last[producer] = i;
+        stress_removed[producer][i] = 1;
+    }
+
+    for (producer = 0; producer < STRESS_PRODUCERS; producer++) {
+        pthread_join(threads[producer], NULL);
+    }
+    CU_ASSERT_FALSE(fifo_remove(&stress_fifo, &value));
+
+    /* only codes replaced by queue overflow are missing */
+    for (producer = 0; producer < STRESS_PRODUCERS; producer++) {
+        for (i = 0; i < STRESS_COUNT; i++) {
+            CU_ASSERT_TRUE(stress_added[producer][i] || !stress_removed[producer][i]);
+            if (stress_added[producer][i] && !stress_removed[producer][i]) {
+                missing++;
+            }
+        }
+    }
+    CU_ASSERT_EQUAL(missing, overflows);
+}
+#endif
 
 int main() {
     unsigned int result;
@@ -183,7 +400,12 @@ int main() {
     }
 
     /* Add the tests to the suite */
+#if !USE_ERROR_QUEUE_LOCKFREE
     if ((NULL == CU_add_test(pSuite, "test fifo", testFifo))) {
+#else
+    if ((NULL == CU_add_test(pSuite, "test lock-free fifo", testFifoLockFree))
+            || (NULL == CU_add_test(pSuite, "test lock-free fifo stress", testFifoLockFreeStress))) {
+#endif
         CU_cleanup_registry();
         return CU_get_error();
     }
@@ -79,6 +79,84 @@ static scpi_result_t SCPI_Sample(scpi_t * context) {
     return SCPI_RES_OK;
 }
 
+#if USE_PARAMETER_SCHEMA
+static int test_schema_calls = 0;
+
+static const scpi_choice_def_t test_schema_source[] = {
+    {"BUS", 5},
+    {"IMMediate", 6},
+    {"EXTernal", 7},
+    SCPI_CHOICE_LIST_END
+};
+
+static const scpi_param_schema_t test_schema_params[] = {
+    {.type = SCPI_PARAM_NUMBER, .unit = SCPI_UNIT_VOLT, .min = 0, .max = 10, .def = 1},
+    {.type = SCPI_PARAM_CHOICE, .choices = test_schema_source, .def = 6},
+    {.type = SCPI_PARAM_BOOL, .def = 1},
+    {.type = SCPI_PARAM_INT32, .min = -5, .max = 5, .def = 0},
+};
+
+static const scpi_command_schema_t test_schema = {
+    .params = test_schema_params,
+    .count = 4,
+    .mandatory = 1,
+};
+
+static scpi_result_t test_schemaQ(scpi_t * context) {
+    test_schema_calls++;
+
+    SCPI_ResultDouble(context, SCPI_Argument(context, 0)->content.number.content.value);
+    SCPI_ResultInt32(context, SCPI_Argument(context, 1)->content.tag);
+    SCPI_ResultBool(context, SCPI_Argument(context, 2)->content.boolean);
+    SCPI_ResultInt32(context, SCPI_Argument(context, 3)->content.int32);
+    SCPI_ResultBool(context, SCPI_Argument(context, 3)->present);
+    CU_ASSERT_EQUAL(SCPI_Argument(context, 4), NULL);
+
+    return SCPI_RES_OK;
+}
+
+static const scpi_param_schema_t test_schema_free_params[] = {
+    {.type = SCPI_PARAM_NUMBER, .unit = SCPI_UNIT_VOLT, .def = 1},
+};
+
+static const scpi_command_schema_t test_schema_free = {
+    .params = test_schema_free_params,
+    .count = 1,
+    .mandatory = 1,
+};
+
+static scpi_result_t test_schemaFreeQ(scpi_t * context) {
+    const scpi_number_t * number = &SCPI_Argument(context, 0)->content.number;
+
+    test_schema_calls++;
+
+    SCPI_ResultBool(context, number->special);
+    if (number->special) {
+        SCPI_ResultInt32(context, number->content.tag);
+    } else {
+        SCPI_ResultDouble(context, number->content.value);
+    }
+
+    return SCPI_RES_OK;
+}
+#endif /* USE_PARAMETER_SCHEMA */
+
+#if USE_EVENT_LOG
+static uint32_t event_timestamp = 0;
+
+static uint32_t SCPI_Timestamp(scpi_t * context) {
+    (void) context;
+
+    return event_timestamp;
+}
+
+static scpi_result_t test_eventFail(scpi_t * context) {
+    SCPI_ErrorPush(context, SCPI_ERROR_EXECUTION_ERROR);
+
+    return SCPI_RES_OK;
+}
+#endif /* USE_EVENT_LOG */
+
 static const scpi_command_t scpi_commands[] = {
     /* IEEE Mandated Commands (SCPI std V1999.0 4.1.1) */
     { .pattern = "*CLS", .callback = SCPI_CoreCls,},
@@ -98,6 +176,14 @@ static const scpi_command_t scpi_commands[] = {
     /* Required SCPI commands (SCPI std V1999.0 4.2.1) */
     { .pattern = "SYSTem:ERRor[:NEXT]?", .callback = SCPI_SystemErrorNextQ,},
     { .pattern = "SYSTem:ERRor:COUNt?", .callback = SCPI_SystemErrorCountQ,},
+#if USE_EVENT_LOG
+    { .pattern = "SYSTem:ERRor:LOG?", .callback = SCPI_SystemErrorLogQ,},
+#if USE_COMMAND_TAGS
+    { .pattern = "TEST:EVENt", .callback = test_eventFail, .tag = 42,},
+#else
+    { .pattern = "TEST:EVENt", .callback = test_eventFail,},
+#endif
+#endif /* USE_EVENT_LOG */
     { .pattern = "SYSTem:VERSion?", .callback = SCPI_SystemVersionQ,},
 
     { .pattern = "STATus:QUEStionable[:EVENt]?", .callback = SCPI_StatusQuestionableEventQ,},
@@ -112,6 +198,11 @@ static const scpi_command_t scpi_commands[] = {
 
     { .pattern = "STATus:PRESet", .callback = SCPI_StatusPreset,},
 
+    { .pattern = "FORMat[:DATA]", .callback = SCPI_FormatData,},
+    { .pattern = "FORMat[:DATA]?", .callback = SCPI_FormatDataQ,},
+    { .pattern = "FORMat:BORDer", .callback = SCPI_FormatBorder,},
+    { .pattern = "FORMat:BORDer?", .callback = SCPI_FormatBorderQ,},
+
     { .pattern = "TEXTfunction?", .callback = text_function,},
 
     { .pattern = "TEST:TREEA?", .callback = test_treeA,},
@@ -121,6 +212,10 @@ static const scpi_command_t scpi_commands[] = {
     { .pattern = "STUB?", .callback = SCPI_StubQ,},
 
     { .pattern = "SAMple", .callback = SCPI_Sample,},
+#if USE_PARAMETER_SCHEMA
+    { .pattern = "SCHema?", .callback = test_schemaQ, .schema = &test_schema,},
+    { .pattern = "SCHema:FREE?", .callback = test_schemaFreeQ, .schema = &test_schema_free,},
+#endif /* USE_PARAMETER_SCHEMA */
     SCPI_CMD_LIST_END
 };
 
@@ -159,9 +254,19 @@ static void error_buffer_add(int_fast16_t err) {
     err_buffer_pos++;
 }
 
+/* simulate slow interface, which accepts only limited number of bytes */
+static size_t output_write_limit = SIZE_MAX;
+
 static size_t SCPI_Write(scpi_t * context, const char * data, size_t len) {
     (void) context;
 
+    if (len > output_write_limit) {
+        len = output_write_limit;
+    }
+    if (output_write_limit != SIZE_MAX) {
+        output_write_limit -= len;
+    }
+
     return output_buffer_write(data, len);
 }
 
@@ -180,12 +285,14 @@ static int SCPI_Error(scpi_t * context, int_fast16_t err) {
 }
 
 scpi_reg_val_t srq_val = 0;
+int srq_count = 0;
 
 static scpi_result_t SCPI_Control(scpi_t * context, scpi_ctrl_name_t ctrl, scpi_reg_val_t val) {
     (void) context;
 
     if (SCPI_CTRL_SRQ == ctrl) {
         srq_val = val;
+        srq_count++;
     } else {
         fprintf(stderr, "**CTRL %02x: 0x%X (%d)\r\n", ctrl, val, val);
     }
@@ -207,6 +314,9 @@ static scpi_interface_t scpi_interface = {
     .control = SCPI_Control,
     .flush = SCPI_Flush,
     .reset = SCPI_Reset,
+#if USE_EVENT_LOG
+    .timestamp = SCPI_Timestamp,
+#endif
 };
 
 #define SCPI_INPUT_BUFFER_LENGTH 256
@@ -215,7 +325,11 @@ static char scpi_input_buffer[SCPI_INPUT_BUFFER_LENGTH];
 #define SCPI_ERROR_QUEUE_SIZE 4
 static scpi_error_t scpi_error_queue_data[SCPI_ERROR_QUEUE_SIZE];
 
+#if USE_ERROR_INFO_SLAB
+#define SCPI_ERROR_INFO_HEAP_SIZE ((SCPI_ERROR_QUEUE_SIZE + 1) * 8)
+#else
 #define SCPI_ERROR_INFO_HEAP_SIZE 16
+#endif
 static char error_info_heap[SCPI_ERROR_INFO_HEAP_SIZE];
 
 static int init_suite(void) {
@@ -296,6 +410,155 @@ static void testCommandsHandling(void) {
     error_buffer_clear();
 }
 
+static void testParameterSchema(void) {
+#if USE_PARAMETER_SCHEMA
+#define TEST_SCHEMA(data, output, calls, error) {               \
+    output_buffer_clear();                                      \
+    error_buffer_clear();                                       \
+    test_schema_calls = 0;                                      \
+    SCPI_Input(&scpi_context, data, strlen(data));              \
+    CU_ASSERT_STRING_EQUAL(output, output_buffer);              \
+    CU_ASSERT_EQUAL(test_schema_calls, calls);                  \
+    CU_ASSERT_EQUAL(err_buffer_pos, error ? 1 : 0);             \
+    CU_ASSERT_EQUAL(err_buffer[0], error);                      \
+}
+    TEST_SCHEMA("SCH? 2.5\r\n", "2.5,6,1,0,0\r\n", 1, 0);
+    TEST_SCHEMA("SCH? 250 MV, BUS, OFF, -3\r\n", "0.25,5,0,-3,1\r\n", 1, 0);
+    TEST_SCHEMA("SCH? MAX, EXT\r\n", "10,7,1,0,0\r\n", 1, 0);
+    TEST_SCHEMA("SCH? DEF\r\n", "1,6,1,0,0\r\n", 1, 0);
+    TEST_SCHEMA("SCH?\r\n", "", 0, SCPI_ERROR_MISSING_PARAMETER);
+    TEST_SCHEMA("SCH? 11\r\n", "", 0, SCPI_ERROR_DATA_OUT_OF_RANGE);
+    TEST_SCHEMA("SCH? 1 A\r\n", "", 0, SCPI_ERROR_INVALID_SUFFIX);
+    TEST_SCHEMA("SCH? 1, TRIGGER\r\n", "", 0, SCPI_ERROR_ILLEGAL_PARAMETER_VALUE);
+    TEST_SCHEMA("SCH? 1, BUS, 1, 6\r\n", "", 0, SCPI_ERROR_DATA_OUT_OF_RANGE);
+    TEST_SCHEMA("SCH? 1, BUS, 1, 2, 3\r\n", "", 0, SCPI_ERROR_PARAMETER_NOT_ALLOWED);
+    TEST_SCHEMA("SCH? \"1\"\r\n", "", 0, SCPI_ERROR_DATA_TYPE_ERROR);
+
+    /* without range, MIN and MAX stay special values */
+    TEST_SCHEMA("SCH:FREE? MIN\r\n", "1,1\r\n", 1, 0);
+    TEST_SCHEMA("SCH:FREE? MAX\r\n", "1,2\r\n", 1, 0);
+    TEST_SCHEMA("SCH:FREE? DEF\r\n", "0,1\r\n", 1, 0);
+    TEST_SCHEMA("SCH:FREE? 200\r\n", "0,200\r\n", 1, 0);
+
+    output_buffer_clear();
+    error_buffer_clear();
+#endif /* USE_PARAMETER_SCHEMA */
+}
+
+static void testOutputQueue(void) {
+#if USE_OUTPUT_QUEUE
+    char queue[32];
+
+    SCPI_InitOutputQueue(&scpi_context, queue, sizeof (queue));
+    output_buffer_clear();
+    error_buffer_clear();
+
+    /* partial write, rest is queued */
+    output_write_limit = 5;
+    SCPI_Input(&scpi_context, "*IDN?\r\n", 7);
+    CU_ASSERT_STRING_EQUAL(output_buffer, "MA,IN");
+    CU_ASSERT_EQUAL(SCPI_OutputPending(&scpi_context), 8);
+
+    /* later output waits behind queued data */
+    output_write_limit = 0;
+    SCPI_Input(&scpi_context, "TEST:TREEA?\r\n", 13);
+    CU_ASSERT_STRING_EQUAL(output_buffer, "MA,IN");
+    CU_ASSERT_EQUAL(SCPI_OutputPending(&scpi_context), 12);
+
+    output_write_limit = 4;
+    CU_ASSERT_EQUAL(SCPI_OutputPump(&scpi_context), 8);
+    CU_ASSERT_STRING_EQUAL(output_buffer, "MA,IN,0,V");
+
+    output_write_limit = SIZE_MAX;
+    CU_ASSERT_EQUAL(SCPI_OutputPump(&scpi_context), 0);
+    CU_ASSERT_STRING_EQUAL(output_buffer, "MA,IN,0,VER\r\n10\r\n");
+    CU_ASSERT_EQUAL(err_buffer_pos, 0);
+
+    /* wrap around the end of the queue */
+    output_buffer_clear();
+    output_write_limit = 0;
+    SCPI_Input(&scpi_context, "*IDN?;*IDN?\r\n", 13);
+    CU_ASSERT_EQUAL(SCPI_OutputPending(&scpi_context), 25);
+    output_write_limit = 20;
+    CU_ASSERT_EQUAL(SCPI_OutputPump(&scpi_context), 5);
+    output_write_limit = 0;
+    SCPI_Input(&scpi_context, "*IDN?\r\n", 7);
+    CU_ASSERT_EQUAL(SCPI_OutputPending(&scpi_context), 18);
+    output_write_limit = SIZE_MAX;
+    CU_ASSERT_EQUAL(SCPI_OutputPump(&scpi_context), 0);
+    CU_ASSERT_STRING_EQUAL(output_buffer, "MA,IN,0,VER;MA,IN,0,VER\r\nMA,IN,0,VER\r\n");
+    CU_ASSERT_EQUAL(err_buffer_pos, 0);
+
+    /* overflow discards whole response message, queued ones are kept */
+    output_buffer_clear();
+    output_write_limit = 0;
+    SCPI_Input(&scpi_context, "*IDN?\r\n", 7);
+    CU_ASSERT_EQUAL(SCPI_OutputPending(&scpi_context), 13);
+    SCPI_Input(&scpi_context, "*IDN?;*IDN?\r\n", 13);
+    CU_ASSERT_EQUAL(SCPI_OutputPending(&scpi_context), 13);
+    CU_ASSERT_EQUAL(err_buffer_pos, 1);
+    CU_ASSERT_EQUAL(err_buffer[0], SCPI_ERROR_QUERY_DEADLOCKED);
+    output_write_limit = SIZE_MAX;
+    CU_ASSERT_EQUAL(SCPI_OutputPump(&scpi_context), 0);
+    CU_ASSERT_STRING_EQUAL(output_buffer, "MA,IN,0,VER\r\n");
+
+    /* response longer than the queue is written directly, nothing is lost */
+    output_buffer_clear();
+    error_buffer_clear();
+    SCPI_Input(&scpi_context, "*IDN?;*IDN?;*IDN?\r\n", 19);
+    CU_ASSERT_EQUAL(SCPI_OutputPending(&scpi_context), 0);
+    CU_ASSERT_STRING_EQUAL(output_buffer, "MA,IN,0,VER;MA,IN,0,VER;MA,IN,0,VER\r\n");
+    CU_ASSERT_EQUAL(err_buffer_pos, 0);
+
+    /* only the rest after short write is queued */
+    output_buffer_clear();
+    output_write_limit = 8;
+    SCPI_Input(&scpi_context, "*IDN?;*IDN?;*IDN?\r\n", 19);
+    CU_ASSERT_STRING_EQUAL(output_buffer, "MA,IN,0,");
+    CU_ASSERT_EQUAL(SCPI_OutputPending(&scpi_context), 29);
+    CU_ASSERT_EQUAL(err_buffer_pos, 0);
+    output_write_limit = SIZE_MAX;
+    CU_ASSERT_EQUAL(SCPI_OutputPump(&scpi_context), 0);
+    CU_ASSERT_STRING_EQUAL(output_buffer, "MA,IN,0,VER;MA,IN,0,VER;MA,IN,0,VER\r\n");
+
+    /* queue is drained before the next direct write */
+    output_buffer_clear();
+    output_write_limit = 2;
+    SCPI_Input(&scpi_context, "*IDN?\r\n", 7);
+    CU_ASSERT_EQUAL(SCPI_OutputPending(&scpi_context), 11);
+    output_write_limit = SIZE_MAX;
+    SCPI_Input(&scpi_context, "TEST:TREEA?\r\n", 13);
+    CU_ASSERT_EQUAL(SCPI_OutputPending(&scpi_context), 0);
+    CU_ASSERT_STRING_EQUAL(output_buffer, "MA,IN,0,VER\r\n10\r\n");
+
+    /* sent part of response message can not be taken back, rest is dropped */
+    output_buffer_clear();
+    output_write_limit = 2;
+    SCPI_Input(&scpi_context, "*IDN?;*IDN?;*IDN?\r\n", 19);
+    CU_ASSERT_EQUAL(err_buffer_pos, 1);
+    CU_ASSERT_EQUAL(err_buffer[0], SCPI_ERROR_QUERY_DEADLOCKED);
+    output_write_limit = SIZE_MAX;
+    CU_ASSERT_EQUAL(SCPI_OutputPump(&scpi_context), 0);
+    CU_ASSERT_STRING_EQUAL(output_buffer, "MA,IN,0,VER;MA,IN,0,VER;MA,IN,0,");
+    error_buffer_clear();
+
+    /* next response is sent again */
+    output_buffer_clear();
+    SCPI_Input(&scpi_context, "*IDN?\r\n", 7);
+    CU_ASSERT_STRING_EQUAL(output_buffer, "MA,IN,0,VER\r\n");
+
+    output_write_limit = 0;
+    SCPI_Input(&scpi_context, "*IDN?\r\n", 7);
+    SCPI_OutputClear(&scpi_context);
+    CU_ASSERT_EQUAL(SCPI_OutputPending(&scpi_context), 0);
+
+    output_write_limit = SIZE_MAX;
+    SCPI_InitOutputQueue(&scpi_context, NULL, 0);
+    output_buffer_clear();
+    error_buffer_clear();
+#endif
+}
+
 static void testErrorHandling(void) {
     output_buffer_clear();
     error_buffer_clear();
@@ -368,11 +631,11 @@ static void testErrorHandlingDeviceDependent(void) {
 #if USE_DEVICE_DEPENDENT_ERROR_INFORMATION
     TEST_CMDERR("-101,\"Invalid character;Test6\"\r\n");
     TEST_CMDERR("-101,\"Invalid character;Test7\"\r\n");
-#if USE_MEMORY_ALLOCATION_FREE
+#if USE_MEMORY_ALLOCATION_FREE || USE_ERROR_INFO_SLAB
     TEST_CMDERR("-101,\"Invalid character;Test8\"\r\n");
 #else /* USE_MEMORY_ALLOCATION_FREE */
     TEST_CMDERR("-101,\"Invalid character\"\r\n");
-#endif /* USE_MEMORY_ALLOCATION_FREE */
+#endif /* USE_MEMORY_ALLOCATION_FREE || USE_ERROR_INFO_SLAB */
 #else /* USE_DEVICE_DEPENDENT_ERROR_INFORMATION */
     TEST_CMDERR("-101,\"Invalid character\"\r\n");
     TEST_CMDERR("-101,\"Invalid character\"\r\n");
@@ -416,7 +679,11 @@ static void testIEEE4882(void) {
 
     srq_val = 0;
     TEST_IEEE4882("ABCD\r\n", ""); /* "Undefined header" cause command error */
+#if USE_REGISTER_ATOMIC
+    CU_ASSERT_EQUAL(srq_val, (STB_ESR | STB_SRQ)); /* value of STB at rising edge of service request */
+#else
     CU_ASSERT_EQUAL(srq_val, (STB_ESR | STB_SRQ | STB_QMA)); /* value of STB as service request */
+#endif
     TEST_IEEE4882("*STB?\r\n", "100\r\n"); /* Event status register + Service request */
     TEST_IEEE4882("*ESR?\r\n", "32\r\n"); /* Command error */
 
@@ -551,6 +818,10 @@ static void testSCPI_ParamInt32(void) {
     /* test range */
     TEST_ParamInt32("2147483647", TRUE, 2147483647, TRUE, 0);
     TEST_ParamInt32("-2147483647", TRUE, -2147483647, TRUE, 0);
+    TEST_ParamInt32("-2147483648", TRUE, INT32_MIN, TRUE, 0);
+    TEST_ParamInt32("2147483648", TRUE, 0, FALSE, SCPI_ERROR_DATA_OUT_OF_RANGE);
+    TEST_ParamInt32("#HFFFFFFFF", TRUE, -1, TRUE, 0);
+    TEST_ParamInt32("#H100000000", TRUE, 0, FALSE, SCPI_ERROR_DATA_OUT_OF_RANGE);
 }
 
 #define TEST_ParamUInt32(data, mandatory, expected_value, expected_result, expected_error_code) \
@@ -590,6 +861,10 @@ static void testSCPI_ParamUInt32(void) {
     /* test range */
     TEST_ParamUInt32("2147483647", TRUE, 2147483647ULL, TRUE, 0);
     TEST_ParamUInt32("4294967295", TRUE, 4294967295ULL, TRUE, 0);
+    TEST_ParamUInt32("4294967296", TRUE, 0, FALSE, SCPI_ERROR_DATA_OUT_OF_RANGE);
+    TEST_ParamUInt32("-1", TRUE, 0, FALSE, SCPI_ERROR_DATA_OUT_OF_RANGE);
+    TEST_ParamUInt32("#B11111111111111111111111111111111", TRUE, 4294967295ULL, TRUE, 0);
+    TEST_ParamUInt32("#Q40000000000", TRUE, 0, FALSE, SCPI_ERROR_DATA_OUT_OF_RANGE);
 }
 
 #define TEST_ParamInt64(data, mandatory, expected_value, expected_result, expected_error_code) \
@@ -631,6 +906,8 @@ static void testSCPI_ParamInt64(void) {
     TEST_ParamInt64("-2147483647", TRUE, -2147483647LL, TRUE, 0);
     TEST_ParamInt64("9223372036854775807", TRUE, 9223372036854775807LL, TRUE, 0);
     TEST_ParamInt64("-9223372036854775807", TRUE, -9223372036854775807LL, TRUE, 0);
+    TEST_ParamInt64("9223372036854775808", TRUE, 0, FALSE, SCPI_ERROR_DATA_OUT_OF_RANGE);
+    TEST_ParamInt64("#HFEDCBA9876543210", TRUE, -81985529216486896LL, TRUE, 0);
 }
 
 #define TEST_ParamUInt64(data, mandatory, expected_value, expected_result, expected_error_code) \
@@ -672,6 +949,9 @@ static void testSCPI_ParamUInt64(void) {
     TEST_ParamUInt64("4294967295", TRUE, 4294967295ULL, TRUE, 0);
     TEST_ParamUInt64("9223372036854775807", TRUE, 9223372036854775807ULL, TRUE, 0);
     TEST_ParamUInt64("18446744073709551615", TRUE, 18446744073709551615ULL, TRUE, 0);
+    TEST_ParamUInt64("18446744073709551616", TRUE, 0, FALSE, SCPI_ERROR_DATA_OUT_OF_RANGE);
+    TEST_ParamUInt64("#HFFFFFFFFFFFFFFFF", TRUE, 18446744073709551615ULL, TRUE, 0);
+    TEST_ParamUInt64("#H1FFFFFFFFFFFFFFFF", TRUE, 0, FALSE, SCPI_ERROR_DATA_OUT_OF_RANGE);
 }
 
 
@@ -905,6 +1185,200 @@ static void testSCPI_ParamChoice(void) {
     TEST_ParamChoice("SOUR", TRUE, 3, TRUE, 0);
 }
 
+static const scpi_choice_def_t test_trigger_source[] = {
+    {"IMMediate", 0}, {"BUS", 1}, {"EXTernal", 2}, {"MANual", 3},
+    {"TIMer", 4}, {"LINE", 5}, {"INTernal", 6}, {"SOFTware", 7},
+    {"LAN0", 10}, {"LAN1", 11}, {"LAN2", 12}, {"LAN3", 13},
+    {"LAN4", 14}, {"LAN5", 15}, {"LAN6", 16}, {"LAN7", 17},
+    {"TTLTrg0", 20}, {"TTLTrg1", 21}, {"TTLTrg2", 22}, {"TTLTrg3", 23},
+    {"TTLTrg4", 24}, {"TTLTrg5", 25}, {"TTLTrg6", 26}, {"TTLTrg7", 27},
+    {"ECLTrg0", 30}, {"ECLTrg1", 31}, {"STARtrigger", 32}, {"STOPtrigger", 33},
+    {"PXI0", 40}, {"PXI1", 41}, {"PXI2", 42}, {"PXI3", 43},
+    {"ARMed", 50}, {"LEVel", 51}, {"EDGE", 52}, {"WINDow", 53},
+    {"SLOPe", 54}, {"PULSe", 55}, {"VIDeo", 56}, {"PATTern", 57},
+    {"TIM", 60}, {"EXTRA", 2}, {"IMMEDIATE", 61},
+    SCPI_CHOICE_LIST_END
+};
+
+static const scpi_choice_def_t test_channel_choice[] = {
+    {"ALL", 0}, {"NONE", 1}, {"FIRSt", 2}, {"LAST", 3},
+    {"EVEN", 4}, {"ODD", 5}, {"MASTer", 6}, {"SLAVe", 7},
+    {"CHANnel#", 8},
+    SCPI_CHOICE_LIST_END
+};
+
+static void testChoiceIndex(void) {
+    const char * text;
+    int32_t value;
+
+    {
+        scpi_choice_def_t * test_options = (scpi_choice_def_t *) test_trigger_source;
+
+        TEST_ParamChoice("IMM", TRUE, 0, TRUE, 0);
+        TEST_ParamChoice("immediate", TRUE, 0, TRUE, 0);
+        TEST_ParamChoice("IMMED", TRUE, 0, FALSE, SCPI_ERROR_ILLEGAL_PARAMETER_VALUE);
+        TEST_ParamChoice("ext", TRUE, 2, TRUE, 0);
+        TEST_ParamChoice("EXTRA", TRUE, 2, TRUE, 0);
+        TEST_ParamChoice("LAN5", TRUE, 15, TRUE, 0);
+        TEST_ParamChoice("ttltrg7", TRUE, 27, TRUE, 0);
+        TEST_ParamChoice("TTLTRG3", TRUE, 23, TRUE, 0);
+        TEST_ParamChoice("STAR", TRUE, 32, TRUE, 0);
+        TEST_ParamChoice("STOPTRIGGER", TRUE, 33, TRUE, 0);
+        TEST_ParamChoice("PATT", TRUE, 57, TRUE, 0);
+        TEST_ParamChoice("TIM", TRUE, 4, TRUE, 0);
+        TEST_ParamChoice("LAN8", TRUE, 0, FALSE, SCPI_ERROR_ILLEGAL_PARAMETER_VALUE);
+        TEST_ParamChoice("1", TRUE, 0, FALSE, SCPI_ERROR_DATA_TYPE_ERROR);
+    }
+
+    {
+        scpi_choice_def_t * test_options = (scpi_choice_def_t *) test_channel_choice;
+
+        TEST_ParamChoice("MAST", TRUE, 6, TRUE, 0);
+        TEST_ParamChoice("CHAN3", TRUE, 8, TRUE, 0);
+        TEST_ParamChoice("channel12", TRUE, 8, TRUE, 0);
+        TEST_ParamChoice("CHANN", TRUE, 0, FALSE, SCPI_ERROR_ILLEGAL_PARAMETER_VALUE);
+    }
+
+    CU_ASSERT_EQUAL(SCPI_ChoiceToNameEx(&scpi_context, test_trigger_source, 2, &text), TRUE);
+    CU_ASSERT_STRING_EQUAL(text, "EXTernal");
+    CU_ASSERT_EQUAL(SCPI_ChoiceToNameEx(&scpi_context, test_trigger_source, 57, &text), TRUE);
+    CU_ASSERT_STRING_EQUAL(text, "PATTern");
+    CU_ASSERT_EQUAL(SCPI_ChoiceToNameEx(&scpi_context, test_trigger_source, 61, &text), TRUE);
+    CU_ASSERT_STRING_EQUAL(text, "IMMEDIATE");
+    CU_ASSERT_EQUAL(SCPI_ChoiceToNameEx(&scpi_context, test_trigger_source, 9, &text), FALSE);
+    CU_ASSERT_EQUAL(SCPI_ChoiceToNameEx(&scpi_context, test_channel_choice, 8, &text), TRUE);
+    CU_ASSERT_STRING_EQUAL(text, "CHANnel#");
+    CU_ASSERT_EQUAL(SCPI_ChoiceToNameEx(&scpi_context, scpi_bool_def, 1, &text), TRUE);
+    CU_ASSERT_STRING_EQUAL(text, "ON");
+
+    for (value = 0; value < 64; value++) {
+        const char * text_linear = NULL;
+        scpi_bool_t found = SCPI_ChoiceToName(test_trigger_source, value, &text_linear);
+        text = NULL;
+        CU_ASSERT_EQUAL(SCPI_ChoiceToNameEx(&scpi_context, test_trigger_source, value, &text), found);
+        CU_ASSERT_EQUAL(text, text_linear);
+    }
+}
+
+#define TEST_ParamView(data, expected_kind, expected_integer, expected_fraction, expected_exponent, expected_suffix) \
+{                                                                                       \
+    scpi_param_view_t view;                                                             \
+                                                                                        \
+    SCPI_CoreCls(&scpi_context);                                                        \
+    scpi_context.input_count = 0;                                                       \
+    scpi_context.param_list.lex_state.buffer = data;                                    \
+    scpi_context.param_list.lex_state.len = strlen(scpi_context.param_list.lex_state.buffer);\
+    scpi_context.param_list.lex_state.pos = scpi_context.param_list.lex_state.buffer;   \
+    CU_ASSERT_EQUAL(SCPI_ParamView(&scpi_context, &view, TRUE), TRUE);                  \
+    CU_ASSERT_EQUAL(view.kind, expected_kind);                                          \
+    CU_ASSERT_EQUAL(view.integer_len, strlen(expected_integer));                        \
+    if (strlen(expected_integer)) CU_ASSERT_NSTRING_EQUAL(view.integer, expected_integer, view.integer_len); \
+    CU_ASSERT_EQUAL(view.fraction_len, strlen(expected_fraction));                      \
+    if (strlen(expected_fraction)) CU_ASSERT_NSTRING_EQUAL(view.fraction, expected_fraction, view.fraction_len); \
+    CU_ASSERT_EQUAL(view.exponent_len, strlen(expected_exponent));                      \
+    if (strlen(expected_exponent)) CU_ASSERT_NSTRING_EQUAL(view.exponent, expected_exponent, view.exponent_len); \
+    CU_ASSERT_EQUAL(view.suffix_len, strlen(expected_suffix));                          \
+    if (strlen(expected_suffix)) CU_ASSERT_NSTRING_EQUAL(view.suffix, expected_suffix, view.suffix_len); \
+}
+
+#define TEST_ViewToInt(data, type, func, expected_value, expected_result, expected_error_code) \
+{                                                                                       \
+    scpi_param_view_t view;                                                             \
+    type value;                                                                         \
+    scpi_bool_t result;                                                                 \
+    scpi_error_t errCode;                                                               \
+                                                                                        \
+    SCPI_CoreCls(&scpi_context);                                                        \
+    scpi_context.input_count = 0;                                                       \
+    scpi_context.param_list.lex_state.buffer = data;                                    \
+    scpi_context.param_list.lex_state.len = strlen(scpi_context.param_list.lex_state.buffer);\
+    scpi_context.param_list.lex_state.pos = scpi_context.param_list.lex_state.buffer;   \
+    SCPI_ParamView(&scpi_context, &view, TRUE);                                         \
+    result = func(&scpi_context, &view, &value);                                        \
+                                                                                        \
+    SCPI_ErrorPop(&scpi_context, &errCode);                                             \
+    CU_ASSERT_EQUAL(result, expected_result);                                           \
+    if (expected_result) {                                                              \
+        CU_ASSERT_EQUAL(value, expected_value);                                         \
+    }                                                                                   \
+    CU_ASSERT_EQUAL(errCode.error_code, expected_error_code);                           \
+}
+
+static void testParamView(void) {
+    scpi_param_view_t view;
+    double value;
+
+    TEST_ParamView("10", SCPI_VIEW_INTEGER, "10", "", "", "");
+    TEST_ParamView("-12.50", SCPI_VIEW_REAL, "12", "50", "", "");
+    TEST_ParamView(".5e-3", SCPI_VIEW_REAL, "", "5", "-3", "");
+    TEST_ParamView("1 E +2 mV", SCPI_VIEW_REAL, "1", "", "+2", "mV");
+    TEST_ParamView("5 EV", SCPI_VIEW_INTEGER, "5", "", "", "EV");
+    TEST_ParamView("100KHZ", SCPI_VIEW_INTEGER, "100", "", "", "KHZ");
+    TEST_ParamView("#H1F", SCPI_VIEW_NONDECIMAL, "1F", "", "", "");
+    TEST_ParamView("MAXimum", SCPI_VIEW_MNEMONIC, "", "", "", "");
+    TEST_ParamView("'text'", SCPI_VIEW_STRING, "", "", "", "");
+    TEST_ParamView("#12AB", SCPI_VIEW_BLOCK, "", "", "", "");
+    TEST_ParamView("(1:3)", SCPI_VIEW_EXPRESSION, "", "", "", "");
+
+    TEST_ViewToInt("10", int32_t, SCPI_ViewToInt32, 10, TRUE, 0);
+    TEST_ViewToInt("-10", int32_t, SCPI_ViewToInt32, -10, TRUE, 0);
+    TEST_ViewToInt("1.5E1", int32_t, SCPI_ViewToInt32, 15, TRUE, 0);
+    TEST_ViewToInt("2.000", int32_t, SCPI_ViewToInt32, 2, TRUE, 0);
+    TEST_ViewToInt("1200E-2", int32_t, SCPI_ViewToInt32, 12, TRUE, 0);
+    TEST_ViewToInt("0.0E99999", int32_t, SCPI_ViewToInt32, 0, TRUE, 0);
+    TEST_ViewToInt("2 V", int32_t, SCPI_ViewToInt32, 0, FALSE, SCPI_ERROR_SUFFIX_NOT_ALLOWED);
+    TEST_ViewToInt("5 KHZ", uint32_t, SCPI_ViewToUInt32, 0, FALSE, SCPI_ERROR_SUFFIX_NOT_ALLOWED);
+    TEST_ViewToInt("10 MV", int64_t, SCPI_ViewToInt64, 0, FALSE, SCPI_ERROR_SUFFIX_NOT_ALLOWED);
+    TEST_ViewToInt("-2147483648", int32_t, SCPI_ViewToInt32, INT32_MIN, TRUE, 0);
+    TEST_ViewToInt("2147483648", int32_t, SCPI_ViewToInt32, 0, FALSE, SCPI_ERROR_DATA_OUT_OF_RANGE);
+    TEST_ViewToInt("1E10", int32_t, SCPI_ViewToInt32, 0, FALSE, SCPI_ERROR_DATA_OUT_OF_RANGE);
+    TEST_ViewToInt("1.5", int32_t, SCPI_ViewToInt32, 0, FALSE, SCPI_ERROR_ILLEGAL_PARAMETER_VALUE);
+    TEST_ViewToInt("15E-1", int32_t, SCPI_ViewToInt32, 0, FALSE, SCPI_ERROR_ILLEGAL_PARAMETER_VALUE);
+    TEST_ViewToInt("#HFFFFFFFF", int32_t, SCPI_ViewToInt32, -1, TRUE, 0);
+    TEST_ViewToInt("#H100000000", int32_t, SCPI_ViewToInt32, 0, FALSE, SCPI_ERROR_DATA_OUT_OF_RANGE);
+    TEST_ViewToInt("MIN", int32_t, SCPI_ViewToInt32, 0, FALSE, SCPI_ERROR_DATA_TYPE_ERROR);
+    TEST_ViewToInt("4294967295", uint32_t, SCPI_ViewToUInt32, 4294967295u, TRUE, 0);
+    TEST_ViewToInt("-1", uint32_t, SCPI_ViewToUInt32, 0, FALSE, SCPI_ERROR_DATA_OUT_OF_RANGE);
+    TEST_ViewToInt("-0", uint32_t, SCPI_ViewToUInt32, 0, TRUE, 0);
+    TEST_ViewToInt("9223372036854775807", int64_t, SCPI_ViewToInt64, INT64_MAX, TRUE, 0);
+    TEST_ViewToInt("-9.223372036854775808E18", int64_t, SCPI_ViewToInt64, INT64_MIN, TRUE, 0);
+    TEST_ViewToInt("9223372036854775808", int64_t, SCPI_ViewToInt64, 0, FALSE, SCPI_ERROR_DATA_OUT_OF_RANGE);
+    TEST_ViewToInt("123456789012345678901234", int64_t, SCPI_ViewToInt64, 0, FALSE, SCPI_ERROR_DATA_OUT_OF_RANGE);
+
+    SCPI_CoreCls(&scpi_context);
+    scpi_context.input_count = 0;
+    scpi_context.param_list.lex_state.buffer = "MAX, 2.5E-3, #Q17, ON, 2.5E-3 V";
+    scpi_context.param_list.lex_state.len = strlen(scpi_context.param_list.lex_state.buffer);
+    scpi_context.param_list.lex_state.pos = scpi_context.param_list.lex_state.buffer;
+
+    CU_ASSERT_EQUAL(SCPI_ParamView(&scpi_context, &view, TRUE), TRUE);
+    CU_ASSERT_EQUAL(SCPI_ViewIsKeyword(&view, "MAXimum"), TRUE);
+    CU_ASSERT_EQUAL(SCPI_ViewIsKeyword(&view, "MINimum"), FALSE);
+    CU_ASSERT_EQUAL(SCPI_ParamView(&scpi_context, &view, TRUE), TRUE);
+    CU_ASSERT_EQUAL(SCPI_ViewIsKeyword(&view, "MAXimum"), FALSE);
+    CU_ASSERT_EQUAL(SCPI_ViewToDouble(&scpi_context, &view, &value), TRUE);
+    CU_ASSERT_DOUBLE_EQUAL(value, 2.5e-3, 1e-12);
+    CU_ASSERT_EQUAL(SCPI_ParamView(&scpi_context, &view, TRUE), TRUE);
+    CU_ASSERT_EQUAL(SCPI_ViewToDouble(&scpi_context, &view, &value), TRUE);
+    CU_ASSERT_DOUBLE_EQUAL(value, 15, 0);
+    CU_ASSERT_EQUAL(SCPI_ParamView(&scpi_context, &view, TRUE), TRUE);
+    {
+        int32_t tag;
+        CU_ASSERT_EQUAL(SCPI_ViewToChoice(&scpi_context, &view, scpi_bool_def, &tag), TRUE);
+        CU_ASSERT_EQUAL(tag, 1);
+    }
+    CU_ASSERT_EQUAL(SCPI_ErrorCount(&scpi_context), 0);
+    CU_ASSERT_EQUAL(SCPI_ParamView(&scpi_context, &view, TRUE), TRUE);
+    CU_ASSERT_EQUAL(SCPI_ViewToDouble(&scpi_context, &view, &value), FALSE);
+    CU_ASSERT_EQUAL(SCPI_ParamView(&scpi_context, &view, FALSE), FALSE);
+    {
+        scpi_error_t errCode;
+        SCPI_ErrorPop(&scpi_context, &errCode);
+        CU_ASSERT_EQUAL(errCode.error_code, SCPI_ERROR_SUFFIX_NOT_ALLOWED);
+    }
+    CU_ASSERT_EQUAL(SCPI_ErrorCount(&scpi_context), 0);
+}
+
 #define TEST_NumericListInt(data, index, expected_range, expected_from, expected_to, expected_result, expected_error_code) \
 {                                                                                       \
     scpi_bool_t result;                                                                 \
@@ -989,6 +1463,93 @@ static void testNumericList(void) {
     TEST_NumericListDouble("aaaa", 2, FALSE, 0, 0, SCPI_EXPR_ERROR, SCPI_ERROR_DATA_TYPE_ERROR);
 }
 
+static void testNumericListIterator(void) {
+    scpi_parameter_t param;
+    scpi_expr_numeric_list_t list;
+    scpi_bool_t range;
+    int32_t from, to;
+    double dfrom, dto;
+    int32_t values[8];
+    size_t count;
+    scpi_error_t errCode;
+
+#define TEST_NumericListParam(data) {                                                   \
+    SCPI_CoreCls(&scpi_context);                                                        \
+    scpi_context.input_count = 0;                                                       \
+    scpi_context.param_list.lex_state.buffer = data;                                    \
+    scpi_context.param_list.lex_state.len = strlen(scpi_context.param_list.lex_state.buffer);\
+    scpi_context.param_list.lex_state.pos = scpi_context.param_list.lex_state.buffer;   \
+    SCPI_Parameter(&scpi_context, &param, TRUE);                                        \
+}
+
+    TEST_NumericListParam("(1:3,7,5:4)");
+    CU_ASSERT_EQUAL(SCPI_ExprNumericListBegin(&scpi_context, &param, &list), SCPI_EXPR_OK);
+    CU_ASSERT_EQUAL(SCPI_ExprNumericListNextInt(&scpi_context, &list, &range, &from, &to), SCPI_EXPR_OK);
+    CU_ASSERT_EQUAL(range, TRUE);
+    CU_ASSERT_EQUAL(from, 1);
+    CU_ASSERT_EQUAL(to, 3);
+    CU_ASSERT_EQUAL(SCPI_ExprNumericListNextInt(&scpi_context, &list, &range, &from, &to), SCPI_EXPR_OK);
+    CU_ASSERT_EQUAL(range, FALSE);
+    CU_ASSERT_EQUAL(from, 7);
+    CU_ASSERT_EQUAL(SCPI_ExprNumericListNextDouble(&scpi_context, &list, &range, &dfrom, &dto), SCPI_EXPR_OK);
+    CU_ASSERT_EQUAL(range, TRUE);
+    CU_ASSERT_DOUBLE_EQUAL(dfrom, 5, 0.0001);
+    CU_ASSERT_DOUBLE_EQUAL(dto, 4, 0.0001);
+    CU_ASSERT_EQUAL(SCPI_ExprNumericListNextInt(&scpi_context, &list, &range, &from, &to), SCPI_EXPR_NO_MORE);
+    CU_ASSERT_EQUAL(SCPI_ExprNumericListNextInt(&scpi_context, &list, &range, &from, &to), SCPI_EXPR_NO_MORE);
+    CU_ASSERT_EQUAL(SCPI_ErrorCount(&scpi_context), 0);
+
+    CU_ASSERT_EQUAL(SCPI_ExprNumericListExpandInt(&scpi_context, &param, values, 8, &count), SCPI_EXPR_OK);
+    CU_ASSERT_EQUAL(count, 6);
+    CU_ASSERT_EQUAL(values[0], 1);
+    CU_ASSERT_EQUAL(values[2], 3);
+    CU_ASSERT_EQUAL(values[3], 7);
+    CU_ASSERT_EQUAL(values[4], 5);
+    CU_ASSERT_EQUAL(values[5], 4);
+
+    CU_ASSERT_EQUAL(SCPI_ExprNumericListExpandInt(&scpi_context, &param, values, 5, &count), SCPI_EXPR_ERROR);
+    CU_ASSERT_EQUAL(count, 0);
+    SCPI_ErrorPop(&scpi_context, &errCode);
+    CU_ASSERT_EQUAL(errCode.error_code, SCPI_ERROR_DATA_OUT_OF_RANGE);
+
+    TEST_NumericListParam("(12,5:6:3)");
+    CU_ASSERT_EQUAL(SCPI_ExprNumericListExpandInt(&scpi_context, &param, values, 8, &count), SCPI_EXPR_ERROR);
+    SCPI_ErrorPop(&scpi_context, &errCode);
+    CU_ASSERT_EQUAL(errCode.error_code, SCPI_ERROR_EXPRESSION_PARSING_ERROR);
+
+    TEST_NumericListParam("(1:ABC)");
+    CU_ASSERT_EQUAL(SCPI_ExprNumericListExpandInt(&scpi_context, &param, values, 8, &count), SCPI_EXPR_ERROR);
+    CU_ASSERT_EQUAL(count, 0);
+    SCPI_ErrorPop(&scpi_context, &errCode);
+    CU_ASSERT_EQUAL(errCode.error_code, SCPI_ERROR_EXPRESSION_PARSING_ERROR);
+
+    TEST_NumericListParam("(1,3000000000:2)");
+    CU_ASSERT_EQUAL(SCPI_ExprNumericListBegin(&scpi_context, &param, &list), SCPI_EXPR_OK);
+    CU_ASSERT_EQUAL(SCPI_ExprNumericListNextInt(&scpi_context, &list, &range, &from, &to), SCPI_EXPR_OK);
+    CU_ASSERT_EQUAL(SCPI_ExprNumericListNextInt(&scpi_context, &list, &range, &from, &to), SCPI_EXPR_ERROR);
+    SCPI_ErrorPop(&scpi_context, &errCode);
+    CU_ASSERT_EQUAL(errCode.error_code, SCPI_ERROR_DATA_OUT_OF_RANGE);
+    CU_ASSERT_EQUAL(SCPI_ExprNumericListExpandInt(&scpi_context, &param, values, 8, &count), SCPI_EXPR_ERROR);
+    CU_ASSERT_EQUAL(count, 0);
+    SCPI_ErrorPop(&scpi_context, &errCode);
+    CU_ASSERT_EQUAL(errCode.error_code, SCPI_ERROR_DATA_OUT_OF_RANGE);
+
+    TEST_NumericListParam("(2:3000000000)");
+    CU_ASSERT_EQUAL(SCPI_ExprNumericListExpandInt(&scpi_context, &param, values, 8, &count), SCPI_EXPR_ERROR);
+    SCPI_ErrorPop(&scpi_context, &errCode);
+    CU_ASSERT_EQUAL(errCode.error_code, SCPI_ERROR_DATA_OUT_OF_RANGE);
+    CU_ASSERT_EQUAL(SCPI_ErrorCount(&scpi_context), 0);
+
+    TEST_NumericListParam("()");
+    CU_ASSERT_EQUAL(SCPI_ExprNumericListExpandInt(&scpi_context, &param, values, 8, &count), SCPI_EXPR_OK);
+    CU_ASSERT_EQUAL(count, 0);
+
+    TEST_NumericListParam("aaaa");
+    CU_ASSERT_EQUAL(SCPI_ExprNumericListBegin(&scpi_context, &param, &list), SCPI_EXPR_ERROR);
+    SCPI_ErrorPop(&scpi_context, &errCode);
+    CU_ASSERT_EQUAL(errCode.error_code, SCPI_ERROR_DATA_TYPE_ERROR);
+}
+
 #define NOPAREN(...) __VA_ARGS__
 
 #define TEST_ChannelList(data, index, val_len, expected_range, expected_dimensions, _expected_from, _expected_to, expected_result, expected_error_code) \
@@ -1061,6 +1622,208 @@ static void testChannelList(void) {
     TEST_ChannelList("abcd", 1, 1, FALSE, 0, (0), (0), SCPI_EXPR_ERROR, SCPI_ERROR_DATA_TYPE_ERROR);
 }
 
+#if USE_EXPRESSION_EVAL
+static void testExpressionEval(void) {
+    scpi_parameter_t param;
+    scpi_expr_code_t code;
+    scpi_expr_constant_t constants[] = {
+        {"VOLT_MAX", 10},
+        {"PI", 3},
+        SCPI_EXPR_CONSTANTS_END
+    };
+    double value;
+    scpi_error_t errCode;
+
+#define TEST_ExprEval(data, expected_value) {                                           \
+    TEST_NumericListParam(data);                                                        \
+    CU_ASSERT_EQUAL(SCPI_ExprEvalDouble(&scpi_context, &param, &value), SCPI_EXPR_OK);  \
+    CU_ASSERT_DOUBLE_EQUAL(value, expected_value, 0.000001);                            \
+    CU_ASSERT_EQUAL(SCPI_ErrorCount(&scpi_context), 0);                                 \
+}
+
+#define TEST_ExprEvalError(data, expected_error_code) {                                 \
+    TEST_NumericListParam(data);                                                        \
+    CU_ASSERT_EQUAL(SCPI_ExprEvalDouble(&scpi_context, &param, &value), SCPI_EXPR_ERROR);\
+    SCPI_ErrorPop(&scpi_context, &errCode);                                             \
+    CU_ASSERT_EQUAL(errCode.error_code, expected_error_code);                           \
+}
+
+    SCPI_ExprSetConstants(&scpi_context, NULL);
+    TEST_ExprEval("(2*PI*1E3)", 6283.185307);
+    TEST_ExprEval("(1 + 2*3 - 4/2)", 5);
+    TEST_ExprEval("(1-2-3)", -4);
+    TEST_ExprEval("(8/2/2)", 2);
+    TEST_ExprEval("(--2*-3)", -6);
+    TEST_ExprEval("( 1.5E-3 )", 0.0015);
+    TEST_ExprEvalError("(VOLT_MAX/2)", SCPI_ERROR_EXPRESSION_PARSING_ERROR);
+
+    SCPI_ExprSetConstants(&scpi_context, constants);
+    TEST_ExprEval("(VOLT_MAX/2)", 5);
+    TEST_ExprEval("(volt_max/2)", 5);
+    TEST_ExprEval("(PI)", 3);
+
+    /* compiled once, constants are read during evaluation */
+    constants[0].value = 20;
+    TEST_ExprEval("(VOLT_MAX/2)", 10);
+
+    TEST_NumericListParam("(VOLT_MAX-E)");
+    CU_ASSERT_EQUAL(SCPI_ExprCompile(&scpi_context, &param, &code), SCPI_EXPR_OK);
+    CU_ASSERT_EQUAL(SCPI_ExprEval(&scpi_context, &code, &value), SCPI_EXPR_OK);
+    CU_ASSERT_DOUBLE_EQUAL(value, 17.281718, 0.000001);
+
+    /* compiled code keeps its list of constants */
+    SCPI_ExprSetConstants(&scpi_context, NULL);
+    CU_ASSERT_EQUAL(SCPI_ExprEval(&scpi_context, &code, &value), SCPI_EXPR_OK);
+    CU_ASSERT_DOUBLE_EQUAL(value, 17.281718, 0.000001);
+    SCPI_ExprSetConstants(&scpi_context, constants);
+
+    TEST_ExprEvalError("(1+)", SCPI_ERROR_EXPRESSION_PARSING_ERROR);
+    TEST_ExprEvalError("(1 2)", SCPI_ERROR_EXPRESSION_PARSING_ERROR);
+    TEST_ExprEvalError("(1,2)", SCPI_ERROR_EXPRESSION_PARSING_ERROR);
+    TEST_ExprEvalError("(@1)", SCPI_ERROR_EXPRESSION_PARSING_ERROR);
+    TEST_ExprEvalError("()", SCPI_ERROR_EXPRESSION_PARSING_ERROR);
+    TEST_ExprEvalError("(1/0)", SCPI_ERROR_DATA_OUT_OF_RANGE);
+    TEST_ExprEvalError("(1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1)", SCPI_ERROR_EXPRESSION_PARSING_ERROR);
+
+    TEST_ParamDouble("(VOLT_MAX/4)", TRUE, 5, TRUE, 0);
+    TEST_ParamDouble("(1/0)", TRUE, 0, FALSE, SCPI_ERROR_DATA_OUT_OF_RANGE);
+
+    SCPI_ExprSetConstants(&scpi_context, NULL);
+}
+#endif
+
+static void testChannelListCompile(void) {
+    scpi_parameter_t param;
+    scpi_expr_channel_list_t list;
+    scpi_channel_set_t set;
+    scpi_channel_iterator_t it;
+    scpi_channel_range_t ranges[4];
+    uint32_t bits[2];
+    scpi_bool_t range;
+    int32_t from[2], to[2];
+    int32_t channel[2];
+    size_t dimensions;
+    scpi_error_t errCode;
+
+    TEST_NumericListParam("(@1,2!5:3!6)");
+    CU_ASSERT_EQUAL(SCPI_ExprChannelListBegin(&scpi_context, &param, &list), SCPI_EXPR_OK);
+    CU_ASSERT_EQUAL(SCPI_ExprChannelListNext(&scpi_context, &list, &range, from, to, 2, &dimensions), SCPI_EXPR_OK);
+    CU_ASSERT_EQUAL(range, FALSE);
+    CU_ASSERT_EQUAL(dimensions, 1);
+    CU_ASSERT_EQUAL(from[0], 1);
+    CU_ASSERT_EQUAL(SCPI_ExprChannelListNext(&scpi_context, &list, &range, from, to, 2, &dimensions), SCPI_EXPR_OK);
+    CU_ASSERT_EQUAL(range, TRUE);
+    CU_ASSERT_EQUAL(dimensions, 2);
+    CU_ASSERT_EQUAL(to[1], 6);
+    CU_ASSERT_EQUAL(SCPI_ExprChannelListNext(&scpi_context, &list, &range, from, to, 2, &dimensions), SCPI_EXPR_NO_MORE);
+    CU_ASSERT_EQUAL(SCPI_ErrorCount(&scpi_context), 0);
+
+    /* one dimension in bitset */
+    TEST_NumericListParam("(@40,3:1,33)");
+    SCPI_ChannelSetInit(&set, bits, 2, ranges, 4);
+    CU_ASSERT_EQUAL(SCPI_ExprChannelListCompile(&scpi_context, &param, &set), SCPI_EXPR_OK);
+    CU_ASSERT_EQUAL(set.dimensions, 1);
+    CU_ASSERT_EQUAL(set.ranges_count, 0);
+    channel[0] = 2;
+    CU_ASSERT_EQUAL(SCPI_ChannelSetContains(&set, channel, 1), TRUE);
+    channel[0] = 4;
+    CU_ASSERT_EQUAL(SCPI_ChannelSetContains(&set, channel, 1), FALSE);
+    channel[0] = 64;
+    CU_ASSERT_EQUAL(SCPI_ChannelSetContains(&set, channel, 1), FALSE);
+    SCPI_ChannelSetBegin(&set, &it);
+    CU_ASSERT_EQUAL(SCPI_ChannelSetNext(&set, &it, channel), TRUE);
+    CU_ASSERT_EQUAL(channel[0], 1);
+    CU_ASSERT_EQUAL(SCPI_ChannelSetNext(&set, &it, channel), TRUE);
+    CU_ASSERT_EQUAL(channel[0], 2);
+    CU_ASSERT_EQUAL(SCPI_ChannelSetNext(&set, &it, channel), TRUE);
+    CU_ASSERT_EQUAL(channel[0], 3);
+    CU_ASSERT_EQUAL(SCPI_ChannelSetNext(&set, &it, channel), TRUE);
+    CU_ASSERT_EQUAL(channel[0], 33);
+    CU_ASSERT_EQUAL(SCPI_ChannelSetNext(&set, &it, channel), TRUE);
+    CU_ASSERT_EQUAL(channel[0], 40);
+    CU_ASSERT_EQUAL(SCPI_ChannelSetNext(&set, &it, channel), FALSE);
+
+    /* iteration continues after the last bit of a word */
+    TEST_NumericListParam("(@31,33)");
+    SCPI_ChannelSetInit(&set, bits, 2, ranges, 4);
+    CU_ASSERT_EQUAL(SCPI_ExprChannelListCompile(&scpi_context, &param, &set), SCPI_EXPR_OK);
+    SCPI_ChannelSetBegin(&set, &it);
+    CU_ASSERT_EQUAL(SCPI_ChannelSetNext(&set, &it, channel), TRUE);
+    CU_ASSERT_EQUAL(channel[0], 31);
+    CU_ASSERT_EQUAL(SCPI_ChannelSetNext(&set, &it, channel), TRUE);
+    CU_ASSERT_EQUAL(channel[0], 33);
+    CU_ASSERT_EQUAL(SCPI_ChannelSetNext(&set, &it, channel), FALSE);
+
+    TEST_NumericListParam("(@31,63)");
+    CU_ASSERT_EQUAL(SCPI_ExprChannelListCompile(&scpi_context, &param, &set), SCPI_EXPR_OK);
+    SCPI_ChannelSetBegin(&set, &it);
+    CU_ASSERT_EQUAL(SCPI_ChannelSetNext(&set, &it, channel), TRUE);
+    CU_ASSERT_EQUAL(channel[0], 31);
+    CU_ASSERT_EQUAL(SCPI_ChannelSetNext(&set, &it, channel), TRUE);
+    CU_ASSERT_EQUAL(channel[0], 63);
+    CU_ASSERT_EQUAL(SCPI_ChannelSetNext(&set, &it, channel), FALSE);
+    CU_ASSERT_EQUAL(SCPI_ChannelSetNext(&set, &it, channel), FALSE);
+
+    TEST_NumericListParam("(@64)");
+    CU_ASSERT_EQUAL(SCPI_ExprChannelListCompile(&scpi_context, &param, &set), SCPI_EXPR_ERROR);
+    SCPI_ErrorPop(&scpi_context, &errCode);
+    CU_ASSERT_EQUAL(errCode.error_code, SCPI_ERROR_DATA_OUT_OF_RANGE);
+
+    /* more dimensions in sorted ranges */
+    TEST_NumericListParam("(@3!1,1!2:2!1,1!1)");
+    SCPI_ChannelSetInit(&set, bits, 2, ranges, 4);
+    CU_ASSERT_EQUAL(SCPI_ExprChannelListCompile(&scpi_context, &param, &set), SCPI_EXPR_OK);
+    CU_ASSERT_EQUAL(set.dimensions, 2);
+    CU_ASSERT_EQUAL(set.ranges_count, 3);
+    channel[0] = 2;
+    channel[1] = 2;
+    CU_ASSERT_EQUAL(SCPI_ChannelSetContains(&set, channel, 2), TRUE);
+    channel[0] = 3;
+    CU_ASSERT_EQUAL(SCPI_ChannelSetContains(&set, channel, 2), FALSE);
+    CU_ASSERT_EQUAL(SCPI_ChannelSetContains(&set, channel, 1), FALSE);
+    SCPI_ChannelSetBegin(&set, &it);
+    CU_ASSERT_EQUAL(SCPI_ChannelSetNext(&set, &it, channel), TRUE);
+    CU_ASSERT_EQUAL(channel[0], 1);
+    CU_ASSERT_EQUAL(channel[1], 1);
+    CU_ASSERT_EQUAL(SCPI_ChannelSetNext(&set, &it, channel), TRUE);
+    CU_ASSERT_EQUAL(channel[0], 1);
+    CU_ASSERT_EQUAL(channel[1], 2);
+    CU_ASSERT_EQUAL(SCPI_ChannelSetNext(&set, &it, channel), TRUE);
+    CU_ASSERT_EQUAL(channel[0], 2);
+    CU_ASSERT_EQUAL(channel[1], 1);
+    CU_ASSERT_EQUAL(SCPI_ChannelSetNext(&set, &it, channel), TRUE);
+    CU_ASSERT_EQUAL(channel[0], 2);
+    CU_ASSERT_EQUAL(channel[1], 2);
+    /* overlapping range with the same first channel keeps its list order */
+    CU_ASSERT_EQUAL(SCPI_ChannelSetNext(&set, &it, channel), TRUE);
+    CU_ASSERT_EQUAL(channel[0], 1);
+    CU_ASSERT_EQUAL(channel[1], 1);
+    CU_ASSERT_EQUAL(SCPI_ChannelSetNext(&set, &it, channel), TRUE);
+    CU_ASSERT_EQUAL(channel[0], 3);
+    CU_ASSERT_EQUAL(channel[1], 1);
+    CU_ASSERT_EQUAL(SCPI_ChannelSetNext(&set, &it, channel), FALSE);
+
+    TEST_NumericListParam("(@1!1,2)");
+    CU_ASSERT_EQUAL(SCPI_ExprChannelListCompile(&scpi_context, &param, &set), SCPI_EXPR_ERROR);
+    SCPI_ErrorPop(&scpi_context, &errCode);
+    CU_ASSERT_EQUAL(errCode.error_code, SCPI_ERROR_EXPRESSION_PARSING_ERROR);
+
+    /* one dimension without bitset */
+    TEST_NumericListParam("(@5:6,1)");
+    SCPI_ChannelSetInit(&set, NULL, 0, ranges, 1);
+    CU_ASSERT_EQUAL(SCPI_ExprChannelListCompile(&scpi_context, &param, &set), SCPI_EXPR_ERROR);
+    SCPI_ErrorPop(&scpi_context, &errCode);
+    CU_ASSERT_EQUAL(errCode.error_code, SCPI_ERROR_DATA_OUT_OF_RANGE);
+    SCPI_ChannelSetInit(&set, NULL, 0, ranges, 4);
+    CU_ASSERT_EQUAL(SCPI_ExprChannelListCompile(&scpi_context, &param, &set), SCPI_EXPR_OK);
+    CU_ASSERT_EQUAL(set.ranges_count, 2);
+    channel[0] = 6;
+    CU_ASSERT_EQUAL(SCPI_ChannelSetContains(&set, channel, 1), TRUE);
+    SCPI_ChannelSetBegin(&set, &it);
+    CU_ASSERT_EQUAL(SCPI_ChannelSetNext(&set, &it, channel), TRUE);
+    CU_ASSERT_EQUAL(channel[0], 1);
+}
+
 
 #define TEST_ParamNumber(data, mandatory, expected_special, expected_tag, expected_value, expected_unit, expected_base, expected_result, expected_error_code) \
 {                                                                                       \
@@ -1101,8 +1864,110 @@ static void testParamNumber(void) {
     TEST_ParamNumber("infinity", TRUE, TRUE, SCPI_NUM_INF, 0, SCPI_UNIT_NONE, 10, TRUE, 0);
     TEST_ParamNumber("minc", TRUE, TRUE, SCPI_NUM_NUMBER, 0, SCPI_UNIT_NONE, 10, FALSE, SCPI_ERROR_ILLEGAL_PARAMETER_VALUE);
     TEST_ParamNumber("100 xyz", TRUE, FALSE, SCPI_NUM_NUMBER, 100, SCPI_UNIT_NONE, 10, FALSE, SCPI_ERROR_INVALID_SUFFIX);
+    TEST_ParamNumber("\"100\"", TRUE, FALSE, SCPI_NUM_NUMBER, 100, SCPI_UNIT_NONE, 10, FALSE, SCPI_ERROR_DATA_TYPE_ERROR);
+    TEST_ParamNumber("1.5 KOHM", TRUE, FALSE, SCPI_NUM_NUMBER, 1500, SCPI_UNIT_OHM, 10, TRUE, 0);
+    TEST_ParamNumber("2 MOHM", TRUE, FALSE, SCPI_NUM_NUMBER, 2e6, SCPI_UNIT_OHM, 10, TRUE, 0);
+    TEST_ParamNumber("2 MAOHM", TRUE, FALSE, SCPI_NUM_NUMBER, 2e6, SCPI_UNIT_OHM, 10, TRUE, 0);
+    TEST_ParamNumber("3 mhz", TRUE, FALSE, SCPI_NUM_NUMBER, 3e6, SCPI_UNIT_HERTZ, 10, TRUE, 0);
+    TEST_ParamNumber("3 GHZ", TRUE, FALSE, SCPI_NUM_NUMBER, 3e9, SCPI_UNIT_HERTZ, 10, TRUE, 0);
+    TEST_ParamNumber("4 MA", TRUE, FALSE, SCPI_NUM_NUMBER, 4e-3, SCPI_UNIT_AMPER, 10, TRUE, 0);
+    TEST_ParamNumber("4 MAV", TRUE, FALSE, SCPI_NUM_NUMBER, 4e6, SCPI_UNIT_VOLT, 10, TRUE, 0);
+    TEST_ParamNumber("8 PEV", TRUE, FALSE, SCPI_NUM_NUMBER, 8e15, SCPI_UNIT_VOLT, 10, TRUE, 0);
+    TEST_ParamNumber("9 EXW", TRUE, FALSE, SCPI_NUM_NUMBER, 9e18, SCPI_UNIT_WATT, 10, TRUE, 0);
+    TEST_ParamNumber("1 UF", TRUE, FALSE, SCPI_NUM_NUMBER, 1e-6, SCPI_UNIT_FARAD, 10, TRUE, 0);
+    TEST_ParamNumber("1 AA", TRUE, FALSE, SCPI_NUM_NUMBER, 1e-18, SCPI_UNIT_AMPER, 10, TRUE, 0);
+    TEST_ParamNumber("1 KXYZ", TRUE, FALSE, SCPI_NUM_NUMBER, 1, SCPI_UNIT_NONE, 10, FALSE, SCPI_ERROR_INVALID_SUFFIX);
+    TEST_ParamNumber("2 KCEL", TRUE, FALSE, SCPI_NUM_NUMBER, 2, SCPI_UNIT_NONE, 10, FALSE, SCPI_ERROR_INVALID_SUFFIX);
+    TEST_ParamNumber("1 KKG", TRUE, FALSE, SCPI_NUM_NUMBER, 1, SCPI_UNIT_NONE, 10, FALSE, SCPI_ERROR_INVALID_SUFFIX);
+    TEST_ParamNumber("1 MDBM", TRUE, FALSE, SCPI_NUM_NUMBER, 1, SCPI_UNIT_NONE, 10, FALSE, SCPI_ERROR_INVALID_SUFFIX);
+    TEST_ParamNumber("1 KPCT", TRUE, FALSE, SCPI_NUM_NUMBER, 1, SCPI_UNIT_NONE, 10, FALSE, SCPI_ERROR_INVALID_SUFFIX);
+#if USE_UNITS_TIME
+    TEST_ParamNumber("5 NS", TRUE, FALSE, SCPI_NUM_NUMBER, 5e-9, SCPI_UNIT_SECOND, 10, TRUE, 0);
+    TEST_ParamNumber("5 MIN", TRUE, FALSE, SCPI_NUM_NUMBER, 300, SCPI_UNIT_SECOND, 10, TRUE, 0);
+    TEST_ParamNumber("1 KMIN", TRUE, FALSE, SCPI_NUM_NUMBER, 1, SCPI_UNIT_NONE, 10, FALSE, SCPI_ERROR_INVALID_SUFFIX);
+    TEST_ParamNumber("1 MHR", TRUE, FALSE, SCPI_NUM_NUMBER, 1, SCPI_UNIT_NONE, 10, FALSE, SCPI_ERROR_INVALID_SUFFIX);
+#endif
+#if USE_UNITS_DISTANCE
+    TEST_ParamNumber("6 MM", TRUE, FALSE, SCPI_NUM_NUMBER, 6e-3, SCPI_UNIT_METER, 10, TRUE, 0);
+#endif
+#if USE_UNITS_ENERGY_FORCE_MASS
+    TEST_ParamNumber("7 KG", TRUE, FALSE, SCPI_NUM_NUMBER, 7, SCPI_UNIT_KILOGRAM, 10, TRUE, 0);
+    TEST_ParamNumber("7 MG", TRUE, FALSE, SCPI_NUM_NUMBER, 7e-6, SCPI_UNIT_KILOGRAM, 10, TRUE, 0);
+    TEST_ParamNumber("1 UG", TRUE, FALSE, SCPI_NUM_NUMBER, 1e-9, SCPI_UNIT_KILOGRAM, 10, TRUE, 0);
+    TEST_ParamNumber("1 KTNE", TRUE, FALSE, SCPI_NUM_NUMBER, 1, SCPI_UNIT_NONE, 10, FALSE, SCPI_ERROR_INVALID_SUFFIX);
+#endif
+#if USE_UNITS_ANGLE
+    TEST_ParamNumber("1 KMNT", TRUE, FALSE, SCPI_NUM_NUMBER, 1, SCPI_UNIT_NONE, 10, FALSE, SCPI_ERROR_INVALID_SUFFIX);
+#endif
+#if USE_EXPRESSION_EVAL
+    TEST_ParamNumber("(2*PI)", TRUE, FALSE, SCPI_NUM_NUMBER, 6.283185, SCPI_UNIT_NONE, 10, TRUE, 0);
+    TEST_ParamNumber("(1/0)", TRUE, FALSE, SCPI_NUM_NUMBER, 0, SCPI_UNIT_NONE, 10, FALSE, SCPI_ERROR_DATA_OUT_OF_RANGE);
+#endif
+}
+
+#if USE_NUMBER_EXACT
+#define TEST_NumberToInt(data, type, func, expected_value, expected_result, expected_error_code) \
+{                                                                                       \
+    scpi_number_t number;                                                               \
+    type value;                                                                         \
+    scpi_bool_t result;                                                                 \
+    scpi_error_t errCode;                                                               \
+                                                                                        \
+    SCPI_CoreCls(&scpi_context);                                                        \
+    scpi_context.input_count = 0;                                                       \
+    scpi_context.param_list.lex_state.buffer = data;                                    \
+    scpi_context.param_list.lex_state.len = strlen(scpi_context.param_list.lex_state.buffer);\
+    scpi_context.param_list.lex_state.pos = scpi_context.param_list.lex_state.buffer;   \
+    result = SCPI_ParamNumber(&scpi_context, scpi_special_numbers_def, &number, TRUE) &&\
+        func(&scpi_context, &number, &value);                                           \
+                                                                                        \
+    SCPI_ErrorPop(&scpi_context, &errCode);                                             \
+    CU_ASSERT_EQUAL(result, expected_result);                                           \
+    if (expected_result) {                                                              \
+        CU_ASSERT_EQUAL(value, expected_value);                                         \
+    }                                                                                   \
+    CU_ASSERT_EQUAL(errCode.error_code, expected_error_code);                           \
 }
 
+static void testNumberExact(void) {
+    TEST_NumberToInt("12345678901234567 HZ", uint64_t, SCPI_NumberToUInt64, 12345678901234567ull, TRUE, 0);
+    TEST_NumberToInt("12345678.901234567 GHZ", uint64_t, SCPI_NumberToUInt64, 12345678901234567ull, TRUE, 0);
+    TEST_NumberToInt("12.345678901234567 MHZ", uint64_t, SCPI_NumberToUInt64, 0, FALSE, SCPI_ERROR_ILLEGAL_PARAMETER_VALUE);
+    TEST_NumberToInt("18446744073709551615", uint64_t, SCPI_NumberToUInt64, UINT64_MAX, TRUE, 0);
+    TEST_NumberToInt("18446744073709551616", uint64_t, SCPI_NumberToUInt64, 0, FALSE, SCPI_ERROR_DATA_OUT_OF_RANGE);
+    TEST_NumberToInt("1844674407370955161.6E1", uint64_t, SCPI_NumberToUInt64, 0, FALSE, SCPI_ERROR_DATA_OUT_OF_RANGE);
+    TEST_NumberToInt("18446744073709551620", uint64_t, SCPI_NumberToUInt64, 0, FALSE, SCPI_ERROR_DATA_OUT_OF_RANGE);
+    TEST_NumberToInt("#HFFFFFFFFFFFFFFFF", uint64_t, SCPI_NumberToUInt64, UINT64_MAX, TRUE, 0);
+    TEST_NumberToInt("#HFFFFFFFFFFFFFFFF", int64_t, SCPI_NumberToInt64, -1, TRUE, 0);
+    TEST_NumberToInt("-9223372036854775808", int64_t, SCPI_NumberToInt64, INT64_MIN, TRUE, 0);
+    TEST_NumberToInt("9223372036854775808", int64_t, SCPI_NumberToInt64, 0, FALSE, SCPI_ERROR_DATA_OUT_OF_RANGE);
+    TEST_NumberToInt("-1", uint64_t, SCPI_NumberToUInt64, 0, FALSE, SCPI_ERROR_DATA_OUT_OF_RANGE);
+    TEST_NumberToInt("1.5 KHZ", int64_t, SCPI_NumberToInt64, 1500, TRUE, 0);
+    TEST_NumberToInt("2.5 MOHM", int64_t, SCPI_NumberToInt64, 2500000, TRUE, 0);
+    TEST_NumberToInt("1500 MV", int64_t, SCPI_NumberToInt64, 0, FALSE, SCPI_ERROR_ILLEGAL_PARAMETER_VALUE);
+#if USE_UNITS_ENERGY_FORCE_MASS
+    TEST_NumberToInt("3000 MG", int64_t, SCPI_NumberToInt64, 0, FALSE, SCPI_ERROR_ILLEGAL_PARAMETER_VALUE);
+    TEST_NumberToInt("3 TNE", int64_t, SCPI_NumberToInt64, 3000, TRUE, 0);
+#endif
+#if USE_UNITS_TIME
+    TEST_NumberToInt("5 MIN", int64_t, SCPI_NumberToInt64, 300, TRUE, 0);
+#endif
+    TEST_NumberToInt("0.00E-30000", int64_t, SCPI_NumberToInt64, 0, TRUE, 0);
+    TEST_NumberToInt("1E25", int64_t, SCPI_NumberToInt64, 0, FALSE, SCPI_ERROR_DATA_OUT_OF_RANGE);
+    TEST_NumberToInt("MAX", int64_t, SCPI_NumberToInt64, 0, FALSE, SCPI_ERROR_DATA_TYPE_ERROR);
+
+    {
+        scpi_number_t number;
+        memset(&number, 0, sizeof (number));
+        number.content.value = 4096.0;
+        number.base = 10;
+        int64_t value;
+        CU_ASSERT_EQUAL(SCPI_NumberToInt64(&scpi_context, &number, &value), TRUE);
+        CU_ASSERT_EQUAL(value, 4096);
+    }
+}
+#endif /* USE_NUMBER_EXACT */
+
 #define TEST_Result(func, value, expected_result) \
 {\
     output_buffer_clear();\
@@ -1249,11 +2114,19 @@ static void testResultFloat(void) {
     TEST_Result(Float, -128, "-128");
     TEST_Result(Float, 32767, "32767");
     TEST_Result(Float, -32768, "-32768");
+#if USE_BUILTIN_DTOSTR
+    TEST_Result(Float, 2147483647L, "2.1474836e+09");
+    /* TEST_Result(Float, -2147483648, "-2.1474836e+09"); bug in GCC */
+    TEST_Result(Float, -2147483647L, "-2.1474836e+09");
+    TEST_Result(Float, 9223372036854775807LL, "9.223372e+18");
+    TEST_Result(Float, -9223372036854775807LL, "-9.223372e+18");
+#else
     TEST_Result(Float, 2147483647L, "2.14748e+09");
     /* TEST_Result(Float, -2147483648, "-2.14748e+09"); bug in GCC */
     TEST_Result(Float, -2147483647L, "-2.14748e+09");
     TEST_Result(Float, 9223372036854775807LL, "9.22337e+18");
     TEST_Result(Float, -9223372036854775807LL, "-9.22337e+18");
+#endif
 
     TEST_Result(Float, 1.256e-17, "1.256e-17");
     TEST_Result(Float, -1.256e-17, "-1.256e-17");
@@ -1384,18 +2257,130 @@ static void testResultArray(void) {
     TEST_Result(ArrayUInt64SWAPPED, uint64_arr, "#216" "\xFB\xFF\xFF\xFF" "\xFF\xFF\xFF\xFF" "76543210");
 
     float float_arr[] = {0.7549173, 3.0196693};
+#if USE_BUILTIN_DTOSTR
+    TEST_Result(ArrayFloatASCII, float_arr, "0.7549173,3.0196693");
+#else
     TEST_Result(ArrayFloatASCII, float_arr, "0.754917,3.01967");
+#endif
     TEST_Result(ArrayFloatNORMAL, float_arr, "#18" "?ABC" "@ABC");
     TEST_Result(ArrayFloatSWAPPED, float_arr, "#18" "CBA?" "CBA@");
 
     double double_arr[] = {76543217654321, 1234567891234567};
+#if USE_BUILTIN_DTOSTR
+    TEST_Result(ArrayDoubleASCII, double_arr, "76543217654321,1234567891234567");
+#else
     TEST_Result(ArrayDoubleASCII, double_arr, "76543217654321,1.23456789123457e+15");
+#endif
     TEST_Result(ArrayDoubleNORMAL, double_arr, "#216" "\x42\xd1\x67\x66\xd3\x16\x8c\x40" "\x43\x11\x8b\x54\xf2\x6e\xbc\x1c");
     TEST_Result(ArrayDoubleSWAPPED, double_arr, "#216" "\x40\x8c\x16\xd3\x66\x67\xd1\x42" "\x1c\xbc\x6e\xf2\x54\x8b\x11\x43");
 }
 
 #define _countof(a) (sizeof(a)/sizeof(*(a)))
 
+static void testResultArrayAuto(void) {
+#define TEST_FORMAT(data, output) {                             \
+    output_buffer_clear();                                      \
+    error_buffer_clear();                                       \
+    SCPI_Input(&scpi_context, data, strlen(data));              \
+    CU_ASSERT_STRING_EQUAL(output, output_buffer);              \
+}
+
+#define TEST_ResultAuto(func, array, scale, expected_result) {                  \
+    output_buffer_clear();                                                      \
+    scpi_context.output_count = 0;                                              \
+    size_t expected_len = sizeof(expected_result) - 1;                          \
+    size_t len = SCPI_ResultArrayAuto##func(&scpi_context, (array), sizeof(array)/sizeof(*array), (scale)); \
+    CU_ASSERT_EQUAL(len, expected_len);                                         \
+    CU_ASSERT_EQUAL(output_buffer_pos, expected_len);                           \
+    CU_ASSERT_EQUAL(memcmp(output_buffer, expected_result, expected_len), 0);   \
+}
+
+    double double_arr[] = {0.5, -1.25, 1e7};
+    double int16_arr[] = {0.5, -1.25, 100, -100, NAN};
+    float float_arr[] = {0.5f, -1.25f};
+    double long_arr[40];
+    size_t i;
+
+    TEST_FORMAT("FORM?\r\n", "ASC,0\r\n");
+    TEST_FORMAT("FORM:BORD?\r\n", "NORM\r\n");
+    TEST_ResultAuto(Double, double_arr, 1000, "0.5,-1.25,10000000");
+    TEST_ResultAuto(Float, float_arr, 1000, "0.5,-1.25");
+
+    TEST_FORMAT("FORM REAL,32;FORM?\r\n", "REAL,32\r\n");
+    TEST_ResultAuto(Double, double_arr, 1000, "#212" "\x3F\x00\x00\x00" "\xBF\xA0\x00\x00" "\x4B\x18\x96\x80");
+    TEST_FORMAT("FORM:BORD SWAP;BORD?\r\n", "SWAP\r\n");
+    TEST_ResultAuto(Double, double_arr, 1000, "#212" "\x00\x00\x00\x3F" "\x00\x00\xA0\xBF" "\x80\x96\x18\x4B");
+
+    TEST_FORMAT("FORM:DATA REAL;:FORM:BORD NORM;:FORM?\r\n", "REAL,64\r\n");
+    TEST_ResultAuto(Float, float_arr, 1000, "#216" "\x3F\xE0\x00\x00\x00\x00\x00\x00" "\xBF\xF4\x00\x00\x00\x00\x00\x00");
+
+    /* scaled, rounded and clamped, NaN is sent as 0 */
+    TEST_FORMAT("FORM INT;FORM?\r\n", "INT,16\r\n");
+    TEST_ResultAuto(Double, int16_arr, 1000, "#210" "\x01\xF4" "\xFB\x1E" "\x7F\xFF" "\x80\x00" "\x00\x00");
+    TEST_FORMAT("FORM INT,32;FORM:BORD SWAP\r\n", "");
+    TEST_ResultAuto(Double, double_arr, 1000, "#212" "\xF4\x01\x00\x00" "\x1E\xFB\xFF\xFF" "\xFF\xFF\xFF\x7F");
+
+    /* more items, than one conversion chunk */
+    TEST_FORMAT("FORM INT,16;FORM:BORD NORM\r\n", "");
+    for (i = 0; i < _countof(long_arr); i++) {
+        long_arr[i] = i + 0.25;
+    }
+    output_buffer_clear();
+    CU_ASSERT_EQUAL(SCPI_ResultArrayAutoDouble(&scpi_context, long_arr, _countof(long_arr), 256), 4 + 2 * _countof(long_arr));
+    CU_ASSERT_EQUAL(memcmp(output_buffer, "#280", 4), 0);
+    for (i = 0; i < _countof(long_arr); i++) {
+        CU_ASSERT_EQUAL((uint8_t) output_buffer[4 + 2 * i], i);
+        CU_ASSERT_EQUAL((uint8_t) output_buffer[5 + 2 * i], 64);
+    }
+
+    TEST_FORMAT("FORM INT,8\r\n", "");
+    CU_ASSERT_EQUAL(err_buffer[0], SCPI_ERROR_ILLEGAL_PARAMETER_VALUE);
+    TEST_FORMAT("FORM:BORD BIG\r\n", "");
+    CU_ASSERT_EQUAL(err_buffer[0], SCPI_ERROR_ILLEGAL_PARAMETER_VALUE);
+    TEST_FORMAT("FORM:DATA?;BORD?\r\n", "INT,16;NORM\r\n");
+
+    TEST_FORMAT("FORM:DATA REAL,32;BORD SWAP;*RST;FORM:DATA?;BORD?\r\n", "ASC,0;NORM\r\n");
+
+#if USE_PACKED_DATA_FORMAT
+    /* 500, -1250, 32767 as differences 500, -1750, 34017 */
+    TEST_FORMAT("FORM PACK,16;FORM?\r\n", "PACK,16\r\n");
+    TEST_ResultAuto(Double, double_arr, 1000, "#210" "Z\x01\x03" "\xE8\x07" "\xAB\x1B" "\xC2\x93\x04");
+
+    TEST_FORMAT("FORM PACK;FORM?\r\n", "PACK,32\r\n");
+    {
+        int32_t decoded[_countof(long_arr)];
+        size_t header_len;
+        size_t decoded_count;
+
+        for (i = 0; i < _countof(long_arr); i++) {
+            long_arr[i] = (i % 7) * 1000.0 - (i % 3) * 100000.0 - 1.5e6;
+        }
+        output_buffer_clear();
+        scpi_context.output_count = 0;
+        SCPI_ResultArrayAutoDouble(&scpi_context, long_arr, _countof(long_arr), 1000);
+        CU_ASSERT_EQUAL(output_buffer[0], '#');
+        header_len = 2 + output_buffer[1] - '0';
+        CU_ASSERT_EQUAL(SCPI_PackedDecode(output_buffer + header_len, output_buffer_pos - header_len, decoded, _countof(decoded), &decoded_count), TRUE);
+        CU_ASSERT_EQUAL(decoded_count, _countof(long_arr));
+        CU_ASSERT_EQUAL(decoded[0], -1500000000);
+        for (i = 0; i < _countof(long_arr); i++) {
+            int32_t expected = (long_arr[i] * 1000 < INT32_MIN) ? INT32_MIN : (int32_t) (long_arr[i] * 1000);
+            CU_ASSERT_EQUAL(decoded[i], expected);
+        }
+
+        /* output buffer too small, truncated and malformed payload */
+        CU_ASSERT_EQUAL(SCPI_PackedDecode(output_buffer + header_len, output_buffer_pos - header_len, decoded, 3, &decoded_count), FALSE);
+        CU_ASSERT_EQUAL(decoded_count, _countof(long_arr));
+        CU_ASSERT_EQUAL(SCPI_PackedDecode(output_buffer + header_len, output_buffer_pos - header_len - 1, decoded, _countof(decoded), &decoded_count), FALSE);
+        CU_ASSERT_EQUAL(SCPI_PackedDecode("X\x01\x00", 3, decoded, _countof(decoded), &decoded_count), FALSE);
+    }
+    TEST_FORMAT("*RST\r\n", "");
+#endif
+
+    output_buffer_clear();
+    error_buffer_clear();
+}
+
 #define TEST_ParamArrayDouble(T, func, data, mandatory, _expected_value, expected_result, expected_error_code) \
 {                                                                                       \
     T value[10];                                                                        \
@@ -1452,14 +2437,58 @@ static void testResultArray(void) {
     CU_ASSERT_EQUAL(errCode.error_code, expected_error_code);                           \
 }
 
+#define TEST_ParamArrayBinary(T, func, data, format, _expected_value, expected_result, expected_error_code) \
+{                                                                                       \
+    T value[10];                                                                        \
+    scpi_bool_t result;                                                                 \
+    scpi_error_t errCode;                                                               \
+    T expected_value[] = {NOPAREN _expected_value};                                     \
+    size_t o_count;                                                                     \
+    size_t i_count = _countof(expected_value);                                          \
+                                                                                        \
+    SCPI_CoreCls(&scpi_context);                                                        \
+    scpi_context.input_count = 0;                                                       \
+    scpi_context.param_list.lex_state.buffer = data;                                    \
+    scpi_context.param_list.lex_state.len = sizeof(data) - 1;                           \
+    scpi_context.param_list.lex_state.pos = scpi_context.param_list.lex_state.buffer;   \
+    result = func(&scpi_context, value, 10, &o_count, format, TRUE);                    \
+                                                                                        \
+    SCPI_ErrorPop(&scpi_context, &errCode);                                             \
+    CU_ASSERT_EQUAL(result, expected_result);                                           \
+    if (expected_result) {                                                              \
+        CU_ASSERT_EQUAL(i_count, o_count);                                              \
+        size_t i;                                                                       \
+        for(i = 0; i < o_count; i++) {                                                  \
+            CU_ASSERT_EQUAL(value[i], expected_value[i]);                               \
+        }                                                                               \
+    }                                                                                   \
+    CU_ASSERT_EQUAL(errCode.error_code, expected_error_code);                           \
+}
+
 static void testParamArray(void) {
     TEST_ParamArrayDouble(double, SCPI_ParamArrayDouble, "1, 2, 3", TRUE, (1, 2, 3), TRUE, SCPI_ERROR_NO_ERROR);
     TEST_ParamArrayDouble(double, SCPI_ParamArrayDouble, "", TRUE, (0), FALSE, SCPI_ERROR_MISSING_PARAMETER);
     TEST_ParamArrayDouble(double, SCPI_ParamArrayDouble, "1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11", TRUE, (1, 2, 3, 4, 5, 6, 7, 8, 9, 10), TRUE, SCPI_ERROR_NO_ERROR);
 
+#if USE_BUILTIN_STRTOD
+    TEST_ParamArrayDouble(double, SCPI_ParamArrayDouble, " 1.5e3 ,-.25,+7.,1 E -2\t, 3", TRUE, (1500, -0.25, 7, 0.01, 3), TRUE, SCPI_ERROR_NO_ERROR);
+#else
+    TEST_ParamArrayDouble(double, SCPI_ParamArrayDouble, " 1.5e3 ,-.25,+7.,1E-2\t, 3", TRUE, (1500, -0.25, 7, 0.01, 3), TRUE, SCPI_ERROR_NO_ERROR);
+#endif
+    TEST_ParamArrayDouble(double, SCPI_ParamArrayDouble, "1, 0x10", TRUE, (1), TRUE, SCPI_ERROR_SUFFIX_NOT_ALLOWED);
+    TEST_ParamArrayDouble(double, SCPI_ParamArrayDouble, "1, -inf", TRUE, (1), TRUE, SCPI_ERROR_INVALID_STRING_DATA);
+    TEST_ParamArrayDouble(double, SCPI_ParamArrayDouble, "1, #H10, #B11, 4", TRUE, (1, 16, 3, 4), TRUE, SCPI_ERROR_NO_ERROR);
+    TEST_ParamArrayDouble(double, SCPI_ParamArrayDouble, "1, 2 V, 3", TRUE, (1), TRUE, SCPI_ERROR_SUFFIX_NOT_ALLOWED);
+    TEST_ParamArrayDouble(double, SCPI_ParamArrayDouble, "1, 2, ABC, 4", TRUE, (1, 2), TRUE, SCPI_ERROR_DATA_TYPE_ERROR);
+    TEST_ParamArrayDouble(double, SCPI_ParamArrayDouble, "1, 2e", TRUE, (1), TRUE, SCPI_ERROR_SUFFIX_NOT_ALLOWED);
+    TEST_ParamArrayDouble(double, SCPI_ParamArrayDouble, "1,,3", TRUE, (1), TRUE, SCPI_ERROR_INVALID_STRING_DATA);
+    TEST_ParamArrayDouble(double, SCPI_ParamArrayDouble, "1 2", TRUE, (1), TRUE, SCPI_ERROR_INVALID_SEPARATOR);
+    TEST_ParamArrayDouble(double, SCPI_ParamArrayDouble, "ABC", TRUE, (0), FALSE, SCPI_ERROR_DATA_TYPE_ERROR);
+
     TEST_ParamArrayDouble(float, SCPI_ParamArrayFloat, "1, 2, 3", TRUE, (1, 2, 3), TRUE, SCPI_ERROR_NO_ERROR);
     TEST_ParamArrayDouble(float, SCPI_ParamArrayFloat, "", TRUE, (0), FALSE, SCPI_ERROR_MISSING_PARAMETER);
     TEST_ParamArrayDouble(float, SCPI_ParamArrayFloat, "1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11", TRUE, (1, 2, 3, 4, 5, 6, 7, 8, 9, 10), TRUE, SCPI_ERROR_NO_ERROR);
+    TEST_ParamArrayDouble(float, SCPI_ParamArrayFloat, "0.1, 1e-3, 2 V", TRUE, (0.1f, 1e-3f), TRUE, SCPI_ERROR_SUFFIX_NOT_ALLOWED);
 
     TEST_ParamArrayInt(int32_t, SCPI_ParamArrayInt32, "1, 2, 3", TRUE, (1, 2, 3), TRUE, SCPI_ERROR_NO_ERROR);
     TEST_ParamArrayInt(int32_t, SCPI_ParamArrayInt32, "", TRUE, (0), FALSE, SCPI_ERROR_MISSING_PARAMETER);
@@ -1476,6 +2505,28 @@ static void testParamArray(void) {
     TEST_ParamArrayInt(uint64_t, SCPI_ParamArrayUInt64, "1, 2, 3", TRUE, (1, 2, 3), TRUE, SCPI_ERROR_NO_ERROR);
     TEST_ParamArrayInt(uint64_t, SCPI_ParamArrayUInt64, "", TRUE, (0), FALSE, SCPI_ERROR_MISSING_PARAMETER);
     TEST_ParamArrayInt(uint64_t, SCPI_ParamArrayUInt64, "1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11", TRUE, (1, 2, 3, 4, 5, 6, 7, 8, 9, 10), TRUE, SCPI_ERROR_NO_ERROR);
+
+    TEST_ParamArrayInt(int8_t, SCPI_ParamArrayInt8, "1, -2, 127", TRUE, (1, -2, 127), TRUE, SCPI_ERROR_NO_ERROR);
+    TEST_ParamArrayInt(int8_t, SCPI_ParamArrayInt8, "1, 128", TRUE, (1), TRUE, SCPI_ERROR_DATA_OUT_OF_RANGE);
+    TEST_ParamArrayInt(uint8_t, SCPI_ParamArrayUInt8, "1, 2, 255", TRUE, (1, 2, 255), TRUE, SCPI_ERROR_NO_ERROR);
+    TEST_ParamArrayInt(uint8_t, SCPI_ParamArrayUInt8, "-1", TRUE, (0), FALSE, SCPI_ERROR_DATA_OUT_OF_RANGE);
+    TEST_ParamArrayInt(int16_t, SCPI_ParamArrayInt16, "1, -32768, 32767", TRUE, (1, -32768, 32767), TRUE, SCPI_ERROR_NO_ERROR);
+    TEST_ParamArrayInt(uint16_t, SCPI_ParamArrayUInt16, "1, 2, 65535", TRUE, (1, 2, 65535), TRUE, SCPI_ERROR_NO_ERROR);
+    TEST_ParamArrayInt(uint16_t, SCPI_ParamArrayUInt16, "65536", TRUE, (0), FALSE, SCPI_ERROR_DATA_OUT_OF_RANGE);
+
+    TEST_ParamArrayBinary(int8_t, SCPI_ParamArrayInt8, "#13\x01\xFE\x7F", SCPI_FORMAT_NORMAL, (1, -2, 127), TRUE, SCPI_ERROR_NO_ERROR);
+    TEST_ParamArrayBinary(uint8_t, SCPI_ParamArrayUInt8, "#13\x01\xFE\x7F", SCPI_FORMAT_SWAPPED, (1, 254, 127), TRUE, SCPI_ERROR_NO_ERROR);
+    TEST_ParamArrayBinary(int16_t, SCPI_ParamArrayInt16, "#14\x00\x01\xFF\xFE", SCPI_FORMAT_NORMAL, (1, -2), TRUE, SCPI_ERROR_NO_ERROR);
+    TEST_ParamArrayBinary(uint16_t, SCPI_ParamArrayUInt16, "#210\x01\x00\x02\x00\x03\x00\x04\x00\x05\xFF", SCPI_FORMAT_SWAPPED, (1, 2, 3, 4, 0xFF05), TRUE, SCPI_ERROR_NO_ERROR);
+    TEST_ParamArrayBinary(uint16_t, SCPI_ParamArrayUInt16, "#13\x01\x00\x02", SCPI_FORMAT_SWAPPED, (0), FALSE, SCPI_ERROR_INVALID_BLOCK_DATA);
+    TEST_ParamArrayBinary(int32_t, SCPI_ParamArrayInt32, "#212\x00\x00\x00\x01\xFF\xFF\xFF\xFE\x12\x34\x56\x78", SCPI_FORMAT_NORMAL, (1, -2, 0x12345678), TRUE, SCPI_ERROR_NO_ERROR);
+    TEST_ParamArrayBinary(uint32_t, SCPI_ParamArrayUInt32, "#212\x01\x00\x00\x00\xFE\xFF\xFF\xFF\x78\x56\x34\x12", SCPI_FORMAT_SWAPPED, (1, 0xFFFFFFFEu, 0x12345678), TRUE, SCPI_ERROR_NO_ERROR);
+    TEST_ParamArrayBinary(int64_t, SCPI_ParamArrayInt64, "#216\x00\x00\x00\x00\x00\x00\x00\x01\x01\x23\x45\x67\x89\xAB\xCD\xEF", SCPI_FORMAT_NORMAL, (1, 0x0123456789ABCDEFll), TRUE, SCPI_ERROR_NO_ERROR);
+    TEST_ParamArrayBinary(uint64_t, SCPI_ParamArrayUInt64, "#18\xEF\xCD\xAB\x89\x67\x45\x23\x01", SCPI_FORMAT_SWAPPED, (0x0123456789ABCDEFull), TRUE, SCPI_ERROR_NO_ERROR);
+    TEST_ParamArrayBinary(float, SCPI_ParamArrayFloat, "#18\x3F\x80\x00\x00\xC0\x20\x00\x00", SCPI_FORMAT_NORMAL, (1.0f, -2.5f), TRUE, SCPI_ERROR_NO_ERROR);
+    TEST_ParamArrayBinary(double, SCPI_ParamArrayDouble, "#216\x00\x00\x00\x00\x00\x00\xF0\x3F\x00\x00\x00\x00\x00\x00\x04\xC0", SCPI_FORMAT_SWAPPED, (1.0, -2.5), TRUE, SCPI_ERROR_NO_ERROR);
+    TEST_ParamArrayBinary(uint8_t, SCPI_ParamArrayUInt8, "#211\x01\x02\x03\x04\x05\x06\x07\x08\x09\x0A\x0B", SCPI_FORMAT_NORMAL, (0), FALSE, SCPI_ERROR_TOO_MUCH_DATA);
+    TEST_ParamArrayBinary(int32_t, SCPI_ParamArrayInt32, "1, 2", SCPI_FORMAT_NORMAL, (0), FALSE, SCPI_ERROR_DATA_TYPE_ERROR);
 }
 
 static void testNumberToStr(void) {
@@ -1514,6 +2565,37 @@ static void testNumberToStr(void) {
     TEST_SCPI_NumberToStr(FALSE, 10.5, SCPI_UNIT_VOLT, "10.5 V");
     TEST_SCPI_NumberToStr(TRUE, SCPI_NUM_DEF, SCPI_UNIT_NONE, "DEFault");
 
+#define TEST_SCPI_NumberToStrEng(_value, _unit, expected_result) do {\
+    scpi_number_t number;\
+    number.base = 10;\
+    number.special = FALSE;\
+    number.unit = (_unit);\
+    number.content.value = (_value);\
+    char buffer[100 + 1];\
+    size_t res_len;\
+    res_len = SCPI_NumberToStrEng(&scpi_context, scpi_special_numbers_def, &number, buffer, 100);\
+    CU_ASSERT_STRING_EQUAL(buffer, expected_result);\
+    CU_ASSERT_EQUAL(res_len, strlen(expected_result));\
+} while(0)
+
+    TEST_SCPI_NumberToStrEng(1.5e-3, SCPI_UNIT_VOLT, "1.5 MV");
+    TEST_SCPI_NumberToStrEng(-2.2e-6, SCPI_UNIT_AMPER, "-2.2 UA");
+    TEST_SCPI_NumberToStrEng(10.5, SCPI_UNIT_VOLT, "10.5 V");
+    TEST_SCPI_NumberToStrEng(0, SCPI_UNIT_VOLT, "0 V");
+    TEST_SCPI_NumberToStrEng(4.7e3, SCPI_UNIT_OHM, "4.7 KOHM");
+    TEST_SCPI_NumberToStrEng(10e6, SCPI_UNIT_OHM, "10 MOHM");
+    TEST_SCPI_NumberToStrEng(0.5, SCPI_UNIT_OHM, "0.5 OHM");
+    TEST_SCPI_NumberToStrEng(2.4e9, SCPI_UNIT_HERTZ, "2.4 GHZ");
+    TEST_SCPI_NumberToStrEng(3e6, SCPI_UNIT_VOLT, "3 MAV");
+#if USE_UNITS_TIME
+    TEST_SCPI_NumberToStrEng(25e-9, SCPI_UNIT_SECOND, "25 NS");
+#endif
+    TEST_SCPI_NumberToStrEng(5e-19, SCPI_UNIT_FARAD, "0.5 AF");
+#if USE_UNITS_TEMPERATURE
+    TEST_SCPI_NumberToStrEng(2.5e-3, SCPI_UNIT_CELSIUS, "0.0025 CEL");
+#endif
+    TEST_SCPI_NumberToStrEng(2.5e-3, SCPI_UNIT_NONE, "0.0025");
+
     TEST_SCPI_NumberToStr_limited(FALSE, 10.5, SCPI_UNIT_NONE, "10.5", 1);
     TEST_SCPI_NumberToStr_limited(FALSE, 10.5, SCPI_UNIT_VOLT, "10.5 V", 1);
     TEST_SCPI_NumberToStr_limited(TRUE, SCPI_NUM_DEF, SCPI_UNIT_NONE, "DEFault", 1);
@@ -1551,6 +2633,246 @@ static void testNumberToStr(void) {
     TEST_SCPI_NumberToStr_limited(TRUE, SCPI_NUM_DEF, SCPI_UNIT_NONE, "DEFault", 9);
 }
 
+#if USE_EVENT_LOG
+static void testEventLog(void) {
+    static scpi_event_record_t event_log[5];
+    scpi_event_record_t records[8];
+    scpi_error_t val;
+    uint32_t seq = 0;
+    int16_t i;
+
+    output_buffer_clear();
+    error_buffer_clear();
+    SCPI_EventLogInit(&scpi_context, event_log, 5);
+    CU_ASSERT_EQUAL(scpi_context.event_log.size, 4);
+    CU_ASSERT_EQUAL(SCPI_EventLogRead(&scpi_context, &seq, records, 8), 0);
+    CU_ASSERT_EQUAL(seq, 0);
+
+    event_timestamp = 100;
+    SCPI_Input(&scpi_context, "TEST:EVEN\r\n", 11);
+    CU_ASSERT_EQUAL(SCPI_EventLogRead(&scpi_context, &seq, records, 8), 1);
+    CU_ASSERT_EQUAL(seq, 1);
+    CU_ASSERT_EQUAL(records[0].sequence, 0);
+    CU_ASSERT_EQUAL(records[0].timestamp, 100);
+#if USE_COMMAND_TAGS
+    CU_ASSERT_EQUAL(records[0].tag, 42);
+#endif
+    CU_ASSERT_EQUAL(records[0].error_code, SCPI_ERROR_EXECUTION_ERROR);
+
+    /* only the newest records are kept */
+    for (i = 1; i <= 5; i++) {
+        event_timestamp = 100 + i;
+        SCPI_ErrorPush(&scpi_context, -i);
+    }
+    CU_ASSERT_EQUAL(SCPI_EventLogSequence(&scpi_context), 6);
+    CU_ASSERT_EQUAL(SCPI_EventLogRead(&scpi_context, &seq, records, 8), 4);
+    CU_ASSERT_EQUAL(seq, 6);
+    CU_ASSERT_EQUAL(records[0].sequence, 2);
+    CU_ASSERT_EQUAL(records[0].timestamp, 102);
+    CU_ASSERT_EQUAL(records[0].error_code, -2);
+    CU_ASSERT_EQUAL(records[3].sequence, 5);
+    CU_ASSERT_EQUAL(records[3].error_code, -5);
+
+    seq = 3;
+    CU_ASSERT_EQUAL(SCPI_EventLogRead(&scpi_context, &seq, records, 2), 2);
+    CU_ASSERT_EQUAL(seq, 5);
+    CU_ASSERT_EQUAL(records[1].error_code, -4);
+
+    SCPI_Input(&scpi_context, "SYST:ERR:LOG?\r\n", 15);
+    CU_ASSERT_EQUAL(output_buffer_pos, 4 + 4 * 14 + 2);
+    CU_ASSERT_EQUAL(memcmp(output_buffer, "#256", 4), 0);
+    CU_ASSERT_EQUAL(memcmp(output_buffer + 4, "\x00\x00\x00\x02\x00\x00\x00\x66", 8), 0);
+    CU_ASSERT_EQUAL(memcmp(output_buffer + 4 + 12, "\xFF\xFE", 2), 0);
+    CU_ASSERT_EQUAL(memcmp(output_buffer + 4 + 3 * 14, "\x00\x00\x00\x05", 4), 0);
+    CU_ASSERT_EQUAL(memcmp(output_buffer + 4 + 3 * 14 + 12, "\xFF\xFB\r\n", 4), 0);
+    output_buffer_clear();
+
+    /* error queue is not affected by the log */
+    SCPI_ErrorPop(&scpi_context, &val);
+    CU_ASSERT_EQUAL(val.error_code, SCPI_ERROR_EXECUTION_ERROR);
+    SCPI_ErrorPop(&scpi_context, &val);
+    CU_ASSERT_EQUAL(val.error_code, -1);
+    SCPI_ErrorPop(&scpi_context, &val);
+    CU_ASSERT_EQUAL(val.error_code, -2);
+    SCPI_ErrorPop(&scpi_context, &val);
+    CU_ASSERT_EQUAL(val.error_code, SCPI_ERROR_QUEUE_OVERFLOW);
+
+    SCPI_EventLogInit(&scpi_context, NULL, 0);
+    SCPI_ErrorPush(&scpi_context, -1);
+    CU_ASSERT_EQUAL(SCPI_EventLogSequence(&scpi_context), 0);
+    error_buffer_clear();
+}
+#endif /* USE_EVENT_LOG */
+
+#if USE_REGISTER_ATOMIC
+static void testRegisterAtomic(void) {
+    output_buffer_clear();
+    error_buffer_clear();
+    SCPI_CoreCls(&scpi_context);
+
+    SCPI_RegSet(&scpi_context, SCPI_REG_SRE, STB_ESR | STB_QES);
+    SCPI_RegSet(&scpi_context, SCPI_REG_QUESE, 0x0001);
+    srq_count = 0;
+
+    SCPI_RegSetBits(&scpi_context, SCPI_REG_ESR, ESR_CER);
+    CU_ASSERT_EQUAL(srq_count, 1);
+    CU_ASSERT_EQUAL(srq_val, STB_ESR | STB_SRQ);
+    CU_ASSERT_EQUAL(SCPI_RegGet(&scpi_context, SCPI_REG_STB), STB_ESR | STB_SRQ);
+
+    /* service request is already active */
+    SCPI_RegSetBits(&scpi_context, SCPI_REG_QUESC, 0x0001);
+    CU_ASSERT_EQUAL(srq_count, 1);
+    CU_ASSERT_EQUAL(SCPI_RegGet(&scpi_context, SCPI_REG_QUES), 0x0001);
+    CU_ASSERT_EQUAL(SCPI_RegGet(&scpi_context, SCPI_REG_STB), STB_ESR | STB_QES | STB_SRQ);
+
+    /* negative transition is not latched without filter */
+    SCPI_RegClearBits(&scpi_context, SCPI_REG_QUESC, 0x0001);
+    CU_ASSERT_EQUAL(SCPI_RegGet(&scpi_context, SCPI_REG_QUES), 0x0001);
+
+    SCPI_CoreEsrQ(&scpi_context);
+    CU_ASSERT_STRING_EQUAL(output_buffer, "32");
+    output_buffer_clear();
+    CU_ASSERT_EQUAL(SCPI_RegGet(&scpi_context, SCPI_REG_ESR), 0);
+    CU_ASSERT_EQUAL(SCPI_RegGet(&scpi_context, SCPI_REG_STB), STB_QES | STB_SRQ);
+
+    SCPI_RegSet(&scpi_context, SCPI_REG_QUES, 0);
+    CU_ASSERT_EQUAL(SCPI_RegGet(&scpi_context, SCPI_REG_STB), 0);
+
+    /* next rising edge */
+    SCPI_RegSetBits(&scpi_context, SCPI_REG_ESR, ESR_CER);
+    CU_ASSERT_EQUAL(srq_count, 2);
+
+    SCPI_RegSet(&scpi_context, SCPI_REG_SRE, 0);
+    CU_ASSERT_EQUAL(SCPI_RegGet(&scpi_context, SCPI_REG_STB), STB_ESR);
+    SCPI_RegSet(&scpi_context, SCPI_REG_QUESE, 0);
+    SCPI_CoreCls(&scpi_context);
+    error_buffer_clear();
+}
+#endif /* USE_REGISTER_ATOMIC */
+
+static void testRegUpdateBatch(void) {
+    const scpi_reg_update_t enable[] = {
+        {SCPI_REG_SRE, STB_OPS | STB_QES, 0xFFFF},
+        {SCPI_REG_OPERE, 0x0003, 0},
+        {SCPI_REG_QUESE, 0x0001, 0},
+    };
+    const scpi_reg_update_t measured[] = {
+        {SCPI_REG_OPERC, 0x0001, 0},
+        {SCPI_REG_OPERC, 0x0002, 0},
+        {SCPI_REG_QUESC, 0x0001, 0},
+        {SCPI_REG_NONE, 0xFFFF, 0},
+    };
+    const scpi_reg_update_t idle[] = {
+        {SCPI_REG_OPERC, 0, 0x0003},
+        {SCPI_REG_QUESC, 0x0004, 0x0005},
+    };
+
+    output_buffer_clear();
+    error_buffer_clear();
+    SCPI_CoreCls(&scpi_context);
+
+    SCPI_RegUpdateBatch(&scpi_context, enable, 3);
+    CU_ASSERT_EQUAL(SCPI_RegGet(&scpi_context, SCPI_REG_SRE), STB_OPS | STB_QES);
+    CU_ASSERT_EQUAL(SCPI_RegGet(&scpi_context, SCPI_REG_STB), 0);
+
+    srq_count = 0;
+    SCPI_RegUpdateBatch(&scpi_context, measured, 4);
+    CU_ASSERT_EQUAL(srq_count, 1);
+    CU_ASSERT_EQUAL(srq_val, STB_OPS | STB_QES | STB_SRQ);
+    CU_ASSERT_EQUAL(SCPI_RegGet(&scpi_context, SCPI_REG_OPERC), 0x0003);
+    CU_ASSERT_EQUAL(SCPI_RegGet(&scpi_context, SCPI_REG_OPER), 0x0003);
+    CU_ASSERT_EQUAL(SCPI_RegGet(&scpi_context, SCPI_REG_QUES), 0x0001);
+    CU_ASSERT_EQUAL(SCPI_RegGet(&scpi_context, SCPI_REG_STB), STB_OPS | STB_QES | STB_SRQ);
+
+    /* negative transitions are not latched, events stay */
+    SCPI_RegUpdateBatch(&scpi_context, idle, 2);
+    CU_ASSERT_EQUAL(srq_count, 1);
+    CU_ASSERT_EQUAL(SCPI_RegGet(&scpi_context, SCPI_REG_OPERC), 0);
+    CU_ASSERT_EQUAL(SCPI_RegGet(&scpi_context, SCPI_REG_QUESC), 0x0004);
+    CU_ASSERT_EQUAL(SCPI_RegGet(&scpi_context, SCPI_REG_QUES), 0x0005);
+    CU_ASSERT_EQUAL(SCPI_RegGet(&scpi_context, SCPI_REG_STB), STB_OPS | STB_QES | STB_SRQ);
+
+    SCPI_CoreCls(&scpi_context);
+    CU_ASSERT_EQUAL(SCPI_RegGet(&scpi_context, SCPI_REG_STB), 0);
+
+    SCPI_RegSet(&scpi_context, SCPI_REG_QUESC, 0);
+    SCPI_RegSet(&scpi_context, SCPI_REG_SRE, 0);
+    SCPI_RegSet(&scpi_context, SCPI_REG_OPERE, 0);
+    SCPI_RegSet(&scpi_context, SCPI_REG_QUESE, 0);
+    error_buffer_clear();
+}
+
+#if USE_REGISTER_SUBSCRIPTIONS
+static int reg_notify_count;
+static scpi_reg_name_t reg_notify_name;
+static scpi_reg_val_t reg_notify_bits;
+static scpi_reg_val_t reg_notify_val;
+
+static void reg_notify(scpi_t * context, scpi_reg_name_t name, scpi_reg_val_t bits, scpi_reg_val_t val, void * user) {
+    (void) context;
+
+    reg_notify_count++;
+    reg_notify_name = name;
+    reg_notify_bits = bits;
+    reg_notify_val = val;
+    (*(int *) user)++;
+}
+
+static void testRegSubscribe(void) {
+    int ques_calls = 0;
+    int srq_calls = 0;
+    int ques;
+    int srq;
+
+    output_buffer_clear();
+    error_buffer_clear();
+    SCPI_CoreCls(&scpi_context);
+    reg_notify_count = 0;
+
+    ques = SCPI_RegSubscribe(&scpi_context, SCPI_REG_QUESC, 0x0003, SCPI_REG_EDGE_RISING, reg_notify, &ques_calls);
+    srq = SCPI_RegSubscribe(&scpi_context, SCPI_REG_STB, STB_SRQ, SCPI_REG_EDGE_BOTH, reg_notify, &srq_calls);
+    CU_ASSERT(ques >= 0);
+    CU_ASSERT(srq >= 0);
+    CU_ASSERT_EQUAL(SCPI_RegSubscribe(&scpi_context, SCPI_REG_NONE, 1, SCPI_REG_EDGE_BOTH, reg_notify, NULL), -1);
+
+    SCPI_RegSetBits(&scpi_context, SCPI_REG_QUESC, 0x0005);
+    CU_ASSERT_EQUAL(reg_notify_count, 1);
+    CU_ASSERT_EQUAL(reg_notify_name, SCPI_REG_QUESC);
+    CU_ASSERT_EQUAL(reg_notify_bits, 0x0001);
+    CU_ASSERT_EQUAL(reg_notify_val, 0x0005);
+
+    /* falling edge is not watched */
+    SCPI_RegClearBits(&scpi_context, SCPI_REG_QUESC, 0x0001);
+    CU_ASSERT_EQUAL(reg_notify_count, 1);
+
+    /* service request from the cascade */
+    SCPI_RegSet(&scpi_context, SCPI_REG_SRE, STB_QES);
+    SCPI_RegSet(&scpi_context, SCPI_REG_QUESE, 0x0002);
+    SCPI_RegSetBits(&scpi_context, SCPI_REG_QUESC, 0x0002);
+    CU_ASSERT_EQUAL(ques_calls, 2);
+    CU_ASSERT_EQUAL(srq_calls, 1);
+    CU_ASSERT_EQUAL(reg_notify_name, SCPI_REG_STB);
+    CU_ASSERT_EQUAL(reg_notify_bits, STB_SRQ);
+    CU_ASSERT_EQUAL(reg_notify_val, STB_QES | STB_SRQ);
+
+    SCPI_CoreCls(&scpi_context);
+    CU_ASSERT_EQUAL(srq_calls, 2);
+    CU_ASSERT_EQUAL(reg_notify_val, 0);
+
+    SCPI_RegUnsubscribe(&scpi_context, ques);
+    SCPI_RegUnsubscribe(&scpi_context, srq);
+    SCPI_RegSet(&scpi_context, SCPI_REG_QUESC, 0);
+    SCPI_RegSetBits(&scpi_context, SCPI_REG_QUESC, 0x0003);
+    CU_ASSERT_EQUAL(reg_notify_count, 4);
+
+    SCPI_RegSet(&scpi_context, SCPI_REG_QUESC, 0);
+    SCPI_RegSet(&scpi_context, SCPI_REG_SRE, 0);
+    SCPI_RegSet(&scpi_context, SCPI_REG_QUESE, 0);
+    SCPI_CoreCls(&scpi_context);
+    error_buffer_clear();
+}
+#endif /* USE_REGISTER_SUBSCRIPTIONS */
+
 static void testErrorQueue(void) {
     scpi_error_t val;
     SCPI_ErrorClear(&scpi_context);
@@ -1587,6 +2909,47 @@ static void testErrorQueue(void) {
     SCPI_ErrorClear(&scpi_context);
 }
 
+static const char * errorText(scpi_t * context, int16_t error) {
+    (void) context;
+    return (error == SCPI_ERROR_EXECUTION_ERROR) ? "Ausfuehrungsfehler" : NULL;
+}
+
+static void testErrorTranslate(void) {
+#define X(def, val, str) CU_ASSERT_STRING_EQUAL(SCPI_ErrorTranslate(def), str);
+#if USE_FULL_ERROR_LIST
+#define XE X
+#else
+#define XE(def, val, str)
+#endif
+    LIST_OF_ERRORS
+#if USE_USER_ERROR_LIST
+    LIST_OF_USER_ERRORS
+#endif
+#undef X
+#undef XE
+
+    CU_ASSERT_STRING_EQUAL(SCPI_ErrorTranslate(-1), "Unknown error");
+    CU_ASSERT_STRING_EQUAL(SCPI_ErrorTranslate(1), "Unknown error");
+    CU_ASSERT_STRING_EQUAL(SCPI_ErrorTranslate(-32768), "Unknown error");
+    CU_ASSERT_STRING_EQUAL(SCPI_ErrorTranslate(32767), "Unknown error");
+
+    CU_ASSERT_STRING_EQUAL(SCPI_ErrorTranslateEx(&scpi_context, SCPI_ERROR_EXECUTION_ERROR), "Execution error");
+    scpi_interface.error_text = errorText;
+    CU_ASSERT_STRING_EQUAL(SCPI_ErrorTranslateEx(&scpi_context, SCPI_ERROR_EXECUTION_ERROR), "Ausfuehrungsfehler");
+    CU_ASSERT_STRING_EQUAL(SCPI_ErrorTranslateEx(&scpi_context, SCPI_ERROR_SYSTEM_ERROR), "System error");
+    scpi_interface.error_text = NULL;
+
+    /* unsorted error table would be reported by initialization */
+    {
+        scpi_t context;
+        scpi_error_t error_queue_data[4];
+
+        SCPI_Init(&context, scpi_commands, NULL, scpi_units_def, NULL, NULL, NULL, NULL,
+                NULL, 0, error_queue_data, 4);
+        CU_ASSERT_EQUAL(SCPI_ErrorCount(&context), 0);
+    }
+}
+
 #define TEST_INCOMPLETE_ARB(_val, _part_len) do {\
     double val = _val;\
     char command_text[] = "SAMple #18[DOUBLE]\r";\
@@ -1735,12 +3098,24 @@ int main() {
             || (NULL == CU_add_test(pSuite, "SCPI_ParamArbitraryBlock", testSCPI_ParamArbitraryBlock))
             || (NULL == CU_add_test(pSuite, "SCPI_ParamBool", testSCPI_ParamBool))
             || (NULL == CU_add_test(pSuite, "SCPI_ParamChoice", testSCPI_ParamChoice))
+            || (NULL == CU_add_test(pSuite, "Choice index", testChoiceIndex))
+            || (NULL == CU_add_test(pSuite, "Parameter view", testParamView))
+#if USE_NUMBER_EXACT
+            || (NULL == CU_add_test(pSuite, "Exact number", testNumberExact))
+#endif
             || (NULL == CU_add_test(pSuite, "Commands handling", testCommandsHandling))
+            || (NULL == CU_add_test(pSuite, "Parameter schema", testParameterSchema))
+            || (NULL == CU_add_test(pSuite, "Output queue", testOutputQueue))
             || (NULL == CU_add_test(pSuite, "Error handling", testErrorHandling))
             || (NULL == CU_add_test(pSuite, "Device dependent error handling", testErrorHandlingDeviceDependent))
             || (NULL == CU_add_test(pSuite, "IEEE 488.2 Mandatory commands", testIEEE4882))
             || (NULL == CU_add_test(pSuite, "Numeric list", testNumericList))
+            || (NULL == CU_add_test(pSuite, "Numeric list iterator", testNumericListIterator))
             || (NULL == CU_add_test(pSuite, "Channel list", testChannelList))
+            || (NULL == CU_add_test(pSuite, "Channel list compile", testChannelListCompile))
+#if USE_EXPRESSION_EVAL
+            || (NULL == CU_add_test(pSuite, "Expression evaluation", testExpressionEval))
+#endif
             || (NULL == CU_add_test(pSuite, "SCPI_ParamNumber", testParamNumber))
             || (NULL == CU_add_test(pSuite, "SCPI_ResultInt8", testResultInt8))
             || (NULL == CU_add_test(pSuite, "SCPI_ResultUInt8", testResultUInt8))
@@ -1757,9 +3132,21 @@ int main() {
             || (NULL == CU_add_test(pSuite, "SCPI_ResultText", testResultText))
             || (NULL == CU_add_test(pSuite, "SCPI_ResultArbitraryBlock", testResultArbitraryBlock))
             || (NULL == CU_add_test(pSuite, "SCPI_ResultArray", testResultArray))
+            || (NULL == CU_add_test(pSuite, "SCPI_ResultArrayAuto", testResultArrayAuto))
             || (NULL == CU_add_test(pSuite, "SCPI_ParamArray", testParamArray))
             || (NULL == CU_add_test(pSuite, "SCPI_NumberToStr", testNumberToStr))
             || (NULL == CU_add_test(pSuite, "SCPI_ErrorQueue", testErrorQueue))
+            || (NULL == CU_add_test(pSuite, "SCPI_ErrorTranslate", testErrorTranslate))
+            || (NULL == CU_add_test(pSuite, "SCPI_RegUpdateBatch", testRegUpdateBatch))
+#if USE_REGISTER_SUBSCRIPTIONS
+            || (NULL == CU_add_test(pSuite, "SCPI_RegSubscribe", testRegSubscribe))
+#endif
+#if USE_REGISTER_ATOMIC
+            || (NULL == CU_add_test(pSuite, "Atomic registers", testRegisterAtomic))
+#endif
+#if USE_EVENT_LOG
+            || (NULL == CU_add_test(pSuite, "Event log", testEventLog))
+#endif
             || (NULL == CU_add_test(pSuite, "Incomplete arbitrary parameter", testIncompleteArbitraryParameter))
             || (NULL == CU_add_test(pSuite, "Incomplete text parameter", testIncompleteTextParameter))
             ) {
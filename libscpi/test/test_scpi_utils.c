@@ -218,6 +218,87 @@ static void test_UInt64ToStrBase() {
     CU_ASSERT_STRING_EQUAL(str, "1111111011011100101110101001100001110110010101000011001000010000");
 }
 
+static void test_UIntToStrBaseDigits() {
+    char str[65 + 1];
+    char ref[65 + 1];
+    uint64_t x = 88172645463325252ull;
+    uint64_t val;
+    size_t len;
+    int i;
+    int fails = 0;
+
+    for (i = 0; i < 20000; i++) {
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+        /* cover all digit counts */
+        val = x >> (i % 64);
+
+        len = SCPI_UInt64ToStrBase(val, str, sizeof (str), 10);
+        sprintf(ref, "%"PRIu64, val);
+        fails += (len != strlen(ref)) || strcmp(str, ref);
+
+        len = SCPI_Int64ToStr((int64_t) val, str, sizeof (str));
+        sprintf(ref, "%"PRId64, (int64_t) val);
+        fails += (len != strlen(ref)) || strcmp(str, ref);
+
+        len = SCPI_UInt64ToStrBase(val, str, sizeof (str), 8);
+        sprintf(ref, "%"PRIo64, val);
+        fails += (len != strlen(ref)) || strcmp(str, ref);
+
+        len = SCPI_UInt64ToStrBase(val, str, sizeof (str), 16);
+        sprintf(ref, "%"PRIX64, val);
+        fails += (len != strlen(ref)) || strcmp(str, ref);
+
+        len = SCPI_UInt32ToStrBase((uint32_t) val, str, sizeof (str), 10);
+        sprintf(ref, "%"PRIu32, (uint32_t) val);
+        fails += (len != strlen(ref)) || strcmp(str, ref);
+
+        len = SCPI_Int32ToStr((int32_t) val, str, sizeof (str));
+        sprintf(ref, "%"PRId32, (int32_t) val);
+        fails += (len != strlen(ref)) || strcmp(str, ref);
+
+        len = SCPI_UInt32ToStrBase((uint32_t) val, str, sizeof (str), 8);
+        sprintf(ref, "%"PRIo32, (uint32_t) val);
+        fails += (len != strlen(ref)) || strcmp(str, ref);
+
+        len = SCPI_UInt32ToStrBase((uint32_t) val, str, sizeof (str), 16);
+        sprintf(ref, "%"PRIX32, (uint32_t) val);
+        fails += (len != strlen(ref)) || strcmp(str, ref);
+    }
+    CU_ASSERT_EQUAL(fails, 0);
+
+    /* powers of ten and their neighbours */
+    for (val = 1, i = 0; i < 20; i++, val *= 10) {
+        len = SCPI_UInt64ToStrBase(val, str, sizeof (str), 10);
+        sprintf(ref, "%"PRIu64, val);
+        CU_ASSERT_EQUAL(len, strlen(ref));
+        CU_ASSERT_STRING_EQUAL(str, ref);
+        len = SCPI_UInt64ToStrBase(val - 1, str, sizeof (str), 10);
+        sprintf(ref, "%"PRIu64, val - 1);
+        CU_ASSERT_EQUAL(len, strlen(ref));
+        CU_ASSERT_STRING_EQUAL(str, ref);
+    }
+
+    /* truncated output keeps leading digits */
+    memset(str, 'x', sizeof (str));
+    len = SCPI_Int32ToStr(-123456, str, 4);
+    CU_ASSERT_EQUAL(len, 4);
+    CU_ASSERT_NSTRING_EQUAL(str, "-123x", 5);
+
+    memset(str, 'x', sizeof (str));
+    len = SCPI_UInt64ToStrBase(0xFEDCBA9876543210ULL, str, 5, 16);
+    CU_ASSERT_EQUAL(len, 5);
+    CU_ASSERT_NSTRING_EQUAL(str, "FEDCBx", 6);
+
+    len = SCPI_UInt32ToStrBase(1234, str, 5, 10);
+    CU_ASSERT_EQUAL(len, 4);
+    CU_ASSERT_STRING_EQUAL(str, "1234");
+
+    len = SCPI_UInt32ToStrBase(1234, str, 0, 10);
+    CU_ASSERT_EQUAL(len, 0);
+}
+
 static void test_scpi_dtostre() {
     const size_t strsize = 49 + 1;
     double val[] = {
@@ -325,13 +406,173 @@ static void test_doubleToStr() {
     }
 }
 
+#ifndef FLOAT_ROUNDTRIP_STEP
+/* use 1 to check all 2^32 values */
+#define FLOAT_ROUNDTRIP_STEP 4099
+#endif
+
+static void test_floatToStrRoundTrip() {
+    char str[50];
+    uint64_t i;
+    uint32_t bits;
+    float val;
+    float ref;
+    size_t len;
+    unsigned int fails = 0;
+
+    for (i = 0; i <= 0xFFFFFFFFull; i += FLOAT_ROUNDTRIP_STEP) {
+        bits = (uint32_t) i;
+        memcpy(&val, &bits, sizeof (val));
+        if (isnan(val)) {
+            continue;
+        }
+        len = SCPI_FloatToStrPrecision(val, str, sizeof (str), 0);
+        ref = strtof(str, NULL);
+        if ((len != strlen(str)) || (memcmp(&val, &ref, sizeof (val)) != 0)) {
+            fails++;
+        }
+    }
+    CU_ASSERT_EQUAL(fails, 0);
+}
+
+static int significantDigits(const char * str) {
+    int digits = 0;
+    int zeros = 0;
+
+    for (; *str && *str != 'e'; str++) {
+        if (*str == '0') {
+            zeros += digits ? 1 : 0;
+        } else if (*str >= '1' && *str <= '9') {
+            digits += zeros + 1;
+            zeros = 0;
+        }
+    }
+    return digits;
+}
+
+static void test_doubleToStrRoundTrip() {
+    char str[50];
+    char ref[50];
+    uint64_t bits = 88172645463325252ull;
+    double val;
+    double back;
+    int i;
+    int precision;
+    unsigned int fails = 0;
+    unsigned int longer = 0;
+
+    for (i = 0; i < 100000; i++) {
+        bits ^= bits << 13;
+        bits ^= bits >> 7;
+        bits ^= bits << 17;
+        memcpy(&val, &bits, sizeof (val));
+        if (isnan(val)) {
+            continue;
+        }
+        SCPI_DoubleToStrPrecision(val, str, sizeof (str), 0);
+        back = strtod(str, NULL);
+        if (memcmp(&val, &back, sizeof (val)) != 0) {
+            fails++;
+        }
+
+        /* no shorter representation reads back to the same value */
+        for (precision = 1; precision <= 17; precision++) {
+            sprintf(ref, "%.*e", precision - 1, val);
+            if (strtod(ref, NULL) == val) {
+                break;
+            }
+        }
+        if (significantDigits(str) > significantDigits(ref)) {
+            longer++;
+        }
+    }
+    CU_ASSERT_EQUAL(fails, 0);
+    CU_ASSERT_EQUAL(longer, 0);
+}
+
+#define TEST_DOUBLE_TO_STR(v, p, r)                                             \
+    do {                                                                        \
+        char str[50];                                                           \
+        size_t len = SCPI_DoubleToStrPrecision((v), str, sizeof (str), (p));    \
+        CU_ASSERT_EQUAL(len, strlen(r));                                        \
+        CU_ASSERT_STRING_EQUAL(str, (r));                                       \
+    } while(0)
+
+#define TEST_FLOAT_TO_STR(v, p, r)                                              \
+    do {                                                                        \
+        char str[50];                                                           \
+        size_t len = SCPI_FloatToStrPrecision((v), str, sizeof (str), (p));     \
+        CU_ASSERT_EQUAL(len, strlen(r));                                        \
+        CU_ASSERT_STRING_EQUAL(str, (r));                                       \
+    } while(0)
+
+static void test_doubleToStrPrecision() {
+    double val[] = {
+        0.1, 0.5, 0.125, 0.3, 2.5, 1e-5, 1.5e-5, 123456.789, 1e15, 1e16, 1e21,
+        9.5, 99.5, 999999.5, 0.1 + 0.2, 1.0 / 3.0, 2.0 / 3.0, 6.02214076e23,
+        1.7976931348623157e308, 2.2250738585072014e-308, 4.9406564584124654e-324,
+        5e-310, 9007199254740993.0, 1125899906842624.0
+    };
+    int N = sizeof (val) / sizeof (*val);
+    int i;
+    int precision;
+    char str[50];
+    char ref[50];
+
+    for (i = 0; i < N; i++) {
+        for (precision = 1; precision <= 20; precision++) {
+            SCPI_DoubleToStrPrecision(val[i], str, sizeof (str), precision);
+            sprintf(ref, "%.*g", precision, val[i]);
+            CU_ASSERT_STRING_EQUAL(str, ref);
+            SCPI_DoubleToStrPrecision(-val[i], str, sizeof (str), precision);
+            sprintf(ref, "%.*g", precision, -val[i]);
+            CU_ASSERT_STRING_EQUAL(str, ref);
+            SCPI_FloatToStrPrecision((float) val[i], str, sizeof (str), precision);
+            sprintf(ref, "%.*g", precision, (float) val[i]);
+            CU_ASSERT_STRING_EQUAL(str, ref);
+        }
+    }
+
+    TEST_DOUBLE_TO_STR(0.0, 0, "0");
+    TEST_DOUBLE_TO_STR(-0.0, 0, "-0");
+    TEST_DOUBLE_TO_STR(0.1 + 0.2, 0, "0.30000000000000004");
+    TEST_DOUBLE_TO_STR(1e23, 0, "1e+23");
+    TEST_DOUBLE_TO_STR(123456789012345680.0, 0, "1.2345678901234568e+17");
+    TEST_DOUBLE_TO_STR(12345678901234567.0, 0, "12345678901234568");
+    TEST_DOUBLE_TO_STR(0.0001, 0, "0.0001");
+    TEST_DOUBLE_TO_STR(0.00001, 0, "1e-05");
+    TEST_DOUBLE_TO_STR(1.7976931348623157e308, 0, "1.7976931348623157e+308");
+    TEST_DOUBLE_TO_STR(4.9406564584124654e-324, 0, "5e-324");
+    TEST_DOUBLE_TO_STR(INFINITY, 0, "inf");
+    TEST_DOUBLE_TO_STR(-INFINITY, 0, "-inf");
+    TEST_DOUBLE_TO_STR(NAN, 0, "nan");
+    TEST_DOUBLE_TO_STR(1.0 / 3.0, 3, "0.333");
+    TEST_DOUBLE_TO_STR(2.5, 1, "2");
+    TEST_DOUBLE_TO_STR(9.99, 2, "10");
+    TEST_DOUBLE_TO_STR(123456.0, 3, "1.23e+05");
+    TEST_DOUBLE_TO_STR(-1.5, 0, "-1.5");
+    TEST_DOUBLE_TO_STR(12345.678, 0, "12345.678");
+
+    TEST_FLOAT_TO_STR(0.1f, 0, "0.1");
+    TEST_FLOAT_TO_STR(3.14159265f, 0, "3.1415927");
+    TEST_FLOAT_TO_STR(16777216.0f, 0, "16777216");
+    TEST_FLOAT_TO_STR(3.4028235e38f, 0, "3.4028235e+38");
+    TEST_FLOAT_TO_STR(1.4e-45f, 0, "1e-45");
+    TEST_FLOAT_TO_STR(1.1754944e-38f, 0, "1.1754944e-38");
+
+    /* truncated output */
+    SCPI_DoubleToStrPrecision(1.25, str, 3, 0);
+    CU_ASSERT_STRING_EQUAL(str, "1.");
+    CU_ASSERT_EQUAL(SCPI_DoubleToStrPrecision(1.25, str, 0, 0), 0);
+}
+
 static void test_strBaseToInt32() {
     size_t result;
     int32_t val;
 
 #define TEST_STR_TO_INT32(s, r, v, b)                   \
     do {                                                \
-        result = strBaseToInt32(s, &val, b);            \
+        result = strBaseToInt32(s, strlen(s), &val, b, NULL);            \
         CU_ASSERT_EQUAL(val, v);                        \
         CU_ASSERT_EQUAL(result, r);                     \
     } while(0)                                          \
@@ -357,7 +598,7 @@ static void test_strBaseToUInt32() {
 
 #define TEST_STR_TO_UINT32(s, r, v, b)                  \
     do {                                                \
-        result = strBaseToUInt32(s, &val, b);           \
+        result = strBaseToUInt32(s, strlen(s), &val, b, NULL);           \
         CU_ASSERT_EQUAL(val, v);                        \
         CU_ASSERT_EQUAL(result, r);                     \
     } while(0)                                          \
@@ -383,7 +624,7 @@ static void test_strBaseToInt64() {
 
 #define TEST_STR_TO_INT64(s, r, v, b)                   \
     do {                                                \
-        result = strBaseToInt64(s, &val, b);            \
+        result = strBaseToInt64(s, strlen(s), &val, b, NULL);            \
         CU_ASSERT_EQUAL(val, v);                        \
         CU_ASSERT_EQUAL(result, r);                     \
     } while(0)                                          \
@@ -409,7 +650,7 @@ static void test_strBaseToUInt64() {
 
 #define TEST_STR_TO_UINT64(s, r, v, b)                  \
     do {                                                \
-        result = strBaseToUInt64(s, &val, b);           \
+        result = strBaseToUInt64(s, strlen(s), &val, b, NULL);           \
         CU_ASSERT_EQUAL(val, v);                        \
         CU_ASSERT_EQUAL(result, r);                     \
     } while(0)                                          \
@@ -429,13 +670,71 @@ static void test_strBaseToUInt64() {
     TEST_STR_TO_UINT64("FFFFFFFF", 8, 0xffffffffu, 16); /* octal 1, 8 is ignored */
 }
 
+static void test_strBaseToIntOverflow() {
+    size_t result;
+    scpi_bool_t overflow;
+    int32_t val32;
+    uint32_t uval32;
+    int64_t val64;
+    uint64_t uval64;
+
+#define TEST_STR_TO_OVERFLOW(func, s, val, r, v, b, o)          \
+    do {                                                        \
+        result = func(s, strlen(s), &val, b, &overflow);        \
+        CU_ASSERT_EQUAL(result, r);                             \
+        CU_ASSERT_EQUAL(val, v);                                \
+        CU_ASSERT_EQUAL(overflow, o);                           \
+    } while(0)
+
+    TEST_STR_TO_OVERFLOW(strBaseToInt32, "2147483647", val32, 10, INT32_MAX, 10, FALSE);
+    TEST_STR_TO_OVERFLOW(strBaseToInt32, "2147483648", val32, 10, INT32_MAX, 10, TRUE);
+    TEST_STR_TO_OVERFLOW(strBaseToInt32, "-2147483648", val32, 11, INT32_MIN, 10, FALSE);
+    TEST_STR_TO_OVERFLOW(strBaseToInt32, "-2147483649", val32, 11, INT32_MIN, 10, TRUE);
+    TEST_STR_TO_OVERFLOW(strBaseToUInt32, "4294967295", uval32, 10, UINT32_MAX, 10, FALSE);
+    TEST_STR_TO_OVERFLOW(strBaseToUInt32, "4294967296", uval32, 10, UINT32_MAX, 10, TRUE);
+    TEST_STR_TO_OVERFLOW(strBaseToUInt32, "-1", uval32, 2, 0, 10, TRUE);
+    TEST_STR_TO_OVERFLOW(strBaseToUInt32, "-0", uval32, 2, 0, 10, FALSE);
+    TEST_STR_TO_OVERFLOW(strBaseToUInt32, "FFFFFFFF", uval32, 8, 0xFFFFFFFFu, 16, FALSE);
+    TEST_STR_TO_OVERFLOW(strBaseToUInt32, "100000000", uval32, 9, UINT32_MAX, 16, TRUE);
+    TEST_STR_TO_OVERFLOW(strBaseToUInt32, "000000000000000000000001", uval32, 24, 1, 2, FALSE);
+
+    TEST_STR_TO_OVERFLOW(strBaseToInt64, "9223372036854775807", val64, 19, INT64_MAX, 10, FALSE);
+    TEST_STR_TO_OVERFLOW(strBaseToInt64, "9223372036854775808", val64, 19, INT64_MAX, 10, TRUE);
+    TEST_STR_TO_OVERFLOW(strBaseToInt64, "-9223372036854775808", val64, 20, INT64_MIN, 10, FALSE);
+    TEST_STR_TO_OVERFLOW(strBaseToInt64, "-9223372036854775809", val64, 20, INT64_MIN, 10, TRUE);
+    TEST_STR_TO_OVERFLOW(strBaseToUInt64, "18446744073709551615", uval64, 20, UINT64_MAX, 10, FALSE);
+    TEST_STR_TO_OVERFLOW(strBaseToUInt64, "18446744073709551616", uval64, 20, UINT64_MAX, 10, TRUE);
+    TEST_STR_TO_OVERFLOW(strBaseToUInt64, "99999999999999999999999999", uval64, 26, UINT64_MAX, 10, TRUE);
+    TEST_STR_TO_OVERFLOW(strBaseToUInt64, "00000000000000000000000000012345678", uval64, 35, 12345678, 10, FALSE);
+    TEST_STR_TO_OVERFLOW(strBaseToUInt64, "fEdCbA9876543210", uval64, 16, 0xFEDCBA9876543210ull, 16, FALSE);
+    TEST_STR_TO_OVERFLOW(strBaseToUInt64, "1fEdCbA9876543210", uval64, 17, UINT64_MAX, 16, TRUE);
+    TEST_STR_TO_OVERFLOW(strBaseToUInt64, "1777777777777777777777", uval64, 22, UINT64_MAX, 8, FALSE);
+    TEST_STR_TO_OVERFLOW(strBaseToUInt64, "2000000000000000000000", uval64, 22, UINT64_MAX, 8, TRUE);
+    TEST_STR_TO_OVERFLOW(strBaseToUInt64, "1234567012345670", uval64, 16, 01234567012345670ull, 8, FALSE);
+    TEST_STR_TO_OVERFLOW(strBaseToUInt64, "1111111111111111111111111111111111111111111111111111111111111111", uval64, 64, UINT64_MAX, 2, FALSE);
+    TEST_STR_TO_OVERFLOW(strBaseToUInt64, "10000000000000000000000000000000000000000000000000000000000000000", uval64, 65, UINT64_MAX, 2, TRUE);
+    TEST_STR_TO_OVERFLOW(strBaseToUInt64, "1011001110001111", uval64, 16, 0xB38F, 2, FALSE);
+
+    /* chunk of eight characters ends by invalid digit */
+    TEST_STR_TO_OVERFLOW(strBaseToUInt64, "1234567x9", uval64, 7, 1234567, 10, FALSE);
+    TEST_STR_TO_OVERFLOW(strBaseToUInt64, "123456789abcdefg", uval64, 15, 0x123456789abcdefull, 16, FALSE);
+    TEST_STR_TO_OVERFLOW(strBaseToUInt64, "1234567:", uval64, 7, 0x1234567, 16, FALSE);
+    TEST_STR_TO_OVERFLOW(strBaseToUInt64, "12345678", uval64, 7, 01234567, 8, FALSE);
+    TEST_STR_TO_OVERFLOW(strBaseToUInt64, "10101012", uval64, 7, 0x55, 2, FALSE);
+
+    /* length limits the number */
+    result = strBaseToUInt64("123456789", 5, &uval64, 10, &overflow);
+    CU_ASSERT_EQUAL(result, 5);
+    CU_ASSERT_EQUAL(uval64, 12345);
+}
+
 static void test_strToDouble() {
     double val;
     size_t result;
 
 #define TEST_STR_TO_DOUBLE(s, r, v)                     \
     do {                                                \
-        result = strToDouble(s, &val);                  \
+        result = strToDouble(s, strlen(s), &val);       \
         CU_ASSERT_EQUAL(result, r);                     \
         CU_ASSERT_DOUBLE_EQUAL(v, val, 0.000001);       \
     } while(0);                                         \
@@ -460,6 +759,135 @@ static void test_strToDouble() {
 
     TEST_STR_TO_DOUBLE("-1.2", 4, -1.2);
 
+    TEST_STR_TO_DOUBLE("1.5 E", 3, 1.5);
+    TEST_STR_TO_DOUBLE("1.5 V", 3, 1.5);
+    TEST_STR_TO_DOUBLE(".5", 2, 0.5);
+    TEST_STR_TO_DOUBLE("5.", 2, 5.0);
+    TEST_STR_TO_DOUBLE(".", 0, 0.0);
+    TEST_STR_TO_DOUBLE("-.E3", 0, 0.0);
+
+#if USE_BUILTIN_STRTOD
+    /* IEEE 488.2 allows white space around exponent mark */
+    TEST_STR_TO_DOUBLE("1.5 E 3", 7, 1500.0);
+    TEST_STR_TO_DOUBLE("INF", 0, 0.0);
+    TEST_STR_TO_DOUBLE("0x10", 1, 0.0);
+
+    /* string does not need to be terminated */
+    result = strToDouble("12345", 3, &val);
+    CU_ASSERT_EQUAL(result, 3);
+    CU_ASSERT_EQUAL(val, 123.0);
+    result = strToDouble("1.5e3", 4, &val);
+    CU_ASSERT_EQUAL(result, 3);
+    CU_ASSERT_EQUAL(val, 1.5);
+#endif
+}
+
+/* compare conversion bit by bit with strtod and strtof */
+static unsigned int checkStrToDouble(const char * str) {
+    double val;
+    double ref = strtod(str, NULL);
+    float fval;
+    float fref = strtof(str, NULL);
+    unsigned int fails = 0;
+
+    if (strToDouble(str, strlen(str), &val) != strlen(str) || memcmp(&val, &ref, sizeof (val)) != 0) {
+        printf("\nstrToDouble(\"%s\") = %.17g, expected %.17g", str, val, ref);
+        fails++;
+    }
+    if (strToFloat(str, strlen(str), &fval) != strlen(str) || memcmp(&fval, &fref, sizeof (fval)) != 0) {
+        printf("\nstrToFloat(\"%s\") = %.9g, expected %.9g", str, fval, fref);
+        fails++;
+    }
+    return fails;
+}
+
+static void test_strToDoubleDifferential() {
+    static const char * boundary[] = {
+        "0", "-0", "0.0e-400", "1e400", "-1e400", "1e-400",
+        "2.2250738585072011e-308", "2.2250738585072014e-308",
+        "2.2250738585072012e-308", "4.9406564584124654e-324",
+        "2.4703282292062327e-324", "2.4703282292062328e-324",
+        "1.7976931348623157e308", "1.7976931348623158e308",
+        "1.7976931348623159e308", "9007199254740993",
+        "9007199254740992.5", "9007199254740993.0000000000000000000000000001",
+        "9007199254740993.00000000000000000000000000000000000000000000000000",
+        "1.00000005960464477539062500000000000000000001",
+        "1.000000059604644775390625", "1.00000005960464477539062499999",
+        "1.17549435e-38", "1.1754942e-38", "1.4e-45", "7.0e-46", "7.00649232162408535461864791644958065640130970938257885878534141944895541342930300743319094181060791015625e-46",
+        "3.4028235e38", "3.40282357e38", "3.4028236e38", "16777217", "33554435",
+        "0.1", "0.2", "0.3", "123456789012345678901234567890",
+        "1e23", "8.589973e9", "7.038531e-26", "4.35679e-10", "2.10064e7",
+        "1448997445238699", "1e-22", "1e22", "1e-23", "4.9e-324", "5e-324",
+        "2.2250738585072011360574097967091319759348195463516456480234261098"
+        "88138248165093849453131839271003052862587924498917428553497513209",
+        "0.000000000000000000000000000000000000000000000000000000000000000"
+        "00000000000000000000000000000000000000000000000000000000000000000",
+    };
+    char str[1000];
+    uint64_t bits = 88172645463325252ull;
+    unsigned int fails = 0;
+    size_t i;
+    int j;
+
+    for (i = 0; i < sizeof (boundary) / sizeof (*boundary); i++) {
+        fails += checkStrToDouble(boundary[i]);
+    }
+
+    /* long halfway values: 2^-1074 * (2k+1) / 2 and (2^53 + 1) * 2^e */
+    snprintf(str, sizeof (str), "%.800e", ldexp(1.0, -1075) * 3);
+    fails += checkStrToDouble(str);
+    for (j = -1074; j < 1024; j += 37) {
+        snprintf(str, sizeof (str), "%.780e", ldexp(9007199254740993.0 / 2, j - 52));
+        fails += checkStrToDouble(str);
+    }
+
+    for (i = 0; i < 100000; i++) {
+        double val;
+        int digits;
+        int pos;
+
+        bits ^= bits << 13;
+        bits ^= bits >> 7;
+        bits ^= bits << 17;
+
+        switch (bits % 3) {
+            case 0:
+                /* random double printed with random precision */
+                memcpy(&val, &bits, sizeof (val));
+                if (isnan(val) || isinf(val)) {
+                    continue;
+                }
+                snprintf(str, sizeof (str), "%.*e", (int) (bits >> 58) % 25, val);
+                break;
+            case 1:
+                /* random digits and exponent, sometimes with decimal point */
+                digits = 1 + (int) ((bits >> 8) % 30);
+                pos = 0;
+                for (j = 0; j < digits; j++) {
+                    str[pos++] = (char) ('0' + (bits >> (j * 2)) % 10);
+                    if ((int) ((bits >> 40) % 32) == j) {
+                        str[pos++] = '.';
+                    }
+                }
+                snprintf(str + pos, sizeof (str) - pos, "e%d", (int) ((bits >> 45) % 700) - 360);
+                break;
+            default:
+                /* random float printed with random precision */
+                {
+                    float fval;
+                    uint32_t fbits = (uint32_t) bits;
+                    memcpy(&fval, &fbits, sizeof (fval));
+                    if (isnan(fval) || isinf(fval)) {
+                        continue;
+                    }
+                    snprintf(str, sizeof (str), "%.*g", (int) (bits >> 58) % 12, fval);
+                }
+                break;
+        }
+        fails += checkStrToDouble(str);
+    }
+
+    CU_ASSERT_EQUAL(fails, 0);
 }
 
 static void test_compareStr() {
@@ -820,7 +1248,55 @@ static void test_heap(void) {
     scpiheap_free(&heap, ptr4, false);
     scpiheap_free(&heap, ptr8, false);
     CU_ASSERT_EQUAL(heap.count, heap.size);
+    CU_ASSERT_EQUAL(heap.peak, ERROR_INFO_HEAP_LENGTH);
+
+}
+
+static void test_slab(void) {
 
+#define ERROR_INFO_SLAB_LENGTH  20
+    scpi_error_info_slab_t slab;
+    char error_info_slab[ERROR_INFO_SLAB_LENGTH];
+
+    scpislab_init(&slab, error_info_slab, ERROR_INFO_SLAB_LENGTH, 3);
+    CU_ASSERT_EQUAL(slab.count, 3);
+    CU_ASSERT_EQUAL(slab.slot_size, 6);
+    CU_ASSERT_EQUAL(slab.used, 0);
+
+    char * ptr1 = scpislab_strndup(&slab, "abcd", 4);
+    CU_ASSERT_STRING_EQUAL(ptr1, "abcd");
+    CU_ASSERT_EQUAL(ptr1, &error_info_slab[0]);
+
+    char * ptr2 = scpislab_strndup(&slab, "ghijklmnop", 10);
+    CU_ASSERT_STRING_EQUAL(ptr2, "ghijk");
+    CU_ASSERT_EQUAL(ptr2, &error_info_slab[6]);
+
+    char * ptr3 = scpislab_strndup(&slab, "xyz", 2);
+    CU_ASSERT_STRING_EQUAL(ptr3, "xy");
+
+    CU_ASSERT_EQUAL(scpislab_strndup(&slab, "full", 4), NULL);
+    CU_ASSERT_EQUAL(scpislab_strndup(&slab, "", 4), NULL);
+    CU_ASSERT_EQUAL(slab.used, 3);
+
+    /* any order of free */
+    scpislab_free(&slab, ptr2);
+    scpislab_free(&slab, NULL);
+    scpislab_free(&slab, ptr1 + 1);
+    CU_ASSERT_EQUAL(slab.used, 2);
+
+    char * ptr4 = scpislab_strndup(&slab, "123", 3);
+    CU_ASSERT_EQUAL(ptr4, ptr2);
+    CU_ASSERT_STRING_EQUAL(ptr4, "123");
+
+    scpislab_free(&slab, ptr1);
+    scpislab_free(&slab, ptr3);
+    scpislab_free(&slab, ptr4);
+    CU_ASSERT_EQUAL(slab.used, 0);
+    CU_ASSERT_EQUAL(slab.peak, 3);
+
+    scpislab_init(&slab, error_info_slab, 4, 3);
+    CU_ASSERT_EQUAL(slab.count, 0);
+    CU_ASSERT_EQUAL(scpislab_strndup(&slab, "abcd", 4), NULL);
 }
 #endif
 
@@ -846,14 +1322,20 @@ int main() {
             || (NULL == CU_add_test(pSuite, "UInt32ToStrBase", test_UInt32ToStrBase))
             || (NULL == CU_add_test(pSuite, "Int64ToStr", test_Int64ToStr))
             || (NULL == CU_add_test(pSuite, "UInt64ToStrBase", test_UInt64ToStrBase))
+            || (NULL == CU_add_test(pSuite, "UIntToStrBaseDigits", test_UIntToStrBaseDigits))
             || (NULL == CU_add_test(pSuite, "SCPI_dtostre", test_scpi_dtostre))
             || (NULL == CU_add_test(pSuite, "floatToStr", test_floatToStr))
             || (NULL == CU_add_test(pSuite, "doubleToStr", test_doubleToStr))
+            || (NULL == CU_add_test(pSuite, "floatToStrRoundTrip", test_floatToStrRoundTrip))
+            || (NULL == CU_add_test(pSuite, "doubleToStrRoundTrip", test_doubleToStrRoundTrip))
+            || (NULL == CU_add_test(pSuite, "doubleToStrPrecision", test_doubleToStrPrecision))
             || (NULL == CU_add_test(pSuite, "strBaseToInt32", test_strBaseToInt32))
             || (NULL == CU_add_test(pSuite, "strBaseToUInt32", test_strBaseToUInt32))
             || (NULL == CU_add_test(pSuite, "strBaseToInt64", test_strBaseToInt64))
             || (NULL == CU_add_test(pSuite, "strBaseToUInt64", test_strBaseToUInt64))
+            || (NULL == CU_add_test(pSuite, "strBaseToIntOverflow", test_strBaseToIntOverflow))
             || (NULL == CU_add_test(pSuite, "strToDouble", test_strToDouble))
+            || (NULL == CU_add_test(pSuite, "strToDouble differential", test_strToDoubleDifferential))
             || (NULL == CU_add_test(pSuite, "compareStr", test_compareStr))
             || (NULL == CU_add_test(pSuite, "compareStrAndNum", test_compareStrAndNum))
             || (NULL == CU_add_test(pSuite, "matchPattern", test_matchPattern))
@@ -862,6 +1344,7 @@ int main() {
             || (NULL == CU_add_test(pSuite, "swap", test_swap))
 #if USE_DEVICE_DEPENDENT_ERROR_INFORMATION && !USE_MEMORY_ALLOCATION_FREE
             || (NULL == CU_add_test(pSuite, "heap", test_heap))
+            || (NULL == CU_add_test(pSuite, "slab", test_slab))
 #endif
             ) {
         CU_cleanup_registry();